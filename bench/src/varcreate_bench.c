@@ -0,0 +1,729 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @defgroup varcreate_bench varcreate_bench
+ * @brief Benchmark for the libvarcreate parse and creation paths
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varcreate_bench.c
+
+    Variable Creation Benchmark
+
+    The varcreate_bench utility measures the cost of libvarcreate itself,
+    without the variable server.  It generates a synthetic varcreate
+    JSON configuration with the requested size and attribute mix, then
+    times parsing the configuration on its own, and parsing and creating
+    the variables through VARCREATE_CreateFromString against the
+    in-process variable server stub.
+
+    Options include:
+
+    -n : number of variables to generate (default 10000)
+
+    -r : number of timed iterations (default 5)
+
+    -a : number of aliases per variable (default 1)
+
+    -s : percentage of string variables (default 25)
+
+    -t : number of tags per variable (default 3)
+
+    -g : number of read and write permission groups (default 2)
+
+    -b : create variables in batches of the specified size
+
+    -S : scan the configuration incrementally
+
+    -D : defer the aliases until all of the variables have been created
+
+    -c : load through a VARCREATE_CONTEXT which is reused across iterations
+
+    -o : write the generated configuration to the specified file and exit
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "cJSON.h"
+#include "vararena.h"
+#include "varserver_stub.h"
+
+/*==============================================================================
+        Private types
+==============================================================================*/
+
+/*! state of the benchmark */
+typedef struct _State
+{
+    /*! number of variables to generate */
+    size_t count;
+
+    /*! number of timed iterations */
+    size_t iterations;
+
+    /*! number of aliases per variable */
+    size_t aliases;
+
+    /*! percentage of string variables */
+    size_t strings;
+
+    /*! number of tags per variable */
+    size_t tags;
+
+    /*! number of read and write permission groups */
+    size_t groups;
+
+    /*! load through a reusable context */
+    bool context;
+
+    /*! name of the file to write the configuration to */
+    char *output;
+
+    /*! variable creation options */
+    VarCreateOptions options;
+
+} State;
+
+/*! growable text buffer */
+typedef struct _Buffer
+{
+    /*! pointer to the NUL terminated text */
+    char *data;
+
+    /*! length of the text */
+    size_t len;
+
+    /*! size of the allocated buffer */
+    size_t size;
+
+} Buffer;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int ProcessOptions( int argc, char *argv[], State *pState );
+static int Generate( State *pState, Buffer *pBuffer );
+static int Append( Buffer *pBuffer, const char *fmt, ... )
+    __attribute__ ((format (printf, 2, 3)));
+static int WriteConfig( char *filename, Buffer *pBuffer );
+static uint64_t Now( void );
+static uint64_t TimeParse( State *pState, Buffer *pBuffer );
+static uint64_t TimeCreate( State *pState,
+                            Buffer *pBuffer,
+                            VARSERVER_HANDLE hVarServer,
+                            StubCounters *pCounters );
+
+/*==============================================================================
+        Public function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  main                                                                      */
+/*!
+    Main entry point for the benchmark
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @retval 0 - the benchmark completed
+    @retval 1 - the benchmark failed
+
+==============================================================================*/
+int main( int argc, char **argv )
+{
+    State state;
+    Buffer buffer = { NULL, 0, 0 };
+    VARSERVER_HANDLE hVarServer;
+    StubCounters counters;
+    struct rusage usage;
+    uint64_t parse;
+    uint64_t create;
+    double n;
+    int rc = 1;
+
+    if ( ( ProcessOptions( argc, argv, &state ) == EOK ) &&
+         ( Generate( &state, &buffer ) == EOK ) )
+    {
+        if ( state.output != NULL )
+        {
+            rc = ( WriteConfig( state.output, &buffer ) == EOK ) ? 0 : 1;
+        }
+        else
+        {
+            hVarServer = VARSERVER_Open();
+
+            parse = TimeParse( &state, &buffer );
+            create = TimeCreate( &state, &buffer, hVarServer, &counters );
+
+            VARSERVER_Close( hVarServer );
+
+            if ( ( parse > 0 ) && ( create > 0 ) )
+            {
+                n = (double)state.count;
+                getrusage( RUSAGE_SELF, &usage );
+
+                printf( "varcreate_bench: %zu variables, %zu iterations, "
+                        "%zu aliases/var, %zu%% strings\n",
+                        state.count,
+                        state.iterations,
+                        state.aliases,
+                        state.strings );
+                printf( "  config size       : %zu bytes\n", buffer.len );
+                printf( "  parse             : %.1f ns/var\n", parse / n );
+                printf( "  parse + create    : %.1f ns/var "
+                        "(%.0f vars/sec)\n",
+                        create / n,
+                        n * 1e9 / create );
+                printf( "  handlers + create : %.1f ns/var\n",
+                        ( create > parse ) ? ( create - parse ) / n : 0.0 );
+                printf( "  allocations       : %.2f per var\n",
+                        counters.allocations / n );
+                printf( "  server calls      : %zu creates, %zu aliases\n",
+                        counters.creates,
+                        counters.aliases );
+                printf( "  peak RSS          : %ld KiB\n", usage.ru_maxrss );
+
+                rc = ( counters.creates == state.count ) ? 0 : 1;
+            }
+        }
+    }
+
+    free( buffer.data );
+
+    return rc;
+}
+
+/*============================================================================*/
+/*  ProcessOptions                                                            */
+/*!
+    Process the command line options for the benchmark
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @param[in]
+        pState
+            pointer to the benchmark state structure to update
+
+    @retval EOK - the options were processed
+    @retval EINVAL - invalid arguments
+
+==============================================================================*/
+static int ProcessOptions( int argc, char *argv[], State *pState )
+{
+    int result = EOK;
+    int c;
+
+    memset( pState, 0, sizeof( State ) );
+    pState->count = 10000;
+    pState->iterations = 5;
+    pState->aliases = 1;
+    pState->strings = 25;
+    pState->tags = 3;
+    pState->groups = 2;
+
+    while( ( c = getopt( argc, argv, "n:r:a:s:t:g:b:SDco:" ) ) != -1 )
+    {
+        switch( c )
+        {
+            case 'n':
+                pState->count = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'r':
+                pState->iterations = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'a':
+                pState->aliases = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 's':
+                pState->strings = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 't':
+                pState->tags = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'g':
+                pState->groups = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'b':
+                pState->options.batchSize = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'S':
+                pState->options.stream = true;
+                break;
+
+            case 'D':
+                pState->options.deferAliases = true;
+                break;
+
+            case 'c':
+                pState->context = true;
+                break;
+
+            case 'o':
+                pState->output = optarg;
+                break;
+
+            default:
+                result = EINVAL;
+                break;
+        }
+    }
+
+    if ( ( pState->count == 0 ) ||
+         ( pState->iterations == 0 ) ||
+         ( pState->strings > 100 ) )
+    {
+        fprintf( stderr, "varcreate_bench: invalid arguments\n" );
+        result = EINVAL;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Generate                                                                  */
+/*!
+    Generate a synthetic varcreate JSON configuration
+
+    Every variable has a name, GUID, type, format specifier, flags,
+    short name and description, plus the requested number of tags,
+    permission groups and aliases.  String variables have a length and
+    an initial string value, and the remaining variables cycle through
+    the numeric types with an initial numeric value.
+
+    @param[in]
+        pState
+            pointer to the benchmark state
+
+    @param[out]
+        pBuffer
+            pointer to the buffer to store the configuration in
+
+    @retval EOK - the configuration was generated
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int Generate( State *pState, Buffer *pBuffer )
+{
+    static const char *types[] = { "uint16", "int32", "uint64", "float" };
+    int result;
+    size_t i;
+    size_t j;
+    bool str;
+
+    result = Append( pBuffer,
+                     "{\n\t\"type\":\"vars\",\n\t\"version\":\"1.0\",\n"
+                     "\t\"description\":\"varcreate_bench\",\n"
+                     "\t\"vars\":\n\t[\n" );
+
+    for ( i = 0 ; ( result == EOK ) && ( i < pState->count ) ; i++ )
+    {
+        str = ( i % 100 ) < pState->strings;
+
+        result |= Append( pBuffer,
+                          "\t\t{\n\t\t\t\"name\":\"/BENCH/GROUP%zu/VAR%zu\",\n"
+                          "\t\t\t\"guid\":\"0x%zx\",\n",
+                          i / 100,
+                          i,
+                          0x100000 + i );
+
+        if ( str )
+        {
+            result |= Append( pBuffer,
+                              "\t\t\t\"type\":\"str\",\n"
+                              "\t\t\t\"length\":\"64\",\n"
+                              "\t\t\t\"fmt\":\"%%-20s\",\n"
+                              "\t\t\t\"value\":\"value of variable %zu\",\n",
+                              i );
+        }
+        else
+        {
+            result |= Append( pBuffer,
+                              "\t\t\t\"type\":\"%s\",\n"
+                              "\t\t\t\"fmt\":\"%%d\",\n"
+                              "\t\t\t\"value\":\"%zu\",\n",
+                              types[i % 4],
+                              i % 1000 );
+        }
+
+        result |= Append( pBuffer, "\t\t\t\"tags\":\"" );
+        for ( j = 0 ; j < pState->tags ; j++ )
+        {
+            result |= Append( pBuffer,
+                              "%stag%zu",
+                              ( j > 0 ) ? "," : "",
+                              ( i + j ) % 16 );
+        }
+
+        result |= Append( pBuffer,
+                          "\",\n\t\t\t\"flags\":\"volatile\",\n"
+                          "\t\t\t\"shortname\":\"Var%zu\",\n"
+                          "\t\t\t\"description\":\"Benchmark variable %zu\"",
+                          i,
+                          i );
+
+        if ( pState->groups > 0 )
+        {
+            result |= Append( pBuffer, ",\n\t\t\t\"read\":\"" );
+            for ( j = 0 ; j < pState->groups ; j++ )
+            {
+                result |= Append( pBuffer, "%s%zu", j ? "," : "", 1000 + j );
+            }
+
+            result |= Append( pBuffer, "\",\n\t\t\t\"write\":\"1000\"" );
+        }
+
+        if ( pState->aliases == 1 )
+        {
+            result |= Append( pBuffer, ",\n\t\t\t\"alias\":\"var%zu\"", i );
+        }
+        else if ( pState->aliases > 1 )
+        {
+            result |= Append( pBuffer, ",\n\t\t\t\"alias\":[" );
+            for ( j = 0 ; j < pState->aliases ; j++ )
+            {
+                result |= Append( pBuffer,
+                                  "%s\"var%zu.%zu\"",
+                                  j ? "," : "",
+                                  i,
+                                  j );
+            }
+
+            result |= Append( pBuffer, "]" );
+        }
+
+        result |= Append( pBuffer,
+                          "\n\t\t}%s\n",
+                          ( i + 1 < pState->count ) ? "," : "" );
+    }
+
+    result |= Append( pBuffer, "\t]\n}\n" );
+
+    return ( result == EOK ) ? EOK : ENOMEM;
+}
+
+/*============================================================================*/
+/*  Append                                                                    */
+/*!
+    Append formatted text to a buffer
+
+    @param[in]
+        pBuffer
+            pointer to the buffer
+
+    @param[in]
+        fmt
+            printf style format string
+
+    @retval EOK - the text was appended
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int Append( Buffer *pBuffer, const char *fmt, ... )
+{
+    int result = EOK;
+    va_list args;
+    size_t size;
+    char *p;
+    int n;
+
+    va_start( args, fmt );
+    n = vsnprintf( NULL, 0, fmt, args );
+    va_end( args );
+
+    if ( pBuffer->len + n + 1 > pBuffer->size )
+    {
+        size = ( pBuffer->size == 0 ) ? 64 * 1024 : pBuffer->size;
+        while ( size < pBuffer->len + n + 1 )
+        {
+            size *= 2;
+        }
+
+        p = realloc( pBuffer->data, size );
+        if ( p != NULL )
+        {
+            pBuffer->data = p;
+            pBuffer->size = size;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    if ( result == EOK )
+    {
+        va_start( args, fmt );
+        vsnprintf( &pBuffer->data[pBuffer->len], n + 1, fmt, args );
+        va_end( args );
+        pBuffer->len += n;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  WriteConfig                                                               */
+/*!
+    Write the generated configuration to a file
+
+    @param[in]
+        filename
+            name of the file to write
+
+    @param[in]
+        pBuffer
+            pointer to the buffer holding the configuration
+
+    @retval EOK - the file was written
+    @retval EIO - the file could not be written
+
+==============================================================================*/
+static int WriteConfig( char *filename, Buffer *pBuffer )
+{
+    int result = EIO;
+    FILE *fp;
+
+    fp = fopen( filename, "w" );
+    if ( fp != NULL )
+    {
+        if ( fwrite( pBuffer->data, 1, pBuffer->len, fp ) == pBuffer->len )
+        {
+            result = EOK;
+        }
+
+        if ( fclose( fp ) != 0 )
+        {
+            result = EIO;
+        }
+    }
+
+    if ( result != EOK )
+    {
+        fprintf( stderr, "varcreate_bench: unable to write %s\n", filename );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Now                                                                       */
+/*!
+    Get the monotonic clock time
+
+    @retval the current monotonic time in nanoseconds
+
+==============================================================================*/
+static uint64_t Now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*============================================================================*/
+/*  TimeParse                                                                 */
+/*!
+    Time parsing the configuration without creating any variables
+
+    The configuration is parsed into a parse arena, as the library does,
+    so the difference from TimeCreate is the cost of the attribute
+    handlers and the variable creation path.
+
+    @param[in]
+        pState
+            pointer to the benchmark state
+
+    @param[in]
+        pBuffer
+            pointer to the buffer holding the configuration
+
+    @retval the fastest iteration in nanoseconds
+    @retval 0 if the configuration could not be parsed
+
+==============================================================================*/
+static uint64_t TimeParse( State *pState, Buffer *pBuffer )
+{
+    uint64_t best = 0;
+    uint64_t start;
+    uint64_t elapsed;
+    VarArena arena;
+    VarArena *pPrevious;
+    cJSON *vardata;
+    size_t i;
+
+    vararena_Init( &arena );
+
+    for ( i = 0 ; i < pState->iterations ; i++ )
+    {
+        start = Now();
+
+        pPrevious = vararena_Select( &arena );
+        vardata = cJSON_ParseWithLength( pBuffer->data, pBuffer->len );
+        vararena_Select( pPrevious );
+        vararena_Reset( &arena );
+
+        elapsed = Now() - start;
+
+        if ( vardata == NULL )
+        {
+            fprintf( stderr, "varcreate_bench: parse failed\n" );
+            best = 0;
+            break;
+        }
+
+        if ( ( best == 0 ) || ( elapsed < best ) )
+        {
+            best = elapsed;
+        }
+    }
+
+    vararena_Free( &arena );
+
+    return best;
+}
+
+/*============================================================================*/
+/*  TimeCreate                                                                */
+/*!
+    Time parsing the configuration and creating the variables
+
+    @param[in]
+        pState
+            pointer to the benchmark state
+
+    @param[in]
+        pBuffer
+            pointer to the buffer holding the configuration
+
+    @param[in]
+        hVarServer
+            handle to the variable server stub
+
+    @param[out]
+        pCounters
+            pointer to a location to store the calls recorded during
+            the last iteration
+
+    @retval the fastest iteration in nanoseconds
+    @retval 0 if the variables could not be created
+
+==============================================================================*/
+static uint64_t TimeCreate( State *pState,
+                            Buffer *pBuffer,
+                            VARSERVER_HANDLE hVarServer,
+                            StubCounters *pCounters )
+{
+    uint64_t best = 0;
+    uint64_t start;
+    uint64_t elapsed;
+    VARCREATE_CONTEXT ctx = NULL;
+    size_t i;
+    int rc;
+
+    if ( pState->context == true )
+    {
+        ctx = VARCREATE_ContextCreate( hVarServer, &pState->options );
+    }
+
+    for ( i = 0 ; i < pState->iterations ; i++ )
+    {
+        STUB_Reset();
+        start = Now();
+
+        if ( ctx != NULL )
+        {
+            rc = VARCREATE_ContextLoad( ctx, pBuffer->data );
+        }
+        else
+        {
+            rc = VARCREATE_CreateFromString( hVarServer,
+                                             pBuffer->data,
+                                             &pState->options );
+        }
+
+        elapsed = Now() - start;
+        STUB_GetCounters( pCounters );
+
+        if ( rc != EOK )
+        {
+            fprintf( stderr, "varcreate_bench: create failed (%d)\n", rc );
+            best = 0;
+            break;
+        }
+
+        if ( ( best == 0 ) || ( elapsed < best ) )
+        {
+            best = elapsed;
+        }
+    }
+
+    VARCREATE_ContextDestroy( ctx );
+
+    return best;
+}
+
+/*! @}
+ * end of varcreate_bench group */
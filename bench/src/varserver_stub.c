@@ -0,0 +1,211 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup varcreate_bench
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varserver_stub.c
+
+    Variable Server Stub
+
+    The benchmark is linked with --wrap for the variable server requests
+    which libvarcreate makes, so they are served by this in-process stub
+    instead of by a running variable server.  The stub records each call
+    and assigns sequential variable handles.  The pure helper functions
+    such as VARSERVER_TypeNameToType and VAROBJECT_CreateFromString are
+    not wrapped, so their real cost is included in the measurements.
+
+    Heap allocations made through malloc, calloc and realloc by the
+    library and by cJSON are also counted here.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varserver_stub.h"
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+void *__real_malloc( size_t size );
+void *__real_calloc( size_t nmemb, size_t size );
+void *__real_realloc( void *ptr, size_t size );
+
+VARSERVER_HANDLE __wrap_VARSERVER_Open( void );
+int __wrap_VARSERVER_Close( VARSERVER_HANDLE hVarServer );
+int __wrap_VARSERVER_CreateVar( VARSERVER_HANDLE hVarServer,
+                                VarInfo *pVarInfo );
+int __wrap_VAR_Alias( VARSERVER_HANDLE hVarServer,
+                      VAR_HANDLE hVar,
+                      char *alias,
+                      VAR_HANDLE *phAlias );
+VAR_HANDLE __wrap_VAR_FindByName( VARSERVER_HANDLE hVarServer, char *name );
+void *__wrap_malloc( size_t size );
+void *__wrap_calloc( size_t nmemb, size_t size );
+void *__wrap_realloc( void *ptr, size_t size );
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! calls recorded since the last reset */
+static StubCounters counters;
+
+/*! dummy object whose address is used as the server handle */
+static int server;
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  STUB_Reset                                                                */
+/*!
+    Clear the recorded calls
+
+==============================================================================*/
+void STUB_Reset( void )
+{
+    __atomic_store_n( &counters.creates, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &counters.aliases, 0, __ATOMIC_RELAXED );
+    __atomic_store_n( &counters.allocations, 0, __ATOMIC_RELAXED );
+}
+
+/*============================================================================*/
+/*  STUB_GetCounters                                                          */
+/*!
+    Get the calls recorded since the last reset
+
+    @param[out]
+        pCounters
+            pointer to the location to store the counters
+
+==============================================================================*/
+void STUB_GetCounters( StubCounters *pCounters )
+{
+    pCounters->creates = __atomic_load_n( &counters.creates,
+                                          __ATOMIC_RELAXED );
+    pCounters->aliases = __atomic_load_n( &counters.aliases,
+                                          __ATOMIC_RELAXED );
+    pCounters->allocations = __atomic_load_n( &counters.allocations,
+                                              __ATOMIC_RELAXED );
+}
+
+VARSERVER_HANDLE __wrap_VARSERVER_Open( void )
+{
+    return (VARSERVER_HANDLE)&server;
+}
+
+int __wrap_VARSERVER_Close( VARSERVER_HANDLE hVarServer )
+{
+    (void)hVarServer;
+
+    return EOK;
+}
+
+int __wrap_VARSERVER_CreateVar( VARSERVER_HANDLE hVarServer,
+                                VarInfo *pVarInfo )
+{
+    int result = EINVAL;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pVarInfo != NULL ) )
+    {
+        pVarInfo->hVar = (VAR_HANDLE)__atomic_add_fetch( &counters.creates,
+                                                         1,
+                                                         __ATOMIC_RELAXED );
+        result = EOK;
+    }
+
+    return result;
+}
+
+int __wrap_VAR_Alias( VARSERVER_HANDLE hVarServer,
+                      VAR_HANDLE hVar,
+                      char *alias,
+                      VAR_HANDLE *phAlias )
+{
+    int result = EINVAL;
+
+    if ( ( hVarServer != NULL ) &&
+         ( hVar != VAR_INVALID ) &&
+         ( alias != NULL ) )
+    {
+        __atomic_add_fetch( &counters.aliases, 1, __ATOMIC_RELAXED );
+        if ( phAlias != NULL )
+        {
+            *phAlias = hVar;
+        }
+
+        result = EOK;
+    }
+
+    return result;
+}
+
+VAR_HANDLE __wrap_VAR_FindByName( VARSERVER_HANDLE hVarServer, char *name )
+{
+    (void)hVarServer;
+    (void)name;
+
+    /* the stub does not keep the variables it has created */
+    return VAR_INVALID;
+}
+
+void *__wrap_malloc( size_t size )
+{
+    __atomic_add_fetch( &counters.allocations, 1, __ATOMIC_RELAXED );
+
+    return __real_malloc( size );
+}
+
+void *__wrap_calloc( size_t nmemb, size_t size )
+{
+    __atomic_add_fetch( &counters.allocations, 1, __ATOMIC_RELAXED );
+
+    return __real_calloc( nmemb, size );
+}
+
+void *__wrap_realloc( void *ptr, size_t size )
+{
+    __atomic_add_fetch( &counters.allocations, 1, __ATOMIC_RELAXED );
+
+    return __real_realloc( ptr, size );
+}
+
+/*! @}
+ * end of varcreate_bench group */
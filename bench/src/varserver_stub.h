@@ -0,0 +1,60 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARSERVER_STUB_H
+#define VARSERVER_STUB_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stddef.h>
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! calls recorded by the variable server stub */
+typedef struct _StubCounters
+{
+    /*! number of VARSERVER_CreateVar calls */
+    size_t creates;
+
+    /*! number of VAR_Alias calls */
+    size_t aliases;
+
+    /*! number of heap allocations made by the library and cJSON */
+    size_t allocations;
+
+} StubCounters;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+void STUB_Reset( void );
+
+void STUB_GetCounters( StubCounters *pCounters );
+
+#endif
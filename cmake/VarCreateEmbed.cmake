@@ -0,0 +1,47 @@
+# varcreate_embed( <target> <config> [SYMBOL <name>] )
+#
+# Compile a varcreate JSON config file into a C source file which is
+# added to the target.  The source file defines a constant
+# VarCreateTable object, named after the config file unless SYMBOL is
+# given, which the target passes to VARCREATE_CreateFromTable:
+#
+#   extern const VarCreateTable vars;
+#   VARCREATE_CreateFromTable( hVarServer, &vars, &options );
+#
+# The source file is generated again whenever the config file changes.
+
+function( varcreate_embed target config )
+	cmake_parse_arguments( EMBED "" "SYMBOL" "" ${ARGN} )
+
+	get_filename_component( config ${config} ABSOLUTE )
+
+	if( NOT EMBED_SYMBOL )
+		get_filename_component( EMBED_SYMBOL ${config} NAME_WE )
+		string( MAKE_C_IDENTIFIER ${EMBED_SYMBOL} EMBED_SYMBOL )
+	endif()
+
+	if( TARGET varcreate-bin )
+		set( generator varcreate-bin )
+	else()
+		find_program( VARCREATE_EXECUTABLE varcreate )
+		if( NOT VARCREATE_EXECUTABLE )
+			message( FATAL_ERROR "varcreate_embed requires the varcreate utility" )
+		endif()
+		set( generator ${VARCREATE_EXECUTABLE} )
+	endif()
+
+	set( source ${CMAKE_CURRENT_BINARY_DIR}/${EMBED_SYMBOL}_table.c )
+
+	add_custom_command(
+		OUTPUT ${source}
+		COMMAND ${generator}
+			--embed ${config}
+			--symbol ${EMBED_SYMBOL}
+			-o ${source}
+		DEPENDS ${config} ${generator}
+		COMMENT "Embedding variable table ${EMBED_SYMBOL} from ${config}"
+		VERBATIM
+	)
+
+	target_sources( ${target} PRIVATE ${source} )
+endfunction()
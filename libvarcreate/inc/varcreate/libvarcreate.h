@@ -42,10 +42,123 @@ SOFTWARE.
 #define EOK 0
 #endif
 
+/*! default number of variables to submit to the variable server per batch */
+#define VARCREATE_DEFAULT_BATCH_SIZE    ( 64 )
+
 /*============================================================================
         Public Types
 ============================================================================*/
 
+/*! The VarCreateStats object reports where the time of variable
+    creation was spent.  Times are measured with the monotonic clock
+    and are in nanoseconds */
+typedef struct _VarCreateStats
+{
+    /*! time spent reading or mapping the config files */
+    uint64_t readTime;
+
+    /*! time spent parsing the JSON */
+    uint64_t parseTime;
+
+    /*! time spent applying the attribute handlers */
+    uint64_t handlerTime;
+
+    /*! time spent creating variables on the variable server */
+    uint64_t createTime;
+
+    /*! time spent creating aliases on the variable server */
+    uint64_t aliasTime;
+
+    /*! total time spent loading the config files */
+    uint64_t totalTime;
+
+    /*! number of config files or strings loaded */
+    size_t files;
+
+    /*! number of unchanged config files skipped using the load cache */
+    size_t skipped;
+
+    /*! number of variables created */
+    size_t created;
+
+    /*! number of variables which could not be created */
+    size_t failed;
+
+    /*! number of aliases created */
+    size_t aliased;
+
+    /*! number of variables and aliases left unchanged by a reconciling
+        load because they already existed */
+    size_t existing;
+
+    /*! number of variables left as they were by a reconciling load
+        because they already existed, although their type or string
+        length differs from the config */
+    size_t changed;
+
+    /*! number of variables which already existed, and whose flags were
+        brought up to date with the config by a reconciling load */
+    size_t updated;
+
+    /*! number of bytes of JSON config data loaded */
+    size_t bytes;
+
+} VarCreateStats;
+
+/*! an alias to be created for a variable */
+typedef struct _VarCreateAlias
+{
+    /*! handle of the variable to be aliased */
+    VAR_HANDLE hVar;
+
+    /*! NUL terminated name of the alias */
+    char *name;
+
+} VarCreateAlias;
+
+/*! a variable, attribute or alias which could not be created, or a
+    variable definition which could not be parsed */
+typedef struct _VarCreateResult
+{
+    /*! name of the config file, or NULL for a string or a stream */
+    const char *filename;
+
+    /*! index of the variable definition in the input.  The variables
+        of a template all have the index of the template */
+    size_t index;
+
+    /*! name of the variable, or of the alias for a deferred alias, or
+        NULL if the definition could not be parsed */
+    const char *name;
+
+    /*! name of the attribute which could not be applied, or NULL if the
+        variable server rejected the variable or the definition could
+        not be parsed */
+    const char *attribute;
+
+    /*! error number describing the failure */
+    int result;
+
+} VarCreateResult;
+
+/*! a list of the paths of config files */
+typedef struct _VarCreateFileList
+{
+    /*! array of NUL terminated file paths */
+    char **files;
+
+    /*! number of files in the list */
+    size_t count;
+
+    /*! number of files the list can hold before it must grow */
+    size_t size;
+
+} VarCreateFileList;
+
+/*! opaque handle to an index of the names and handles of the created
+    variables, which clients can search without asking the variable server */
+typedef struct _VarCreateIndex *VARCREATE_INDEX;
+
 /*! The VarCreateOptions object is used to customize the
     variable creation */
 typedef struct _VarCreateOptions
@@ -56,14 +169,158 @@ typedef struct _VarCreateOptions
     /*! instance identifier to use for every variable in the file */
     uint32_t instanceID;
 
+    /*! array of instance identifiers to create every variable for,
+        instead of instanceID, or NULL.  The config files are parsed
+        once and the resolved variables are created for each instance
+        in turn.  Only used by VARCREATE_CreateFromFile,
+        VARCREATE_CreateFromDirectory and VARCREATE_CreateFromSnapshot */
+    uint32_t *instances;
+
+    /*! number of instance identifiers in the instances array */
+    size_t instanceCount;
+
     /*! flags to apply to every variable in the file. */
     uint32_t flags;
 
     /*! enable verbose logging */
     bool verbose;
 
+    /*! do not write any progress or error messages.  Otherwise the
+        messages are collected and written to the standard output
+        together at the end of each input */
+    bool quiet;
+
+    /*! function called with each variable, attribute or alias which
+        could not be created, or NULL.  The strings of the record only
+        remain valid during the call.  The function may be called from
+        the threads of the library, but never from two threads at once */
+    void (*report)( void *arg, const VarCreateResult *pResult );
+
+    /*! argument passed to the report function */
+    void *reportArg;
+
+    /*! number of variables to gather before submitting them to the
+        variable server.  Set to 0 or 1 to create each variable as
+        soon as it is parsed */
+    size_t batchSize;
+
+    /*! scan the input incrementally and create each variable as soon
+        as its definition has been parsed, instead of parsing the entire
+        input first.  Files too large to parse in one piece are always
+        scanned incrementally */
+    bool stream;
+
+    /*! map config files into memory and parse them in place instead
+        of reading them into a heap buffer */
+    bool mapFile;
+
+    /*! number of worker threads used to create variables from the files
+        in a directory.  Each worker has its own connection to the
+        variable server.  Set to 0 or 1 to process the files in turn */
+    size_t workers;
+
+    /*! also create variables from the files in the subdirectories of
+        a directory */
+    bool recursive;
+
+    /*! create the variables on a separate thread, so the input is
+        parsed while the variable server is creating the variables
+        which have already been parsed.  Variables are still created,
+        and their failures reported, in input order */
+    bool pipeline;
+
+    /*! number of parsed variables which can be waiting to be created
+        when the pipeline option is set.  Set to 0 for the default */
+    size_t pipelineDepth;
+
+    /*! name of a state file which records the files which have been
+        loaded, so files which are unchanged since they were last loaded
+        into the same variable server are skipped.  Set to NULL to load
+        every file */
+    char *cache;
+
+    /*! collect the aliases of the variables and create them together
+        once every variable of the load has been created, instead of
+        creating the aliases of each variable as soon as it exists.
+        A directory is loaded completely before any of its aliases are
+        created.  Deferred aliases are not included in the statistics
+        passed to the fileStats function */
+    bool deferAliases;
+
+    /*! create the variables whose "priority" attribute is "critical"
+        from every input of the load before any of the other variables,
+        and call the ready function in between.  A file makes all of
+        its variables critical with a "priority" in its "defaults".
+        A context applies the priority to each load on its own.
+        Snapshots, tables and loads with instances do not record the
+        priority of their variables, and a stream can only be read once,
+        so they create every variable and then call the ready function */
+    bool priority;
+
+    /*! function called once every critical variable has been created
+        and before any other variable is created, or NULL.  Only called
+        if the priority option is set */
+    void (*ready)( void *arg );
+
+    /*! argument passed to the ready function */
+    void *readyArg;
+
+    /*! check the config files of VARCREATE_CreateFromFile and
+        VARCREATE_CreateFromDirectory for duplicate names and GUIDs with
+        VARCREATE_CheckFiles before creating any variables, and create
+        nothing if there are any */
+    bool preflight;
+
+    /*! look up each variable and alias by name before creating it, and
+        leave the ones which already exist instead of failing, so a
+        changed config can be loaded again to create only what it adds.
+        The flags of the existing variables are updated */
+    bool reconcile;
+
+    /*! index which the name and handle of every variable and alias
+        created by the load are added to, or NULL.  Variables in files
+        skipped by the cache are not added */
+    VARCREATE_INDEX index;
+
+    /*! pointer to statistics which are accumulated across every load
+        made with these options, or NULL to disable the statistics.
+        The caller clears the statistics before the first load */
+    VarCreateStats *stats;
+
+    /*! function called with the statistics of each file once it has
+        been loaded, or NULL.  The filename is NULL for a string or a stream.
+        Only called if stats is not NULL */
+    void (*fileStats)( const char *filename, const VarCreateStats *stats );
+
 } VarCreateOptions;
 
+/*! a config file compiled into a program by VARCREATE_CompileTable,
+    usually through the varcreate_embed CMake function */
+typedef struct _VarCreateTable
+{
+    /*! pointer to the resolved variable definitions, which must be
+        aligned to 8 bytes */
+    const void *image;
+
+    /*! size of the resolved variable definitions in bytes */
+    size_t len;
+
+} VarCreateTable;
+
+/*! opaque handle to a variable creation context, which keeps the parse
+    arena, variable batch and option state alive across repeated loads */
+typedef struct _VarCreateContext *VARCREATE_CONTEXT;
+
+/*! opaque handle to an asynchronous load started by
+    VARCREATE_CreateFromFileAsync */
+typedef struct _VarCreateAsync *VARCREATE_ASYNC;
+
+/*! function called on the library's worker thread when an asynchronous
+    load is complete, with the result of the load and its statistics */
+typedef void (*VarCreateDoneFn)( void *arg,
+                                 int result,
+                                 const VarCreateStats *stats );
+
 /*============================================================================
         Public Function Declarations
 ============================================================================*/
@@ -76,4 +333,81 @@ int VARCREATE_CreateFromString( VARSERVER_HANDLE hVarServer,
                                 const char *filedata,
                                 VarCreateOptions *options );
 
+int VARCREATE_CreateFromStream( VARSERVER_HANDLE hVarServer,
+                                int fd,
+                                VarCreateOptions *options );
+
+int VARCREATE_CreateFromFileAsync( char *filename,
+                                   VarCreateOptions *options,
+                                   VarCreateDoneFn fn,
+                                   void *arg,
+                                   VARCREATE_ASYNC *phAsync );
+
+int VARCREATE_Wait( VARCREATE_ASYNC hAsync, VarCreateStats *stats );
+
+int VARCREATE_CreateFromDirectory( VARSERVER_HANDLE hVarServer,
+                                   char *dirname,
+                                   VarCreateOptions *options );
+
+int VARCREATE_WatchDirectory( VARSERVER_HANDLE hVarServer,
+                              char *dirname,
+                              VarCreateOptions *options );
+
+int VARCREATE_ScanDirectory( char *dirname,
+                             bool recursive,
+                             VarCreateFileList *pList );
+
+void VARCREATE_FreeFileList( VarCreateFileList *pList );
+
+int VARCREATE_CompileSnapshot( char *filename,
+                               char *snapshot,
+                               VarCreateOptions *options );
+
+int VARCREATE_CreateFromSnapshot( VARSERVER_HANDLE hVarServer,
+                                  char *snapshot,
+                                  VarCreateOptions *options );
+
+int VARCREATE_CompileTable( char *filename,
+                            char *source,
+                            const char *symbol,
+                            VarCreateOptions *options );
+
+int VARCREATE_CreateFromTable( VARSERVER_HANDLE hVarServer,
+                               const VarCreateTable *pTable,
+                               VarCreateOptions *options );
+
+VARCREATE_CONTEXT VARCREATE_ContextCreate( VARSERVER_HANDLE hVarServer,
+                                           VarCreateOptions *options );
+
+int VARCREATE_ContextLoad( VARCREATE_CONTEXT ctx, const char *filedata );
+
+int VARCREATE_ContextLoadFile( VARCREATE_CONTEXT ctx, char *filename );
+
+void VARCREATE_ContextDestroy( VARCREATE_CONTEXT ctx );
+
+int VARCREATE_CheckFiles( VarCreateFileList *pList,
+                          VarCreateOptions *options );
+
+VARCREATE_INDEX VARCREATE_IndexCreate( void );
+
+int VARCREATE_IndexWrite( VARCREATE_INDEX hIndex, char *filename );
+
+VARCREATE_INDEX VARCREATE_IndexOpen( char *filename );
+
+VAR_HANDLE VARCREATE_IndexFind( VARCREATE_INDEX hIndex, const char *name );
+
+size_t VARCREATE_IndexCount( VARCREATE_INDEX hIndex );
+
+void VARCREATE_IndexDestroy( VARCREATE_INDEX hIndex );
+
+int VARCREATE_CreateBatch( VARSERVER_HANDLE hVarServer,
+                           VarInfo *pVarInfo,
+                           size_t n,
+                           int *results );
+
+int VARCREATE_CreateAliasBatch( VARSERVER_HANDLE hVarServer,
+                                VarCreateAlias *pAliases,
+                                size_t n,
+                                int *results );
+
 #endif
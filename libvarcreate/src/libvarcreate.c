@@ -52,25 +52,80 @@ SOFTWARE.
 #include <errno.h>
 #include <ctype.h>
 #include <string.h>
+#include <strings.h>
 #include <inttypes.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 #include <varserver/var.h>
 #include "cJSON.h"
+#include "varstream.h"
+#include "varload.h"
+#include "varsnap.h"
+#include "varcache.h"
+#include "vararena.h"
+#include "varmemo.h"
+#include "varpipe.h"
+#include "varlog.h"
+#include "varindex.h"
+#include "varcheck.h"
+#include "varprobe.h"
+#include "varzip.h"
+#include "varrecon.h"
 #include <varcreate/libvarcreate.h>
 
 /*==============================================================================
         Private definitions
 ==============================================================================*/
 
-/*! specifies the maximum allowable file size of varcreate files */
+/*! specifies the maximum size of varcreate files which are read into
+    memory and parsed in one piece.  Larger files are streamed */
 #define MAX_VARCREATE_FILE_SIZE               ( 256 * 1024 )
 
+/*! size of the blocks read from a streamed varcreate file */
+#define VARCREATE_STREAM_BLOCK_SIZE           ( 16 * 1024 )
+
+/*! placeholder replaced with the index of a template variable in
+    the names of its aliases */
+#define VARCREATE_INDEX_PLACEHOLDER           "{i}"
+
 /*==============================================================================
         Type Definitions
 ==============================================================================*/
 
+/*! identifiers for the JSON variable attributes.  The attribute handlers
+    are applied in this order, so for example the type is always known
+    before the value and length are processed */
+typedef enum _VarAttribute
+{
+    VARATTR_NAME = 0,
+    VARATTR_GUID,
+    VARATTR_TYPE,
+    VARATTR_FMT,
+    VARATTR_LENGTH,
+    VARATTR_VALUE,
+    VARATTR_TAGS,
+    VARATTR_FLAGS,
+    VARATTR_DESCRIPTION,
+    VARATTR_SHORTNAME,
+    VARATTR_READ,
+    VARATTR_WRITE,
+
+    /*! aliases are processed after the variable is created */
+    VARATTR_ALIAS,
+
+    /*! number of known attributes */
+    VARATTR_MAX,
+
+    /*! the attribute is not recognized */
+    VARATTR_UNKNOWN = VARATTR_MAX
+
+} VarAttribute;
+
 /*! handler for the JSON variable attributes */
 typedef struct _JSONHandler
 {
@@ -82,6 +137,70 @@ typedef struct _JSONHandler
 
 } JSONHandler;
 
+/*! The VarBatch object gathers parsed variable definitions so they
+    can be submitted to the variable server together */
+typedef struct _VarBatch
+{
+    /*! maximum number of variables in the batch */
+    size_t size;
+
+    /*! number of variables currently in the batch */
+    size_t count;
+
+    /*! array of variable definitions waiting to be created */
+    VarInfo *info;
+
+    /*! per-variable creation results */
+    int *results;
+
+    /*! per-variable index of the definition in the input */
+    size_t *items;
+
+    /*! per-variable 'alias' attributes to process after creation */
+    const cJSON **aliases;
+
+    /*! per-variable JSON objects owned by the batch, which are
+        deleted once the batch has been submitted */
+    cJSON **objects;
+
+} VarBatch;
+
+/*! The VarRange object describes the {first..last} index range in the
+    name of a template variable */
+typedef struct _VarRange
+{
+    /*! offset of the range specifier in the variable name */
+    size_t offset;
+
+    /*! length of the range specifier, including the braces */
+    size_t len;
+
+    /*! first index of the range */
+    uint32_t first;
+
+    /*! last index of the range */
+    uint32_t last;
+
+    /*! GUID increment from one variable of the range to the next */
+    uint32_t stride;
+
+} VarRange;
+
+/*! The VarCreateContext object holds the state of a variable load which
+    is reused across calls to VARCREATE_ContextLoad */
+struct _VarCreateContext
+{
+    /*! private copy of the variable creation options */
+    VarCreateOptions options;
+
+    /*! load state shared by every call */
+    VarLoad load;
+
+    /*! load cache, used if the cache option is set */
+    VarCache cache;
+
+};
+
 /*==============================================================================
         Private function declarations
 ==============================================================================*/
@@ -93,13 +212,136 @@ static int varcreate_fnGetFileData( char *filename,
                                     char **filedata,
                                     size_t filesize );
 
-static int varcreate_fnProcessVarData( VARSERVER_HANDLE hVarServer,
-                                       cJSON *vardata,
-                                       VarCreateOptions *options );
+static int varcreate_fnLoad( VarLoad *pLoad, char *filename );
+
+static int varcreate_fnMapFile( VarLoad *pLoad, char *filename );
+
+static int varcreate_fnCreateFromBuffer( VarLoad *pLoad,
+                                         const char *filedata,
+                                         size_t len,
+                                         bool stream );
+
+static int varcreate_fnProcessVarData( VarLoad *pLoad, cJSON *vardata );
+
+static int varcreate_fnProcessVar( VarLoad *pLoad, const cJSON *vardata );
+
+static bool varcreate_fnSkip( VarLoad *pLoad, const cJSON *vardata );
+
+static int varcreate_fnBuildName( VarLoad *pLoad,
+                                  const cJSON *vardata,
+                                  VarInfo *pVarInfo );
 
-static int varcreate_fnProcessVar( VARSERVER_HANDLE hVarServer,
-                                   const cJSON *vardata,
-                                   VarCreateOptions *options );
+static void varcreate_fnPrefix( VarLoad *pLoad, char *name );
+
+static void varcreate_fnFailed( VarLoad *pLoad,
+                                size_t index,
+                                const char *name,
+                                int result );
+
+static int varcreate_fnBuildVarInfo( VarLoad *pLoad,
+                                     const cJSON *vardata,
+                                     VarInfo *pVarInfo,
+                                     const cJSON **ppAlias );
+
+static VarAttribute varcreate_fnGetAttribute( const char *key );
+
+static int varcreate_fnApplyAttribute( VarLoad *pLoad,
+                                       VarAttribute attr,
+                                       VarInfo *pVarInfo,
+                                       cJSON *item );
+
+static int varcreate_fnCreateVar( VarLoad *pLoad,
+                                  VarInfo *pVarInfo,
+                                  const cJSON *alias );
+
+static int varcreate_fnAlias( VarLoad *pLoad,
+                              VAR_HANDLE hVar,
+                              char *name,
+                              const char *index,
+                              size_t item );
+
+static bool varcreate_fnGetRange( const cJSON *vardata,
+                                  const char *name,
+                                  VarRange *pRange );
+
+static int varcreate_fnExpand( VarLoad *pLoad,
+                               const VarInfo *pTemplate,
+                               const VarRange *pRange,
+                               const cJSON *alias );
+
+static int varcreate_fnRangeName( const char *name,
+                                  const VarRange *pRange,
+                                  uint32_t index,
+                                  char *buf );
+
+static int varcreate_fnSubstitute( const char *name,
+                                   const char *index,
+                                   char *buf );
+
+static int varcreate_fnSubmit( VarLoad *pLoad,
+                               VarInfo *pVarInfo,
+                               size_t n,
+                               int *results );
+
+static int varcreate_fnQueue( VarLoad *pLoad,
+                              VarInfo *pVarInfo,
+                              VarPipeEntry *pEntry,
+                              int result,
+                              const cJSON *alias,
+                              const char *index );
+
+static int varcreate_fnPipeCreate( void *arg,
+                                   VarInfo *info,
+                                   VarPipeEntry *entries,
+                                   int *results,
+                                   size_t n );
+
+static int varcreate_fnPipeAliases( VarLoad *pLoad,
+                                    VarInfo *pVarInfo,
+                                    const VarPipeEntry *pEntry );
+
+static int varcreate_fnBatchInit( VarBatch *pBatch, size_t size );
+
+static int varcreate_fnBatchFlush( VarLoad *pLoad );
+
+static void varcreate_fnBatchFree( VarBatch *pBatch );
+
+static int varcreate_fnStreamFile( VarLoad *pLoad, char *filename );
+
+static int varcreate_fnStreamClose( VarLoad *pLoad, VarStream *pStream );
+
+static int varcreate_fnStreamElement( void *arg,
+                                      const char *element,
+                                      size_t len );
+
+static int varcreate_fnStreamDefaults( void *arg,
+                                       const char *element,
+                                       size_t len );
+
+static cJSON *varcreate_fnParse( VarLoad *pLoad,
+                                 const char *data,
+                                 size_t len );
+
+static int varcreate_fnMalformed( VarLoad *pLoad,
+                                  const char *data,
+                                  size_t len,
+                                  int result );
+
+static void varcreate_fnDelete( VarLoad *pLoad, cJSON *item );
+
+static int varcreate_fnLoadString( VarLoad *pLoad, const char *filedata );
+
+static int varcreate_fnLoadLines( VarLoad *pLoad, int fd );
+
+static int varcreate_fnLoadLine( VarLoad *pLoad, char *line, size_t len );
+
+static uint64_t varcreate_fnClock( VarLoad *pLoad );
+
+static uint64_t varcreate_fnElapsed( VarLoad *pLoad, uint64_t start );
+
+static void varcreate_fnFileStats( VarLoad *pLoad,
+                                   const char *filename,
+                                   uint64_t start );
 
 static int varcreate_ProcessName( VARSERVER_HANDLE hVarServer,
                                   VarInfo *pVarInfo,
@@ -141,9 +383,11 @@ static int varcreate_ProcessFlags( VARSERVER_HANDLE hVarServer,
                                    VarInfo *pVarInfo,
                                    cJSON *flags );
 
-static int varcreate_ProcessAlias( VARSERVER_HANDLE hVarServer,
+static int varcreate_ProcessAlias( VarLoad *pLoad,
                                    VarInfo *pVarInfo,
-                                   cJSON *alias );
+                                   cJSON *alias,
+                                   const char *index,
+                                   size_t item );
 
 static int varcreate_ProcessDescription( VARSERVER_HANDLE hVarServer,
                                          VarInfo *pVarInfo,
@@ -153,117 +397,4419 @@ static int varcreate_ProcessShortName( VARSERVER_HANDLE hVarServer,
                                        VarInfo *pVarInfo,
                                        cJSON *shortName );
 
-/*==============================================================================
-        Function definitions
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! attribute handlers indexed by VarAttribute */
+static const JSONHandler handlers[VARATTR_ALIAS] =
+{
+    [VARATTR_NAME] = { "name", varcreate_ProcessName },
+    [VARATTR_GUID] = { "guid", varcreate_ProcessGUID },
+    [VARATTR_TYPE] = { "type", varcreate_ProcessType },
+    [VARATTR_FMT] = { "fmt", varcreate_ProcessFormat },
+    [VARATTR_LENGTH] = { "length", varcreate_ProcessLength },
+    [VARATTR_VALUE] = { "value", varcreate_ProcessValue },
+    [VARATTR_TAGS] = { "tags", varcreate_ProcessTags },
+    [VARATTR_FLAGS] = { "flags", varcreate_ProcessFlags },
+    [VARATTR_DESCRIPTION] = { "description", varcreate_ProcessDescription },
+    [VARATTR_SHORTNAME] = { "shortname", varcreate_ProcessShortName },
+    [VARATTR_READ] = { "read", varcreate_ProcessReadPermissions },
+    [VARATTR_WRITE] = { "write", varcreate_ProcessWritePermissions }
+};
+
+/*! serializes updates to statistics shared by the directory workers */
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+void __attribute__ ((constructor)) initLibrary(void) {
+ //
+ // Function that is called when the library is loaded
+ //
+ vararena_InstallHooks();
+}
+void __attribute__ ((destructor)) cleanUpLibrary(void) {
+ //
+ // Function that is called when the library is »closed«.
+ //
+ varlog_Flush();
+}
+
+/*============================================================================*/
+/*  VARCREATE_CreateFromFile                                                  */
+/*!
+    Create variables from a JSON config file
+
+    The VARCREATE_CreateFromFile function dynamically creates varserver
+    variables at run-time by parsing a JSON configuration file.
+
+    Files larger than MAX_VARCREATE_FILE_SIZE, or any file if the
+    stream option is set, are scanned incrementally so that variables
+    are created while the file is being read and only one variable
+    definition is held in memory at a time.
+
+    If the mapFile option is set, the file is mapped into memory
+    read-only and parsed in place rather than being copied into
+    a heap buffer.
+
+    If the cache option is set, the file is skipped if it has not
+    changed since it was last loaded into the same variable server.
+
+    If the priority option is set, the file is read twice.  The first
+    pass creates only the critical variables and calls the ready
+    function, and the second pass creates the rest of the variables.
+
+    If the preflight option is set, the file is checked for duplicate
+    names and GUIDs first, and no variables are created if it has any.
+
+    If the instances option is set, the file is parsed once and its
+    variables are created for each instance in turn.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval EEXIST - the preflight check found duplicate names or GUIDs
+
+==============================================================================*/
+int VARCREATE_CreateFromFile( VARSERVER_HANDLE hVarServer,
+                              char *filename,
+                              VarCreateOptions *options )
+{
+    int result = EOK;
+    VarCreateFileList list;
+    VarLoad load;
+    VarCache cache;
+    int rc;
+
+    VARPROBE_BEGIN( load, filename, 0 );
+
+    list.files = &filename;
+    list.count = 1;
+    list.size = 1;
+
+    if ( ( options != NULL ) &&
+         ( options->preflight == true ) )
+    {
+        /* reject the file before anything is created */
+        result = VARCREATE_CheckFiles( &list, options );
+    }
+
+    if ( ( result == EOK ) &&
+         ( options != NULL ) &&
+         ( options->instances != NULL ) )
+    {
+        /* parse the file once and create it for every instance */
+        result = varsnap_CreateInstances( hVarServer, &list, options );
+    }
+    else if ( result == EOK )
+    {
+        result = varcreate_fnLoadBegin( &load, hVarServer, options );
+
+        if ( ( result == EOK ) &&
+             ( options->cache != NULL ) )
+        {
+            result = varcache_Open( &cache, options->cache, options );
+            if ( result == EOK )
+            {
+                load.pCache = &cache;
+            }
+            else
+            {
+                varcreate_fnLoadEnd( &load );
+            }
+        }
+
+        if ( result == EOK )
+        {
+            if ( options->priority == true )
+            {
+                /* create the critical variables before reading the file
+                   again for the rest of its variables */
+                load.tier = VARLOAD_TIER_CRITICAL;
+                result = varcreate_fnLoadFile( &load, filename );
+
+                rc = varcreate_fnLoadReady( &load );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+
+                load.tier = VARLOAD_TIER_NORMAL;
+            }
+
+            rc = varcreate_fnLoadFile( &load, filename );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            rc = varcreate_fnLoadAliases( &load );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            varcreate_fnLoadEnd( &load );
+
+            if ( load.pCache != NULL )
+            {
+                rc = varcache_Close( load.pCache );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+            }
+        }
+    }
+
+    VARPROBE_END( load, filename, result );
+
+    return result;
+}
+
+/*==========================================================================*/
+/*  VARCREATE_CreateFromString                                              */
+/*!
+    Create variables from a string containing JSON configuration
+
+    The VARCREATE_CreateFromString function dynamically creates varserver
+    variables at run-time by parsing a JSON configuration string.
+
+    If the stream option is set, the string is scanned incrementally
+    and each variable is parsed and created in turn, rather than
+    parsing the entire string before creating any variables.
+
+    If the priority option is set, the string is parsed twice, once to
+    create the critical variables and once to create the rest of them,
+    and the ready function is called in between.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        filedata
+            string containing variable creation JSON config data
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+
+============================================================================*/
+int VARCREATE_CreateFromString( VARSERVER_HANDLE hVarServer,
+                                const char *filedata,
+                                VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarLoad load;
+    int rc;
+
+    VARPROBE_BEGIN( load, NULL, 0 );
+
+    if ( filedata != NULL )
+    {
+        result = varcreate_fnLoadBegin( &load, hVarServer, options );
+        if ( result == EOK )
+        {
+            if ( options->priority == true )
+            {
+                /* create the critical variables first */
+                load.tier = VARLOAD_TIER_CRITICAL;
+                result = varcreate_fnLoadString( &load, filedata );
+
+                rc = varcreate_fnLoadReady( &load );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+
+                load.tier = VARLOAD_TIER_NORMAL;
+            }
+
+            rc = varcreate_fnLoadString( &load, filedata );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            rc = varcreate_fnLoadAliases( &load );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            varcreate_fnLoadEnd( &load );
+        }
+    }
+
+    VARPROBE_END( load, NULL, result );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_CreateFromStream                                                */
+/*!
+    Create variables from newline delimited JSON read from a descriptor
+
+    The VARCREATE_CreateFromStream function reads newline delimited
+    JSON from the specified file descriptor, such as a pipe from a
+    program which generates variable definitions, until the end of the
+    input.  Each line holds one JSON variable object, which is parsed
+    and created as soon as the line has been read, so the producer and
+    the variable server work in parallel.  Blank lines are ignored.
+
+    If batching is enabled, the batch is submitted whenever the
+    producer pauses, so variables are never held back waiting for more
+    input to fill the batch.
+
+    The input can only be read once, so the priority option cannot
+    create the critical variables first.  If it is set, the ready
+    function is called once every variable has been created.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        fd
+            file descriptor to read the variable definitions from
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval EIO - the input could not be read
+    @retval EBADMSG - a line is not valid JSON
+    @retval E2BIG - a line is longer than VARSTREAM_MAX_ELEMENT_SIZE
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+int VARCREATE_CreateFromStream( VARSERVER_HANDLE hVarServer,
+                                int fd,
+                                VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarLoad load;
+    uint64_t start;
+    int rc;
+
+    VARPROBE_BEGIN( load, NULL, fd );
+
+    if ( fd >= 0 )
+    {
+        result = varcreate_fnLoadBegin( &load, hVarServer, options );
+        if ( result == EOK )
+        {
+            start = varcreate_fnClock( &load );
+
+            result = varcreate_fnLoadLines( &load, fd );
+
+            rc = varcreate_fnLoadAliases( &load );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            if ( ( options->priority == true ) &&
+                 ( options->ready != NULL ) )
+            {
+                /* every variable is critical to a single pass */
+                options->ready( options->readyArg );
+            }
+
+            varcreate_fnFileStats( &load, NULL, start );
+
+            varcreate_fnLoadEnd( &load );
+        }
+    }
+
+    VARPROBE_END( load, NULL, result );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_ContextCreate                                                   */
+/*!
+    Create a reusable variable creation context
+
+    The VARCREATE_ContextCreate function prepares the state used to
+    create variables, so that repeated calls to VARCREATE_ContextLoad
+    with small JSON documents reuse the same parse arena, variable batch
+    and precomputed options instead of setting them up on every call.
+    The options are copied, so they do not need to outlive the call.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval handle to the new context
+    @retval NULL if the context could not be created
+
+==============================================================================*/
+VARCREATE_CONTEXT VARCREATE_ContextCreate( VARSERVER_HANDLE hVarServer,
+                                           VarCreateOptions *options )
+{
+    VARCREATE_CONTEXT ctx = NULL;
+    int result = EINVAL;
+
+    if ( ( hVarServer != NULL ) &&
+         ( options != NULL ) )
+    {
+        result = ENOMEM;
+
+        ctx = calloc( 1, sizeof( struct _VarCreateContext ) );
+        if ( ctx != NULL )
+        {
+            ctx->options = *options;
+            ctx->options.prefix = NULL;
+            ctx->options.cache = NULL;
+
+            result = EOK;
+
+            if ( options->prefix != NULL )
+            {
+                ctx->options.prefix = strdup( options->prefix );
+                result = ( ctx->options.prefix != NULL ) ? EOK : ENOMEM;
+            }
+
+            if ( ( result == EOK ) &&
+                 ( options->cache != NULL ) )
+            {
+                ctx->options.cache = strdup( options->cache );
+                result = ( ctx->options.cache != NULL ) ? EOK : ENOMEM;
+            }
+
+            if ( result == EOK )
+            {
+                result = varcreate_fnLoadBegin( &ctx->load,
+                                                hVarServer,
+                                                &ctx->options );
+            }
+
+            if ( ( result == EOK ) &&
+                 ( ctx->options.cache != NULL ) )
+            {
+                result = varcache_Open( &ctx->cache,
+                                        ctx->options.cache,
+                                        &ctx->options );
+                if ( result == EOK )
+                {
+                    ctx->load.pCache = &ctx->cache;
+                }
+                else
+                {
+                    varcreate_fnLoadEnd( &ctx->load );
+                }
+            }
+
+            if ( result != EOK )
+            {
+                free( ctx->options.prefix );
+                free( ctx->options.cache );
+                free( ctx );
+                ctx = NULL;
+            }
+        }
+    }
+
+    return ctx;
+}
+
+/*============================================================================*/
+/*  VARCREATE_ContextLoad                                                     */
+/*!
+    Create variables from a JSON configuration string using a context
+
+    The VARCREATE_ContextLoad function behaves as VARCREATE_CreateFromString
+    using the server and options of the context.  If the priority option
+    is set, the string is parsed twice, and the ready function is called
+    once the critical variables of this string have been created.
+
+    @param[in]
+        ctx
+            handle to the variable creation context
+
+    @param[in]
+        filedata
+            string containing variable creation JSON config data
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+int VARCREATE_ContextLoad( VARCREATE_CONTEXT ctx, const char *filedata )
+{
+    int result = EINVAL;
+    int rc;
+
+    if ( ( ctx != NULL ) &&
+         ( filedata != NULL ) )
+    {
+        result = EOK;
+
+        if ( ctx->options.priority == true )
+        {
+            /* create the critical variables first */
+            ctx->load.tier = VARLOAD_TIER_CRITICAL;
+            result = varcreate_fnLoadString( &ctx->load, filedata );
+
+            rc = varcreate_fnLoadReady( &ctx->load );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            ctx->load.tier = VARLOAD_TIER_NORMAL;
+        }
+
+        rc = varcreate_fnLoadString( &ctx->load, filedata );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        rc = varcreate_fnLoadAliases( &ctx->load );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        ctx->load.tier = VARLOAD_TIER_ALL;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_ContextLoadFile                                                 */
+/*!
+    Create variables from a JSON config file using a context
+
+    The VARCREATE_ContextLoadFile function behaves as
+    VARCREATE_CreateFromFile using the server and options of the context,
+    except that the preflight and instances options do not apply.  If
+    the priority option is set, the file is read twice, and the ready
+    function is called once the critical variables of this file have
+    been created.
+
+    @param[in]
+        ctx
+            handle to the variable creation context
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval other - the file could not be read or a variable failed
+
+==============================================================================*/
+int VARCREATE_ContextLoadFile( VARCREATE_CONTEXT ctx, char *filename )
+{
+    int result = EINVAL;
+    int rc;
+
+    if ( ctx != NULL )
+    {
+        result = EOK;
+
+        if ( ctx->options.priority == true )
+        {
+            /* create the critical variables first */
+            ctx->load.tier = VARLOAD_TIER_CRITICAL;
+            result = varcreate_fnLoadFile( &ctx->load, filename );
+
+            rc = varcreate_fnLoadReady( &ctx->load );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            ctx->load.tier = VARLOAD_TIER_NORMAL;
+        }
+
+        rc = varcreate_fnLoadFile( &ctx->load, filename );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        rc = varcreate_fnLoadAliases( &ctx->load );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        ctx->load.tier = VARLOAD_TIER_ALL;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_ContextDestroy                                                  */
+/*!
+    Destroy a variable creation context
+
+    The VARCREATE_ContextDestroy function writes the load cache, if the
+    context has one, and releases all of the resources of the context.
+
+    @param[in]
+        ctx
+            handle to the variable creation context
+
+==============================================================================*/
+void VARCREATE_ContextDestroy( VARCREATE_CONTEXT ctx )
+{
+    if ( ctx != NULL )
+    {
+        varcreate_fnLoadEnd( &ctx->load );
+
+        if ( ctx->load.pCache != NULL )
+        {
+            (void)varcache_Close( ctx->load.pCache );
+        }
+
+        free( ctx->options.prefix );
+        free( ctx->options.cache );
+        free( ctx );
+    }
+}
+
+/*============================================================================*/
+/*  VARCREATE_CreateBatch                                                     */
+/*!
+    Create a batch of variables
+
+    The VARCREATE_CreateBatch function submits an array of fully
+    populated VarInfo objects to the variable server.  Every entry
+    is attempted, regardless of whether an earlier entry failed, and
+    the outcome of each entry is reported in the results array.
+    On success, the hVar member of each VarInfo object is populated
+    with the handle of the newly created variable.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in,out]
+        pVarInfo
+            pointer to an array of n VarInfo objects to create
+
+    @param[in]
+        n
+            number of VarInfo objects in the pVarInfo array
+
+    @param[out]
+        results
+            pointer to an array of n result codes to be populated with
+            the creation result of each variable.  May be NULL if the
+            per-variable results are not required.
+
+    @retval EOK - all variables were created successfully
+    @retval EINVAL - invalid arguments
+    @retval other - the error code of the last variable which failed
+
+==============================================================================*/
+int VARCREATE_CreateBatch( VARSERVER_HANDLE hVarServer,
+                           VarInfo *pVarInfo,
+                           size_t n,
+                           int *results )
+{
+    int result = EINVAL;
+    size_t i;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pVarInfo != NULL ) )
+    {
+        /* assume success until something fails */
+        result = EOK;
+
+        /* the variable server does not yet provide a bulk creation
+           request, so the batch is submitted one entry at a time here.
+           This is the only place the batch needs to change when it does */
+        for ( i = 0 ; i < n ; i++ )
+        {
+            VARPROBE_BEGIN( create,
+                            pVarInfo[i].name,
+                            pVarInfo[i].instanceID );
+
+            rc = VARSERVER_CreateVar( hVarServer, &pVarInfo[i] );
+
+            VARPROBE_END( create, pVarInfo[i].name, rc );
+
+            if ( results != NULL )
+            {
+                results[i] = rc;
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_CreateAliasBatch                                                */
+/*!
+    Create a batch of aliases
+
+    The VARCREATE_CreateAliasBatch function submits an array of aliases
+    to the variable server.  Every entry is attempted, regardless of
+    whether an earlier entry failed, and the outcome of each entry is
+    reported in the results array.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create aliases for
+
+    @param[in]
+        pAliases
+            pointer to an array of n aliases to create
+
+    @param[in]
+        n
+            number of aliases in the pAliases array
+
+    @param[out]
+        results
+            pointer to an array of n result codes to be populated with
+            the creation result of each alias.  May be NULL if the
+            per-alias results are not required.
+
+    @retval EOK - all aliases were created successfully
+    @retval EINVAL - invalid arguments
+    @retval other - the error code of the last alias which failed
+
+==============================================================================*/
+int VARCREATE_CreateAliasBatch( VARSERVER_HANDLE hVarServer,
+                                VarCreateAlias *pAliases,
+                                size_t n,
+                                int *results )
+{
+    int result = EINVAL;
+    size_t i;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pAliases != NULL ) )
+    {
+        /* assume success until something fails */
+        result = EOK;
+
+        /* as with VARCREATE_CreateBatch, the variable server does not yet
+           provide a bulk request, so this is the only place the aliases
+           are submitted one at a time */
+        for ( i = 0 ; i < n ; i++ )
+        {
+            VARPROBE_BEGIN( alias, pAliases[i].name, pAliases[i].hVar );
+
+            rc = VAR_Alias( hVarServer,
+                            pAliases[i].hVar,
+                            pAliases[i].name,
+                            NULL );
+
+            VARPROBE_END( alias, pAliases[i].name, rc );
+
+            if ( results != NULL )
+            {
+                results[i] = rc;
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoadBegin                                                     */
+/*!
+    Prepare a variable load
+
+    The varcreate_fnLoadBegin function initializes a VarLoad object
+    used to create variables from one or more varcreate JSON documents,
+    allocating the variable batch if batching is enabled.  Aliases are
+    created as soon as their variables have been created unless the
+    deferAliases option is set, or the caller subsequently attaches an
+    alias list to the load.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object to initialize
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - the load was initialized
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varcreate_fnLoadBegin( VarLoad *pLoad,
+                           VARSERVER_HANDLE hVarServer,
+                           VarCreateOptions *options )
+{
+    int result = EINVAL;
+
+    if ( ( pLoad != NULL ) &&
+         ( options != NULL ) )
+    {
+        memset( pLoad, 0, sizeof( VarLoad ) );
+        pLoad->hVarServer = hVarServer;
+        pLoad->options = options;
+        pLoad->timing = ( options->stats != NULL );
+
+        if ( options->deferAliases == true )
+        {
+            /* create the aliases once the load is complete */
+            pLoad->pAliases = &pLoad->aliases;
+        }
+
+        if ( options->prefix != NULL )
+        {
+            /* the prefix is applied to every variable name */
+            pLoad->prefixLen = strlen( options->prefix );
+            if ( pLoad->prefixLen > MAX_NAME_LEN )
+            {
+                pLoad->prefixLen = MAX_NAME_LEN;
+            }
+        }
+
+        result = EOK;
+
+        if ( options->pipeline == true )
+        {
+            /* the creator thread does its own batching */
+            pLoad->pPipe = calloc( 1, sizeof( VarPipe ) );
+            result = ( pLoad->pPipe != NULL )
+                        ? varpipe_Init( pLoad->pPipe,
+                                        options->pipelineDepth,
+                                        options->batchSize,
+                                        varcreate_fnPipeCreate,
+                                        pLoad )
+                        : ENOMEM;
+            if ( result != EOK )
+            {
+                free( pLoad->pPipe );
+                pLoad->pPipe = NULL;
+            }
+        }
+        else if ( options->batchSize > 1 )
+        {
+            pLoad->pBatch = calloc( 1, sizeof( VarBatch ) );
+            result = ( pLoad->pBatch != NULL )
+                        ? varcreate_fnBatchInit( pLoad->pBatch,
+                                                 options->batchSize )
+                        : ENOMEM;
+            if ( result != EOK )
+            {
+                free( pLoad->pBatch );
+                pLoad->pBatch = NULL;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoadFile                                                      */
+/*!
+    Create variables from a JSON config file as part of a variable load
+
+    The varcreate_fnLoadFile function creates the variables described
+    by the config file.  If the load has a cache, the file is skipped if
+    the cache shows it is unchanged since it was last loaded into the
+    same variable server, and the cache is updated with the outcome of
+    the load.  The pass which creates only the critical variables
+    leaves the cache to the pass which completes the file.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval other - the file could not be read or a variable failed
+
+==============================================================================*/
+int varcreate_fnLoadFile( VarLoad *pLoad, char *filename )
+{
+    int result = EINVAL;
+    uint64_t hash;
+    uint64_t start;
+    bool cached = false;
+    int rc;
+
+    if ( ( pLoad != NULL ) &&
+         ( filename != NULL ) )
+    {
+        start = varcreate_fnClock( pLoad );
+
+        if ( ( pLoad->pCache != NULL ) &&
+             ( pLoad->pSnapshot == NULL ) )
+        {
+            cached = ( varcache_Hash( filename,
+                                      pLoad->options,
+                                      &hash ) == EOK );
+        }
+
+        if ( ( cached == true ) &&
+             ( varcache_Check( pLoad->pCache,
+                               pLoad->hVarServer,
+                               filename,
+                               hash ) == true ) )
+        {
+            if ( pLoad->options->verbose )
+            {
+                varlog_Printf( pLoad->options,
+                               "VARCREATE: Skipping unchanged file: %s\n",
+                               filename );
+            }
+
+            pLoad->stats.skipped++;
+            result = EOK;
+        }
+        else
+        {
+            pLoad->hFirst = VAR_INVALID;
+            pLoad->hasFirst = false;
+            pLoad->filename = filename;
+            pLoad->index = 0;
+
+            VARPROBE_BEGIN( file, filename, pLoad->tier );
+
+            result = varcreate_fnLoad( pLoad, filename );
+
+            VARPROBE_END( file, filename, result );
+
+            pLoad->filename = NULL;
+
+            if ( ( cached == true ) &&
+                 ( pLoad->tier != VARLOAD_TIER_CRITICAL ) )
+            {
+                if ( ( result == EOK ) &&
+                     ( pLoad->hFirst != VAR_INVALID ) )
+                {
+                    rc = varcache_Update( pLoad->pCache,
+                                          filename,
+                                          hash,
+                                          pLoad->hFirst,
+                                          pLoad->firstName );
+                    if ( rc != EOK )
+                    {
+                        result = rc;
+                    }
+                }
+                else
+                {
+                    /* load the file again next time */
+                    varcache_Remove( pLoad->pCache, filename );
+                }
+            }
+        }
+
+        varcreate_fnFileStats( pLoad, filename, start );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoad                                                          */
+/*!
+    Read and process a JSON config file
+
+    The varcreate_fnLoad function reads, maps or scans the config
+    file as selected by the load options, and creates the variables it
+    describes.  Compressed files are always scanned.  Any variables
+    still waiting in the batch are created before the function returns.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @retval EOK - variable creation was successful
+    @retval ENOMEM - memory allocation problem
+    @retval other - the file could not be read or a variable failed
+
+==============================================================================*/
+static int varcreate_fnLoad( VarLoad *pLoad, char *filename )
+{
+    int result = EINVAL;
+    char *filedata;
+    size_t filesize;
+    uint64_t start;
+
+    if ( varzip_Format( filename ) != VARZIP_NONE )
+    {
+        /* decompress the file into the incremental scanner */
+        result = varcreate_fnStreamFile( pLoad, filename );
+    }
+    else if ( pLoad->options->mapFile == true )
+    {
+        /* parse the file in place */
+        result = varcreate_fnMapFile( pLoad, filename );
+    }
+    else if ( pLoad->options->stream == true )
+    {
+        /* scan the file incrementally */
+        result = varcreate_fnStreamFile( pLoad, filename );
+    }
+    else
+    {
+        /* read the varcreate file */
+        start = varcreate_fnClock( pLoad );
+        result = varcreate_fnReadFile( filename, &filedata, &filesize );
+        pLoad->stats.readTime += varcreate_fnElapsed( pLoad, start );
+
+        if( result == EOK )
+        {
+            pLoad->stats.bytes += filesize;
+
+            /* parse the JSON data read from the file */
+            result = varcreate_fnCreateFromBuffer( pLoad,
+                                                   filedata,
+                                                   filesize,
+                                                   false );
+
+            /* the file data is no longer required */
+            free( filedata );
+        }
+        else if ( result == EFBIG )
+        {
+            /* the file is too large to parse in one piece */
+            result = varcreate_fnStreamFile( pLoad, filename );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoadAliases                                                   */
+/*!
+    Create the aliases deferred by a variable load
+
+    The varcreate_fnLoadAliases function creates the aliases collected
+    by the load because the deferAliases option is set.  Nothing is done
+    if the aliases are not deferred, or if they are collected into an
+    alias list attached by the caller.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @retval EOK - all of the deferred aliases were created
+    @retval other - one or more aliases could not be created
+
+==============================================================================*/
+int varcreate_fnLoadAliases( VarLoad *pLoad )
+{
+    int result = EOK;
+    VarCreateStats stats;
+
+    if ( ( pLoad != NULL ) &&
+         ( pLoad->pAliases == &pLoad->aliases ) &&
+         ( pLoad->aliases.count > 0 ) )
+    {
+        memset( &stats, 0, sizeof( VarCreateStats ) );
+
+        result = varcreate_fnCreateAliases( pLoad->hVarServer,
+                                            &pLoad->aliases,
+                                            pLoad->options,
+                                            pLoad->pCache,
+                                            pLoad->timing ? &stats : NULL );
+
+        /* the aliases are not attributed to their files */
+        varcreate_fnAddStats( pLoad->options, &stats );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoadReady                                                     */
+/*!
+    Signal that the critical variables of a load have been created
+
+    The varcreate_fnLoadReady function completes the pass which creates
+    the critical variables.  The aliases deferred so far belong to the
+    critical variables, so they are created before the ready function
+    of the load options is called.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @retval EOK - the ready function was called
+    @retval EINVAL - invalid arguments
+    @retval other - one or more deferred aliases could not be created
+
+==============================================================================*/
+int varcreate_fnLoadReady( VarLoad *pLoad )
+{
+    int result = EINVAL;
+
+    if ( pLoad != NULL )
+    {
+        result = varcreate_fnLoadAliases( pLoad );
+
+        /* the aliases must not be created again at the end of the load */
+        varcreate_fnFreeAliases( &pLoad->aliases );
+
+        if ( pLoad->options->ready != NULL )
+        {
+            pLoad->options->ready( pLoad->options->readyArg );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoadEnd                                                       */
+/*!
+    Release the resources used by a variable load
+
+    The varcreate_fnLoadEnd function stops the pipeline and releases
+    the variable batch, the parse arena, the attribute memo table and
+    any deferred aliases which were not created.  An alias list
+    attached to the load is owned by the caller and is not affected.
+    Any messages of the load which are still buffered are written out.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+==============================================================================*/
+void varcreate_fnLoadEnd( VarLoad *pLoad )
+{
+    VarArena *pPrevious;
+
+    if ( pLoad != NULL )
+    {
+        if ( pLoad->pPipe != NULL )
+        {
+            /* stop the creator thread before anything it uses is freed */
+            varpipe_Free( pLoad->pPipe );
+            free( pLoad->pPipe );
+            pLoad->pPipe = NULL;
+        }
+
+        if ( pLoad->pBatch != NULL )
+        {
+            /* the batch may still own trees allocated from the arena */
+            pPrevious = vararena_Select( &pLoad->arena );
+            varcreate_fnBatchFree( pLoad->pBatch );
+            vararena_Select( pPrevious );
+
+            free( pLoad->pBatch );
+            pLoad->pBatch = NULL;
+        }
+
+        vararena_Free( &pLoad->arena );
+        pLoad->trees = 0;
+
+        varcreate_fnFreeAliases( &pLoad->aliases );
+        varmemo_Free( &pLoad->memo );
+
+        varlog_Flush();
+    }
+}
+
+/*============================================================================*/
+/*  varcreate_fnMapFile                                                       */
+/*!
+    Create variables from a JSON config file which is mapped into memory
+
+    The varcreate_fnMapFile function maps the config file into memory
+    read-only and parses it in place, avoiding a copy of the file data.
+    Repeated loads of the same file are served from the page cache.
+    Files larger than MAX_VARCREATE_FILE_SIZE are scanned incrementally
+    from the mapping.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOENT - unable to open the file
+    @retval ENOTSUP - cannot map this file type
+    @retval ENOMEM - the file could not be mapped
+
+==============================================================================*/
+static int varcreate_fnMapFile( VarLoad *pLoad, char *filename )
+{
+    int result = EINVAL;
+    struct stat st;
+    uint64_t start;
+    void *p;
+    size_t len;
+    int fd;
+
+    start = varcreate_fnClock( pLoad );
+
+    fd = open( filename, O_RDONLY );
+    if ( fd != -1 )
+    {
+        if ( ( fstat( fd, &st ) == 0 ) &&
+             ( S_ISREG( st.st_mode ) ) )
+        {
+            len = st.st_size;
+            if ( len > 0 )
+            {
+                p = mmap( NULL, len, PROT_READ, MAP_PRIVATE, fd, 0 );
+                if ( p != MAP_FAILED )
+                {
+                    /* the file is parsed from start to end */
+                    (void)madvise( p, len, MADV_SEQUENTIAL );
+
+                    /* the pages are read as they are parsed, so most
+                       of the read time is counted as parse time */
+                    pLoad->stats.readTime += varcreate_fnElapsed( pLoad,
+                                                                  start );
+                    pLoad->stats.bytes += len;
+
+                    result = varcreate_fnCreateFromBuffer(
+                                pLoad,
+                                (const char *)p,
+                                len,
+                                ( pLoad->options->stream == true ) ||
+                                ( len > MAX_VARCREATE_FILE_SIZE ) );
+
+                    munmap( p, len );
+                }
+                else
+                {
+                    result = ENOMEM;
+                }
+            }
+            else
+            {
+                /* an empty file is not valid JSON */
+                result = EBADMSG;
+            }
+        }
+        else
+        {
+            /* invalid file type */
+            result = ENOTSUP;
+        }
+
+        close( fd );
+    }
+    else
+    {
+        /* file cannot be opened for reading */
+        result = ENOENT;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnCreateFromBuffer                                              */
+/*!
+    Create variables from a buffer containing JSON configuration
+
+    The varcreate_fnCreateFromBuffer function parses the JSON
+    configuration in the specified buffer, which does not need to
+    be NUL terminated, and creates the variables it describes.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filedata
+            pointer to the variable creation JSON config data
+
+    @param[in]
+        len
+            number of bytes of JSON config data
+
+    @param[in]
+        stream
+            true to scan the buffer incrementally, false to parse the
+            entire buffer before creating any variables
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval EBADMSG - the JSON config data is malformed
+
+==============================================================================*/
+static int varcreate_fnCreateFromBuffer( VarLoad *pLoad,
+                                         const char *filedata,
+                                         size_t len,
+                                         bool stream )
+{
+    int result = EINVAL;
+    cJSON *vardata;
+    VarStream vs;
+
+    if ( stream == true )
+    {
+        /* scan the buffer incrementally */
+        result = varstream_Init( &vs,
+                                 varcreate_fnStreamElement,
+                                 varcreate_fnStreamDefaults,
+                                 pLoad );
+        if ( result == EOK )
+        {
+            (void)varstream_Feed( &vs, filedata, len );
+            result = varcreate_fnStreamClose( pLoad, &vs );
+        }
+    }
+    else
+    {
+        vardata = varcreate_fnParse( pLoad, filedata, len );
+        if( vardata != NULL )
+        {
+            /* process the variable data */
+            result = varcreate_fnProcessVarData( pLoad, vardata );
+
+            /* delete the vardata JSON object now that we are done with it */
+            varcreate_fnDelete( pLoad, vardata );
+        }
+        else
+        {
+            result = varcreate_fnMalformed( pLoad, filedata, len, EBADMSG );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnProcessVarData                                                */
+/*!
+    Process the variables specified in the varcreate JSON
+
+    The varcreate_fnProcessVarData function processes the varcreates JSON
+    object specified in vardata, iterates through the variables in the
+    JSON array and creates them via a call to the variable server.
+
+    The attributes of the optional "defaults" object are applied to
+    every variable which does not specify them itself.
+
+    If the load has a variable batch, the variables are gathered into
+    the batch and each full batch is submitted to the variable server
+    together.  The remainder of the last batch is submitted before
+    the function returns.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        vardata
+            pointer to a cJSON object containing the variable data
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varcreate_fnProcessVarData( VarLoad *pLoad, cJSON *vardata )
+{
+    int result = EINVAL;
+    const cJSON *desc;
+    const cJSON *vars;
+    const cJSON *var;
+    int rc;
+
+    if( vardata != NULL )
+    {
+        /* get the description of the variables being created */
+        desc = cJSON_GetObjectItemCaseSensitive( vardata,
+                                                 "description" );
+
+        /* not doing anything with desc right now */
+        (void)desc;
+
+        /* get the attributes to apply to every variable */
+        pLoad->defaults = cJSON_GetObjectItemCaseSensitive( vardata,
+                                                            "defaults" );
+        if ( !cJSON_IsObject( pLoad->defaults ) )
+        {
+            pLoad->defaults = NULL;
+        }
+
+        /* get a pointer to the array of variables to be created */
+        vars = cJSON_GetObjectItemCaseSensitive( vardata, "vars" );
+        if( ( vars != NULL ) &&
+            ( cJSON_IsArray( vars ) ) )
+        {
+            result = EOK;
+
+            /* iterate through each variable to be created */
+            cJSON_ArrayForEach( var, vars )
+            {
+                /* process each variable one at a time */
+                rc = varcreate_fnProcessVar( pLoad, var );
+                if( rc != EOK )
+                {
+                    /* variable creation failed */
+                    result = rc;
+                }
+            }
+
+            /* submit the remainder of the last batch */
+            rc = varcreate_fnBatchFlush( pLoad );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+
+        /* the defaults are part of vardata, which the caller deletes */
+        pLoad->defaults = NULL;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnProcessVar                                                    */
+/*!
+    Process a variable specified in the varcreate JSON
+
+    The varcreate_fnProcessVar function processes a single variable
+    in the specified JSON object.  If the load has a variable batch,
+    the variable is appended to the batch and the batch is submitted
+    once it is full, otherwise the variable is created immediately.
+
+    If the variable name contains a {first..last} index range, the
+    object is a template, and a variable is created for every index.
+
+    If the load has a pipeline, the variable is built into the next
+    slot of the pipeline and queued for the creator thread, which
+    reports whether it could be built and created.
+
+    Variables which do not belong to the current pass of a prioritized
+    load are skipped.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        vardata
+            pointer to a cJSON object containing the variable data
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varcreate_fnProcessVar( VarLoad *pLoad, const cJSON *vardata )
+{
+    VarInfo variableInfo;
+    VarInfo *pVarInfo = &variableInfo;
+    VarBatch *pBatch;
+    VarPipeEntry *pEntry = NULL;
+    const cJSON *alias;
+    VarRange range;
+    uint64_t start;
+    int result = EINVAL;
+
+    if ( ( pLoad != NULL ) &&
+         ( cJSON_IsObject( vardata ) ) &&
+         ( varcreate_fnSkip( pLoad, vardata ) == true ) )
+    {
+        /* the variable is created by the other pass */
+        result = EOK;
+    }
+    else if( ( pLoad != NULL ) &&
+        ( ( pLoad->hVarServer != NULL ) ||
+          ( pLoad->pSnapshot != NULL ) ||
+          ( pLoad->pCheck != NULL ) ) &&
+        ( vardata != NULL ) &&
+        ( cJSON_IsObject( vardata ) ) )
+    {
+        VARPROBE_BEGIN( var, pLoad->filename, pLoad->index );
+
+        pBatch = pLoad->pBatch;
+        if ( pLoad->pPipe != NULL )
+        {
+            /* build the variable directly into the next pipeline slot */
+            pVarInfo = varpipe_Reserve( pLoad->pPipe, &pEntry );
+        }
+        else if ( pBatch != NULL )
+        {
+            /* build the variable directly into the next batch slot */
+            pVarInfo = &pBatch->info[pBatch->count];
+        }
+
+        start = varcreate_fnClock( pLoad );
+        result = varcreate_fnBuildVarInfo( pLoad, vardata, pVarInfo, &alias );
+        pLoad->stats.handlerTime += varcreate_fnElapsed( pLoad, start );
+
+        if ( ( result == EOK ) &&
+             ( varcreate_fnGetRange( vardata, pVarInfo->name, &range ) ) )
+        {
+            /* stamp out a variable for each index of the range */
+            result = varcreate_fnExpand( pLoad, pVarInfo, &range, alias );
+        }
+        else if ( pEntry != NULL )
+        {
+            /* the creator thread reports the outcome in input order */
+            result = varcreate_fnQueue( pLoad,
+                                        pVarInfo,
+                                        pEntry,
+                                        result,
+                                        alias,
+                                        NULL );
+        }
+        else if( result == EOK )
+        {
+            if ( pLoad->options->verbose )
+            {
+                varlog_Printf( pLoad->options,
+                               "VARCREATE: Creating variable: %s\n",
+                               pVarInfo->name );
+            }
+
+            if ( pBatch != NULL )
+            {
+                pBatch->objects[pBatch->count] = NULL;
+                pBatch->items[pBatch->count] = pLoad->index;
+                pBatch->aliases[pBatch->count++] = alias;
+                if ( pBatch->count == pBatch->size )
+                {
+                    result = varcreate_fnBatchFlush( pLoad );
+                }
+            }
+            else
+            {
+                result = varcreate_fnCreateVar( pLoad, pVarInfo, alias );
+            }
+        }
+        else
+        {
+            /* the attributes which failed have been reported */
+            varlog_Printf( pLoad->options,
+                           "Failed to create variable: %s\n",
+                           pVarInfo->name );
+            pLoad->stats.failed++;
+        }
+
+        VARPROBE_END( var, pLoad->filename, result );
+    }
+
+    if ( pLoad != NULL )
+    {
+        /* move on to the next definition of the input */
+        pLoad->index++;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnSkip                                                          */
+/*!
+    Determine whether a variable belongs to another pass of the load
+
+    The varcreate_fnSkip function compares the "priority" attribute of
+    the variable, or of the file defaults, with the current pass of a
+    prioritized load.  A variable is critical if its priority is
+    "critical".
+
+    The pass which completes a cached file skips the critical
+    variables, so if it has not yet created a variable, the first
+    critical variable which exists is recorded in its place.  With a
+    pipeline, the creator thread records the first variable it creates,
+    so the check waits for the creator thread to become idle, until the
+    first variable is known.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        vardata
+            pointer to a cJSON object containing the variable data
+
+    @retval true - the variable is created by another pass
+    @retval false - the variable is created by this pass
+
+==============================================================================*/
+static bool varcreate_fnSkip( VarLoad *pLoad, const cJSON *vardata )
+{
+    bool skip = false;
+    bool critical;
+    const cJSON *priority;
+    VarInfo info;
+    VarRange range;
+    VAR_HANDLE hVar;
+
+    if ( pLoad->tier != VARLOAD_TIER_ALL )
+    {
+        priority = cJSON_GetObjectItem( vardata, "priority" );
+        if ( ( priority == NULL ) &&
+             ( pLoad->defaults != NULL ) )
+        {
+            priority = cJSON_GetObjectItem( pLoad->defaults, "priority" );
+        }
+
+        critical = ( cJSON_IsString( priority ) ) &&
+                   ( strcasecmp( priority->valuestring, "critical" ) == 0 );
+
+        skip = ( pLoad->tier == VARLOAD_TIER_CRITICAL ) ? !critical
+                                                        : critical;
+
+        if ( ( skip == true ) &&
+             ( critical == true ) &&
+             ( pLoad->pCache != NULL ) &&
+             ( pLoad->hasFirst == false ) )
+        {
+            if ( pLoad->pPipe != NULL )
+            {
+                /* the creator thread may be recording the first
+                   variable of the file */
+                varpipe_Wait( pLoad->pPipe );
+            }
+
+            if ( ( pLoad->hFirst == VAR_INVALID ) &&
+                 ( varcreate_fnBuildName( pLoad, vardata, &info ) == EOK ) &&
+                 ( varcreate_fnGetRange( vardata,
+                                         info.name,
+                                         &range ) == false ) )
+            {
+                hVar = VAR_FindByName( pLoad->hVarServer, info.name );
+                if ( hVar != VAR_INVALID )
+                {
+                    pLoad->hFirst = hVar;
+                    strcpy( pLoad->firstName, info.name );
+                }
+            }
+
+            pLoad->hasFirst = ( pLoad->hFirst != VAR_INVALID );
+        }
+    }
+
+    return skip;
+}
+
+/*============================================================================*/
+/*  varcreate_fnBuildVarInfo                                                  */
+/*!
+    Build a VarInfo object from a variable specified in the varcreate JSON
+
+    The varcreate_fnBuildVarInfo function applies all of the attribute
+    handlers and the variable creation options to populate a VarInfo
+    object ready to be submitted to the variable server.  Attributes
+    which the variable does not specify are taken from the "defaults"
+    object of the file, if it has one.  Each attribute which fails is
+    reported against the definition being processed by the load.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        vardata
+            pointer to a cJSON object containing the variable data
+
+    @param[out]
+        pVarInfo
+            pointer to the VarInfo object to populate
+
+    @param[out]
+        ppAlias
+            pointer to a location to store the variable's 'alias'
+            attribute, or NULL if it is not required.  The stored
+            pointer is NULL if the variable has no aliases.
+
+    @retval EOK - the VarInfo object was populated successfully
+    @retval E2BIG - the initial value is too large for the variable
+    @retval other - an attribute handler failed
+
+==============================================================================*/
+static int varcreate_fnBuildVarInfo( VarLoad *pLoad,
+                                     const cJSON *vardata,
+                                     VarInfo *pVarInfo,
+                                     const cJSON **ppAlias )
+{
+    VarCreateOptions *options = pLoad->options;
+    cJSON *item;
+    cJSON *items[VARATTR_MAX] = { NULL };
+    int failed[VARATTR_ALIAS] = { EOK };
+    VarAttribute attr;
+    int i;
+    int rc;
+    int result;
+    size_t len;
+
+    /* clear the Variable Info object */
+    memset( pVarInfo, 0, sizeof( VarInfo ) );
+
+    /* assume success until something fails */
+    result = EOK;
+
+    /* find all of the attributes in a single pass over the object.
+       As with cJSON_GetObjectItem, the first occurrence of a
+       duplicated attribute is the one which is used */
+    cJSON_ArrayForEach( item, vardata )
+    {
+        attr = varcreate_fnGetAttribute( item->string );
+        if ( ( attr != VARATTR_UNKNOWN ) &&
+             ( items[attr] == NULL ) )
+        {
+            items[attr] = item;
+        }
+    }
+
+    if ( pLoad->defaults != NULL )
+    {
+        /* fill in the missing attributes from the defaults.  Every
+           variable must have its own name, GUID and aliases */
+        cJSON_ArrayForEach( item, pLoad->defaults )
+        {
+            attr = varcreate_fnGetAttribute( item->string );
+            if ( ( attr != VARATTR_UNKNOWN ) &&
+                 ( attr != VARATTR_NAME ) &&
+                 ( attr != VARATTR_GUID ) &&
+                 ( attr != VARATTR_ALIAS ) &&
+                 ( items[attr] == NULL ) )
+            {
+                items[attr] = item;
+            }
+        }
+    }
+
+    /* process the attributes in handler order */
+    for ( i = 0 ; i < VARATTR_ALIAS ; i++ )
+    {
+        if( items[i] != NULL )
+        {
+            /* process the object item */
+            rc = varcreate_fnApplyAttribute( pLoad, i, pVarInfo, items[i] );
+            if( rc != EOK )
+            {
+                varlog_Printf( options,
+                               "Failed handler: %s\n",
+                               handlers[i].attribute );
+                failed[i] = rc;
+                result = rc;
+            }
+        }
+    }
+
+    if ( ppAlias != NULL )
+    {
+        *ppAlias = items[VARATTR_ALIAS];
+    }
+
+    if ( options->flags )
+    {
+        pVarInfo->flags |= (options->flags);
+    }
+
+    if ( ( pVarInfo->var.type == VARTYPE_STR ) &&
+         ( pVarInfo->var.len > 0 ) )
+    {
+        /* increment the length by 1 to account for the NUL terminator */
+        pVarInfo->var.len++;
+
+        if ( pVarInfo->var.val.str != NULL )
+        {
+            len = strlen( pVarInfo->var.val.str );
+            if ( len >= pVarInfo->var.len )
+            {
+                varlog_Printf( options,
+                               "Value too large for variable: %s\n",
+                               pVarInfo->name );
+                failed[VARATTR_VALUE] = E2BIG;
+                result = E2BIG;
+            }
+        }
+    }
+
+    pVarInfo->instanceID = options->instanceID;
+
+    varcreate_fnPrefix( pLoad, pVarInfo->name );
+
+    for ( i = 0 ; ( result != EOK ) && ( i < VARATTR_ALIAS ) ; i++ )
+    {
+        if ( failed[i] != EOK )
+        {
+            varlog_Report( options,
+                           pLoad->filename,
+                           pLoad->index,
+                           pVarInfo->name,
+                           handlers[i].attribute,
+                           failed[i] );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnBuildName                                                     */
+/*!
+    Build the name of a variable specified in the varcreate JSON
+
+    The varcreate_fnBuildName function applies only the name attribute
+    and the variable name prefix, without reporting any failure.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        vardata
+            pointer to a cJSON object containing the variable data
+
+    @param[out]
+        pVarInfo
+            pointer to the VarInfo object to store the name in
+
+    @retval EOK - the name was built
+    @retval ENOENT - the variable has no name
+    @retval other - the name handler failed
+
+==============================================================================*/
+static int varcreate_fnBuildName( VarLoad *pLoad,
+                                  const cJSON *vardata,
+                                  VarInfo *pVarInfo )
+{
+    int result = ENOENT;
+    cJSON *name;
+
+    memset( pVarInfo, 0, sizeof( VarInfo ) );
+
+    name = cJSON_GetObjectItem( vardata, handlers[VARATTR_NAME].attribute );
+    if ( name != NULL )
+    {
+        result = varcreate_fnApplyAttribute( pLoad,
+                                             VARATTR_NAME,
+                                             pVarInfo,
+                                             name );
+        if ( result == EOK )
+        {
+            varcreate_fnPrefix( pLoad, pVarInfo->name );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnPrefix                                                        */
+/*!
+    Prepend the variable name prefix of the load to a variable name
+
+    The name is updated in place.  As with snprintf, the result is
+    truncated if it is too long.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in,out]
+        name
+            pointer to a buffer of MAX_NAME_LEN+1 characters holding
+            the variable name
+
+==============================================================================*/
+static void varcreate_fnPrefix( VarLoad *pLoad, char *name )
+{
+    size_t len;
+    size_t n;
+
+    if ( pLoad->prefixLen > 0 )
+    {
+        n = pLoad->prefixLen;
+        len = strlen( name );
+        if ( n + len > MAX_NAME_LEN )
+        {
+            len = MAX_NAME_LEN - n;
+        }
+
+        memmove( &name[n], name, len );
+        memcpy( name, pLoad->options->prefix, n );
+        name[n + len] = '\0';
+    }
+}
+
+/*============================================================================*/
+/*  varcreate_fnCreateVar                                                     */
+/*!
+    Create a single variable and its aliases
+
+    The varcreate_fnCreateVar function submits a populated VarInfo
+    object to the variable server, and creates any aliases for the
+    variable once the variable has been created.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in,out]
+        pVarInfo
+            pointer to the VarInfo object describing the variable
+
+    @param[in]
+        alias
+            pointer to the cJSON 'alias' attribute, or NULL if the
+            variable has no aliases
+
+    @retval EOK - variable creation was successful
+    @retval other - variable or alias creation failed
+
+==============================================================================*/
+static int varcreate_fnCreateVar( VarLoad *pLoad,
+                                  VarInfo *pVarInfo,
+                                  const cJSON *alias )
+{
+    int result;
+
+    result = varcreate_fnSubmit( pLoad, pVarInfo, 1, NULL );
+    if ( ( result == EOK ) && ( pVarInfo->hVar != VAR_INVALID ) )
+    {
+        /* check for aliases */
+        if ( alias != NULL )
+        {
+            result = varcreate_ProcessAlias( pLoad,
+                                             pVarInfo,
+                                             (cJSON *)alias,
+                                             NULL,
+                                             pLoad->index );
+            if ( result != EOK )
+            {
+                varlog_Printf( pLoad->options, "Failed handler: alias\n" );
+                varlog_Report( pLoad->options,
+                               pLoad->filename,
+                               pLoad->index,
+                               pVarInfo->name,
+                               "alias",
+                               result );
+            }
+        }
+    }
+    else
+    {
+        varcreate_fnFailed( pLoad, pLoad->index, pVarInfo->name, result );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnFailed                                                        */
+/*!
+    Report a variable which the variable server did not create
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        index
+            index of the variable definition in the input
+
+    @param[in]
+        name
+            name of the variable
+
+    @param[in]
+        result
+            result of the variable creation
+
+==============================================================================*/
+static void varcreate_fnFailed( VarLoad *pLoad,
+                                size_t index,
+                                const char *name,
+                                int result )
+{
+    varlog_Printf( pLoad->options, "Failed to create variable: %s\n", name );
+    varlog_Report( pLoad->options,
+                   pLoad->filename,
+                   index,
+                   name,
+                   NULL,
+                   ( result != EOK ) ? result : ENOENT );
+}
+
+/*============================================================================*/
+/*  varcreate_fnAlias                                                         */
+/*!
+    Create an alias for a variable
+
+    The varcreate_fnAlias function creates the alias immediately, or
+    adds it to the load's alias list if the load is collecting aliases
+    to be created once all of the primary variables exist.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        hVar
+            handle of the variable to be aliased
+
+    @param[in]
+        name
+            name of the alias
+
+    @param[in]
+        index
+            index of the template variable being aliased, which replaces
+            each {i} placeholder in the alias name, or NULL
+
+    @param[in]
+        item
+            index of the variable definition in the input, which a
+            queued alias is reported against if it cannot be created
+
+    @retval EOK - the alias was created or queued
+    @retval ENOMEM - memory allocation problem
+    @retval E2BIG - the expanded alias name is too long
+    @retval other - the alias could not be created
+
+==============================================================================*/
+static int varcreate_fnAlias( VarLoad *pLoad,
+                              VAR_HANDLE hVar,
+                              char *name,
+                              const char *index,
+                              size_t item )
+{
+    int result = EOK;
+    char buf[MAX_NAME_LEN+1];
+    VarCreateAlias alias;
+    size_t existing = 0;
+    uint64_t start;
+
+    if ( ( index != NULL ) &&
+         ( strstr( name, VARCREATE_INDEX_PLACEHOLDER ) != NULL ) )
+    {
+        /* replace each placeholder with the template index */
+        result = varcreate_fnSubstitute( name, index, buf );
+        if ( result == EOK )
+        {
+            name = buf;
+        }
+        else
+        {
+            varlog_Printf( pLoad->options,
+                           "Alias name too long: %s\n",
+                           name );
+        }
+    }
+
+    if ( result == EOK )
+    {
+        if ( pLoad->pSnapshot != NULL )
+        {
+            result = varsnap_AddAlias( pLoad->pSnapshot, hVar, name );
+        }
+        else if ( pLoad->pCheck != NULL )
+        {
+            result = varcheck_AddAlias( pLoad->pCheck,
+                                        pLoad->options,
+                                        pLoad->filename,
+                                        pLoad->index,
+                                        name );
+        }
+        else if ( pLoad->pAliases != NULL )
+        {
+            result = varcreate_fnAddAlias( pLoad->pAliases,
+                                           hVar,
+                                           name,
+                                           pLoad->filename,
+                                           item );
+        }
+        else
+        {
+            VARPROBE_BEGIN( alias, name, hVar );
+
+            start = varcreate_fnClock( pLoad );
+            if ( pLoad->options->reconcile == true )
+            {
+                alias.hVar = hVar;
+                alias.name = name;
+                result = varrecon_CreateAliasBatch( pLoad->hVarServer,
+                                                    &alias,
+                                                    1,
+                                                    NULL,
+                                                    &existing );
+            }
+            else
+            {
+                result = VAR_Alias( pLoad->hVarServer, hVar, name, NULL );
+            }
+            pLoad->stats.aliasTime += varcreate_fnElapsed( pLoad, start );
+
+            VARPROBE_END( alias, name, result );
+
+            if ( result == EOK )
+            {
+                /* an existing alias is left as it is */
+                pLoad->stats.aliased += ( existing == 0 ) ? 1 : 0;
+                pLoad->stats.existing += existing;
+                varindex_Add( pLoad->options->index, name, hVar );
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnGetRange                                                      */
+/*!
+    Find the index range of a template variable
+
+    The varcreate_fnGetRange function searches the variable name for a
+    {first..last} index range, where first and last are decimal numbers
+    and first is not greater than last.  The optional 'stride' attribute
+    of a template gives the GUID increment from one variable to the next.
+    It defaults to 1 if the template has a GUID, and 0 otherwise.
+
+    @param[in]
+        vardata
+            pointer to the cJSON object containing the variable data
+
+    @param[in]
+        name
+            pointer to the NUL terminated variable name
+
+    @param[out]
+        pRange
+            pointer to the VarRange object to populate
+
+    @retval true - the variable is a template
+    @retval false - the variable name does not contain an index range
+
+==============================================================================*/
+static bool varcreate_fnGetRange( const cJSON *vardata,
+                                  const char *name,
+                                  VarRange *pRange )
+{
+    bool found = false;
+    const char *p;
+    const cJSON *stride;
+    unsigned long first = 0;
+    unsigned long last = 0;
+    char *end = NULL;
+
+    p = strchr( name, '{' );
+    while ( ( p != NULL ) && ( found == false ) )
+    {
+        if ( isdigit( (unsigned char)p[1] ) )
+        {
+            errno = 0;
+            first = strtoul( &p[1], &end, 10 );
+            if ( ( end[0] == '.' ) &&
+                 ( end[1] == '.' ) &&
+                 ( isdigit( (unsigned char)end[2] ) ) )
+            {
+                last = strtoul( &end[2], &end, 10 );
+                found = ( *end == '}' ) &&
+                        ( errno == 0 ) &&
+                        ( first <= last ) &&
+                        ( last <= UINT32_MAX );
+            }
+        }
+
+        if ( found == false )
+        {
+            p = strchr( &p[1], '{' );
+        }
+    }
+
+    if ( found == true )
+    {
+        pRange->offset = p - name;
+        pRange->len = end + 1 - p;
+        pRange->first = (uint32_t)first;
+        pRange->last = (uint32_t)last;
+        /* the GUIDs only advance if the template has a base GUID */
+        pRange->stride = ( cJSON_GetObjectItem( vardata, "guid" ) != NULL )
+                            ? 1
+                            : 0;
+
+        /* only templates need the stride, so it is looked up here */
+        stride = cJSON_GetObjectItem( vardata, "stride" );
+        if ( ( cJSON_IsString( stride ) ) &&
+             ( stride->valuestring != NULL ) )
+        {
+            pRange->stride = strtoul( stride->valuestring, NULL, 0 );
+        }
+    }
+
+    return found;
+}
+
+/*============================================================================*/
+/*  varcreate_fnExpand                                                        */
+/*!
+    Create the variables of a template
+
+    The varcreate_fnExpand function stamps out a copy of the template's
+    VarInfo object for each index of the range, with the range in the
+    name replaced by the index, and the GUID advanced by the stride.
+    The copies are submitted to the variable server in batches of the
+    load's batch size, after any variables already waiting in the batch.
+    Each {i} placeholder in the alias names is replaced by the index.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        pTemplate
+            pointer to the VarInfo object built from the template
+
+    @param[in]
+        pRange
+            pointer to the index range of the template
+
+    @param[in]
+        alias
+            pointer to the cJSON 'alias' attribute, or NULL if the
+            variables have no aliases
+
+    @retval EOK - all of the variables were created successfully
+    @retval E2BIG - the variable names are too long
+    @retval other - one or more variables or aliases could not be created
+
+==============================================================================*/
+static int varcreate_fnExpand( VarLoad *pLoad,
+                               const VarInfo *pTemplate,
+                               const VarRange *pRange,
+                               const cJSON *alias )
+{
+    int result;
+    VarBatch *pBatch = pLoad->pBatch;
+    VarInfo template;
+    VarInfo single;
+    VarInfo *info = &single;
+    VarPipeEntry *pEntry;
+    int one;
+    int *results = &one;
+    size_t size = 1;
+    char index[16];
+    uint64_t i;
+    uint32_t first;
+    size_t n;
+    size_t k;
+    int rc;
+
+    /* the template may have been built into the next batch slot */
+    template = *pTemplate;
+
+    /* the last index has the most digits, so if its name fits,
+       every name fits */
+    result = varcreate_fnRangeName( template.name,
+                                    pRange,
+                                    pRange->last,
+                                    single.name );
+    if ( result != EOK )
+    {
+        /* report the failure after the variables which precede it */
+        (void)varcreate_fnBatchFlush( pLoad );
+
+        varlog_Printf( pLoad->options,
+                       "Variable name too long: %s\n",
+                       template.name );
+        varlog_Report( pLoad->options,
+                       pLoad->filename,
+                       pLoad->index,
+                       template.name,
+                       handlers[VARATTR_NAME].attribute,
+                       result );
+        pLoad->stats.failed += (size_t)( pRange->last - pRange->first ) + 1;
+    }
+    else if ( pLoad->pPipe != NULL )
+    {
+        /* queue each variable of the range for the creator thread */
+        for ( i = pRange->first ; i <= pRange->last ; i++ )
+        {
+            info = varpipe_Reserve( pLoad->pPipe, &pEntry );
+            *info = template;
+            (void)varcreate_fnRangeName( template.name,
+                                         pRange,
+                                         (uint32_t)i,
+                                         info->name );
+            info->guid += (uint32_t)( i - pRange->first ) * pRange->stride;
+
+            snprintf( index, sizeof index, "%" PRIu32, (uint32_t)i );
+
+            (void)varcreate_fnQueue( pLoad,
+                                     info,
+                                     pEntry,
+                                     EOK,
+                                     alias,
+                                     index );
+        }
+    }
+    else
+    {
+        /* create the variables which precede the template first */
+        result = varcreate_fnBatchFlush( pLoad );
+
+        if ( pBatch != NULL )
+        {
+            info = pBatch->info;
+            results = pBatch->results;
+            size = pBatch->size;
+        }
+
+        i = pRange->first;
+        while ( i <= pRange->last )
+        {
+            first = (uint32_t)i;
+
+            for ( n = 0 ; ( n < size ) && ( i <= pRange->last ) ; n++, i++ )
+            {
+                info[n] = template;
+                (void)varcreate_fnRangeName( template.name,
+                                             pRange,
+                                             (uint32_t)i,
+                                             info[n].name );
+                info[n].guid += (uint32_t)( i - pRange->first ) *
+                                pRange->stride;
+
+                if ( pLoad->options->verbose )
+                {
+                    varlog_Printf( pLoad->options,
+                                   "VARCREATE: Creating variable: %s\n",
+                                   info[n].name );
+                }
+            }
+
+            rc = varcreate_fnSubmit( pLoad, info, n, results );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            for ( k = 0 ; k < n ; k++ )
+            {
+                if ( ( results[k] == EOK ) &&
+                     ( info[k].hVar != VAR_INVALID ) )
+                {
+                    if ( alias != NULL )
+                    {
+                        snprintf( index,
+                                  sizeof index,
+                                  "%" PRIu32,
+                                  first + (uint32_t)k );
+
+                        rc = varcreate_ProcessAlias( pLoad,
+                                                     &info[k],
+                                                     (cJSON *)alias,
+                                                     index,
+                                                     pLoad->index );
+                        if ( rc != EOK )
+                        {
+                            varlog_Printf( pLoad->options,
+                                           "Failed handler: alias\n" );
+                            varlog_Report( pLoad->options,
+                                           pLoad->filename,
+                                           pLoad->index,
+                                           info[k].name,
+                                           "alias",
+                                           rc );
+                            result = rc;
+                        }
+                    }
+                }
+                else
+                {
+                    varcreate_fnFailed( pLoad,
+                                        pLoad->index,
+                                        info[k].name,
+                                        results[k] );
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnRangeName                                                     */
+/*!
+    Build the name of one variable of a template
+
+    @param[in]
+        name
+            pointer to the template variable name
+
+    @param[in]
+        pRange
+            pointer to the index range of the template
+
+    @param[in]
+        index
+            index which replaces the range in the name
+
+    @param[out]
+        buf
+            pointer to a buffer of MAX_NAME_LEN+1 characters to store
+            the variable name in
+
+    @retval EOK - the name was built
+    @retval E2BIG - the name is too long
+
+==============================================================================*/
+static int varcreate_fnRangeName( const char *name,
+                                  const VarRange *pRange,
+                                  uint32_t index,
+                                  char *buf )
+{
+    int n;
+
+    n = snprintf( buf,
+                  MAX_NAME_LEN + 1,
+                  "%.*s%" PRIu32 "%s",
+                  (int)pRange->offset,
+                  name,
+                  index,
+                  &name[pRange->offset + pRange->len] );
+
+    return ( ( n >= 0 ) && ( n <= MAX_NAME_LEN ) ) ? EOK : E2BIG;
+}
+
+/*============================================================================*/
+/*  varcreate_fnSubstitute                                                    */
+/*!
+    Replace the index placeholders in an alias name
+
+    @param[in]
+        name
+            pointer to the NUL terminated alias name
+
+    @param[in]
+        index
+            pointer to the NUL terminated index which replaces each
+            {i} placeholder
+
+    @param[out]
+        buf
+            pointer to a buffer of MAX_NAME_LEN+1 characters to store
+            the alias name in
+
+    @retval EOK - the placeholders were replaced
+    @retval E2BIG - the alias name is too long
+
+==============================================================================*/
+static int varcreate_fnSubstitute( const char *name,
+                                   const char *index,
+                                   char *buf )
+{
+    int result = EOK;
+    size_t size = strlen( index );
+    size_t len = 0;
+    size_t n;
+    const char *p;
+
+    while ( ( result == EOK ) &&
+            ( ( p = strstr( name, VARCREATE_INDEX_PLACEHOLDER ) ) != NULL ) )
+    {
+        n = p - name;
+        if ( len + n + size <= MAX_NAME_LEN )
+        {
+            memcpy( &buf[len], name, n );
+            memcpy( &buf[len + n], index, size );
+            len += n + size;
+            name = p + sizeof( VARCREATE_INDEX_PLACEHOLDER ) - 1;
+        }
+        else
+        {
+            result = E2BIG;
+        }
+    }
+
+    n = strlen( name );
+    if ( ( result == EOK ) &&
+         ( len + n <= MAX_NAME_LEN ) )
+    {
+        memcpy( &buf[len], name, n + 1 );
+    }
+    else
+    {
+        result = E2BIG;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnSubmit                                                        */
+/*!
+    Submit populated variable definitions
+
+    The varcreate_fnSubmit function creates the variables on the
+    variable server, or adds them to the load's snapshot if the load
+    is compiling a snapshot.  Every entry is attempted.  A reconciling
+    load only creates the variables which do not exist yet.  The first
+    variable created is recorded in the load.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in,out]
+        pVarInfo
+            pointer to an array of n VarInfo objects
+
+    @param[in]
+        n
+            number of VarInfo objects in the pVarInfo array
+
+    @param[out]
+        results
+            pointer to an array of n per-variable result codes, or NULL
+
+    @retval EOK - all variables were submitted successfully
+    @retval other - the error code of the last variable which failed
+
+==============================================================================*/
+static int varcreate_fnSubmit( VarLoad *pLoad,
+                               VarInfo *pVarInfo,
+                               size_t n,
+                               int *results )
+{
+    int result = EOK;
+    size_t existing = 0;
+    size_t changed = 0;
+    size_t updated = 0;
+    uint64_t start;
+    size_t i;
+    int rc;
+
+    start = varcreate_fnClock( pLoad );
+
+    if ( pLoad->pSnapshot != NULL )
+    {
+        for ( i = 0 ; i < n ; i++ )
+        {
+            rc = varsnap_Add( pLoad->pSnapshot, &pVarInfo[i] );
+            if ( results != NULL )
+            {
+                results[i] = rc;
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+    else if ( pLoad->pCheck != NULL )
+    {
+        for ( i = 0 ; i < n ; i++ )
+        {
+            rc = varcheck_Add( pLoad->pCheck,
+                               pLoad->options,
+                               pLoad->filename,
+                               pLoad->index,
+                               &pVarInfo[i] );
+            if ( results != NULL )
+            {
+                results[i] = rc;
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+    else
+    {
+        if ( pLoad->options->reconcile == true )
+        {
+            /* only create the variables which do not exist yet */
+            result = varrecon_CreateBatch( pLoad->hVarServer,
+                                           pLoad->options,
+                                           pVarInfo,
+                                           n,
+                                           results,
+                                           &existing,
+                                           &changed,
+                                           &updated );
+        }
+        else
+        {
+            result = VARCREATE_CreateBatch( pLoad->hVarServer,
+                                            pVarInfo,
+                                            n,
+                                            results );
+        }
+
+        /* remember the first variable created from the file so the
+           cache can recognize the variable server next time */
+        for ( i = 0 ; ( pLoad->hFirst == VAR_INVALID ) && ( i < n ) ; i++ )
+        {
+            rc = ( results != NULL ) ? results[i] : result;
+            if ( ( rc == EOK ) &&
+                 ( pVarInfo[i].hVar != VAR_INVALID ) )
+            {
+                pLoad->hFirst = pVarInfo[i].hVar;
+                strcpy( pLoad->firstName, pVarInfo[i].name );
+            }
+        }
+
+        if ( pLoad->options->index != NULL )
+        {
+            for ( i = 0 ; i < n ; i++ )
+            {
+                rc = ( results != NULL ) ? results[i] : result;
+                if ( rc == EOK )
+                {
+                    varindex_Add( pLoad->options->index,
+                                  pVarInfo[i].name,
+                                  pVarInfo[i].hVar );
+                }
+            }
+        }
+    }
+
+    if ( pLoad->timing == true )
+    {
+        pLoad->stats.createTime += varcreate_fnElapsed( pLoad, start );
+
+        for ( i = 0 ; i < n ; i++ )
+        {
+            rc = ( results != NULL ) ? results[i] : result;
+            if ( ( rc == EOK ) &&
+                 ( pVarInfo[i].hVar != VAR_INVALID ) )
+            {
+                pLoad->stats.created++;
+            }
+            else
+            {
+                pLoad->stats.failed++;
+            }
+        }
+
+        /* the existing variables were not created */
+        pLoad->stats.created -= existing + changed + updated;
+        pLoad->stats.existing += existing;
+        pLoad->stats.changed += changed;
+        pLoad->stats.updated += updated;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnAddAlias                                                      */
+/*!
+    Add an alias to an alias list
+
+    The varcreate_fnAddAlias function appends a copy of the alias name
+    and the name of its config file to the alias list, growing the list
+    as required.
+
+    @param[in]
+        pAliases
+            pointer to the alias list
+
+    @param[in]
+        hVar
+            handle of the variable to be aliased
+
+    @param[in]
+        name
+            name of the alias
+
+    @param[in]
+        filename
+            name of the config file which defines the alias, or NULL
+
+    @param[in]
+        index
+            index of the variable definition in the input
+
+    @retval EOK - the alias was added to the list
+    @retval ENOMEM - memory allocation problem
+    @retval EINVAL - invalid arguments
+
+==============================================================================*/
+int varcreate_fnAddAlias( VarAliasList *pAliases,
+                          VAR_HANDLE hVar,
+                          const char *name,
+                          const char *filename,
+                          size_t index )
+{
+    int result = EINVAL;
+    VarAlias *p;
+    VarAliasOrigin *q;
+    size_t namelen;
+    size_t filelen;
+    size_t size;
+
+    if ( ( pAliases != NULL ) &&
+         ( name != NULL ) )
+    {
+        result = EOK;
+
+        if ( pAliases->count == pAliases->size )
+        {
+            size = ( pAliases->size == 0 ) ? 64 : pAliases->size * 2;
+            p = realloc( pAliases->aliases, size * sizeof( VarAlias ) );
+            if ( p != NULL )
+            {
+                pAliases->aliases = p;
+            }
+
+            q = realloc( pAliases->origins, size * sizeof( VarAliasOrigin ) );
+            if ( q != NULL )
+            {
+                pAliases->origins = q;
+            }
+
+            if ( ( p != NULL ) && ( q != NULL ) )
+            {
+                pAliases->size = size;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if ( result == EOK )
+        {
+            /* the file name is kept with the alias name, because the
+               aliases can outlive the load of the file */
+            namelen = strlen( name ) + 1;
+            filelen = ( filename != NULL ) ? strlen( filename ) + 1 : 0;
+
+            p = &pAliases->aliases[pAliases->count];
+            q = &pAliases->origins[pAliases->count];
+            p->hVar = hVar;
+            p->name = malloc( namelen + filelen );
+            if ( p->name != NULL )
+            {
+                memcpy( p->name, name, namelen );
+                q->filename = NULL;
+                q->index = index;
+
+                if ( filename != NULL )
+                {
+                    memcpy( &p->name[namelen], filename, filelen );
+                    q->filename = &p->name[namelen];
+                }
+
+                pAliases->count++;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnCreateAliases                                                 */
+/*!
+    Create all of the aliases in an alias list
+
+    The varcreate_fnCreateAliases function creates each alias in the
+    list, in the order in which they were added, and reports each alias
+    which could not be created against the config file which defined
+    it.  The file is also removed from the load cache, if there is one,
+    so that it is loaded again next time.  The aliases are submitted to
+    the variable server in batches.  The list is emptied.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create aliases for
+
+    @param[in]
+        pAliases
+            pointer to the alias list
+
+    @param[in]
+        options
+            pointer to the options of the load, which the aliases which
+            could not be created are reported to
+
+    @param[in]
+        pCache
+            pointer to the load cache which the files of the aliases
+            were recorded in, or NULL
+
+    @param[in,out]
+        pStats
+            pointer to statistics to add the alias creation time and
+            count to, or NULL
+
+    @retval EOK - all of the aliases were created
+    @retval EINVAL - invalid arguments
+    @retval other - one or more aliases could not be created
+
+==============================================================================*/
+int varcreate_fnCreateAliases( VARSERVER_HANDLE hVarServer,
+                               VarAliasList *pAliases,
+                               VarCreateOptions *options,
+                               VarCache *pCache,
+                               VarCreateStats *pStats )
+{
+    int result = EINVAL;
+    int results[VARCREATE_DEFAULT_BATCH_SIZE];
+    VarAlias *p;
+    VarAliasOrigin *q;
+    uint64_t start = 0;
+    size_t existing;
+    size_t base;
+    size_t n;
+    size_t i;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pAliases != NULL ) )
+    {
+        result = EOK;
+
+        if ( pStats != NULL )
+        {
+            start = varcreate_fnNow();
+        }
+
+        /* submit the aliases in batches, in the order they were added */
+        for ( base = 0 ; base < pAliases->count ; base += n )
+        {
+            p = &pAliases->aliases[base];
+            q = &pAliases->origins[base];
+            n = pAliases->count - base;
+            if ( n > VARCREATE_DEFAULT_BATCH_SIZE )
+            {
+                n = VARCREATE_DEFAULT_BATCH_SIZE;
+            }
+
+            existing = 0;
+            if ( ( options != NULL ) &&
+                 ( options->reconcile == true ) )
+            {
+                /* only create the aliases which do not exist yet */
+                rc = varrecon_CreateAliasBatch( hVarServer,
+                                                p,
+                                                n,
+                                                results,
+                                                &existing );
+            }
+            else
+            {
+                rc = VARCREATE_CreateAliasBatch( hVarServer, p, n, results );
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            for ( i = 0 ; i < n ; i++ )
+            {
+                if ( results[i] == EOK )
+                {
+                    if ( pStats != NULL )
+                    {
+                        pStats->aliased++;
+                    }
+
+                    if ( options != NULL )
+                    {
+                        varindex_Add( options->index, p[i].name, p[i].hVar );
+                    }
+                }
+                else
+                {
+                    varlog_Printf( options,
+                                   "Failed to create alias: %s\n",
+                                   p[i].name );
+                    varlog_Report( options,
+                                   q[i].filename,
+                                   q[i].index,
+                                   p[i].name,
+                                   "alias",
+                                   results[i] );
+
+                    if ( ( pCache != NULL ) &&
+                         ( q[i].filename != NULL ) )
+                    {
+                        /* load the file again next time */
+                        varcache_Remove( pCache, (char *)q[i].filename );
+                    }
+                }
+
+                free( p[i].name );
+                p[i].name = NULL;
+            }
+
+            if ( pStats != NULL )
+            {
+                /* the existing aliases were not created */
+                pStats->aliased -= existing;
+                pStats->existing += existing;
+            }
+        }
+
+        if ( pStats != NULL )
+        {
+            pStats->aliasTime += varcreate_fnNow() - start;
+        }
+
+        pAliases->count = 0;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnFreeAliases                                                   */
+/*!
+    Release the storage used by an alias list
+
+    @param[in]
+        pAliases
+            pointer to the alias list
+
+==============================================================================*/
+void varcreate_fnFreeAliases( VarAliasList *pAliases )
+{
+    size_t i;
+
+    if ( pAliases != NULL )
+    {
+        for ( i = 0 ; i < pAliases->count ; i++ )
+        {
+            free( pAliases->aliases[i].name );
+        }
+
+        free( pAliases->aliases );
+        free( pAliases->origins );
+        pAliases->aliases = NULL;
+        pAliases->origins = NULL;
+        pAliases->count = 0;
+        pAliases->size = 0;
+    }
+}
+
+/*============================================================================*/
+/*  varcreate_fnGetAttribute                                                  */
+/*!
+    Identify a variable attribute from its JSON key
+
+    The varcreate_fnGetAttribute function maps a JSON object key onto
+    its VarAttribute identifier.  The first character selects at most
+    two candidate attributes, so the key is compared at most twice.
+    Keys are matched case-insensitively, as cJSON_GetObjectItem does.
+
+    @param[in]
+        key
+            pointer to the NUL terminated JSON object key
+
+    @retval the attribute identifier
+    @retval VARATTR_UNKNOWN if the key is not a variable attribute
+
+==============================================================================*/
+static VarAttribute varcreate_fnGetAttribute( const char *key )
+{
+    VarAttribute attr = VARATTR_UNKNOWN;
+
+    if ( key != NULL )
+    {
+        switch( tolower( (unsigned char)key[0] ) )
+        {
+            case 'a':
+                attr = strcasecmp( key, "alias" ) == 0 ? VARATTR_ALIAS
+                                                       : VARATTR_UNKNOWN;
+                break;
+
+            case 'd':
+                attr = strcasecmp( key, "description" ) == 0
+                            ? VARATTR_DESCRIPTION
+                            : VARATTR_UNKNOWN;
+                break;
+
+            case 'f':
+                if ( strcasecmp( key, "fmt" ) == 0 )
+                {
+                    attr = VARATTR_FMT;
+                }
+                else if ( strcasecmp( key, "flags" ) == 0 )
+                {
+                    attr = VARATTR_FLAGS;
+                }
+                break;
+
+            case 'g':
+                attr = strcasecmp( key, "guid" ) == 0 ? VARATTR_GUID
+                                                      : VARATTR_UNKNOWN;
+                break;
+
+            case 'l':
+                attr = strcasecmp( key, "length" ) == 0 ? VARATTR_LENGTH
+                                                        : VARATTR_UNKNOWN;
+                break;
+
+            case 'n':
+                attr = strcasecmp( key, "name" ) == 0 ? VARATTR_NAME
+                                                      : VARATTR_UNKNOWN;
+                break;
+
+            case 'r':
+                attr = strcasecmp( key, "read" ) == 0 ? VARATTR_READ
+                                                      : VARATTR_UNKNOWN;
+                break;
+
+            case 's':
+                attr = strcasecmp( key, "shortname" ) == 0
+                            ? VARATTR_SHORTNAME
+                            : VARATTR_UNKNOWN;
+                break;
+
+            case 't':
+                if ( strcasecmp( key, "type" ) == 0 )
+                {
+                    attr = VARATTR_TYPE;
+                }
+                else if ( strcasecmp( key, "tags" ) == 0 )
+                {
+                    attr = VARATTR_TAGS;
+                }
+                break;
+
+            case 'v':
+                attr = strcasecmp( key, "value" ) == 0 ? VARATTR_VALUE
+                                                       : VARATTR_UNKNOWN;
+                break;
+
+            case 'w':
+                attr = strcasecmp( key, "write" ) == 0 ? VARATTR_WRITE
+                                                       : VARATTR_UNKNOWN;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return attr;
+}
+
+/*============================================================================*/
+/*  varcreate_fnApplyAttribute                                                */
+/*!
+    Apply a variable attribute to a VarInfo object
+
+    The varcreate_fnApplyAttribute function invokes the handler of the
+    specified attribute.  The type, flags and permission attributes
+    typically use a few distinct strings across all of the variables
+    of a load, so the values converted from them are memoized, and
+    each distinct string is only converted once.  Only successful
+    conversions are memoized, so errors are still reported for every
+    variable which uses an invalid string.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        attr
+            the attribute to apply
+
+    @param[in,out]
+        pVarInfo
+            pointer to the VarInfo object to update
+
+    @param[in]
+        item
+            pointer to the cJSON attribute item
+
+    @retval EOK - the attribute was applied
+    @retval other - the attribute handler failed
+
+==============================================================================*/
+static int varcreate_fnApplyAttribute( VarLoad *pLoad,
+                                       VarAttribute attr,
+                                       VarInfo *pVarInfo,
+                                       cJSON *item )
+{
+    int result;
+    const VarMemoValue *pMemo = NULL;
+    VarMemoValue value;
+    VarPermissions *pPerms = &pVarInfo->permissions;
+    bool memoize;
+
+    memoize = ( ( attr == VARATTR_TYPE ) ||
+                ( attr == VARATTR_FLAGS ) ||
+                ( attr == VARATTR_READ ) ||
+                ( attr == VARATTR_WRITE ) ) &&
+              ( cJSON_IsString( item ) ) &&
+              ( item->valuestring != NULL );
+
+    if ( memoize == true )
+    {
+        pMemo = varmemo_Find( &pLoad->memo, attr, item->valuestring );
+    }
+
+    if ( pMemo != NULL )
+    {
+        switch ( attr )
+        {
+            case VARATTR_TYPE:
+                pVarInfo->var.type = pMemo->type;
+                break;
+
+            case VARATTR_FLAGS:
+                pVarInfo->flags = pMemo->flags;
+                break;
+
+            case VARATTR_READ:
+                pPerms->nreads = pMemo->perms.n;
+                memcpy( pPerms->read,
+                        pMemo->perms.gids,
+                        pMemo->perms.n * sizeof( gid_t ) );
+                break;
+
+            default:
+                pPerms->nwrites = pMemo->perms.n;
+                memcpy( pPerms->write,
+                        pMemo->perms.gids,
+                        pMemo->perms.n * sizeof( gid_t ) );
+                break;
+        }
+
+        result = EOK;
+    }
+    else
+    {
+        result = handlers[attr].fn( pLoad->hVarServer, pVarInfo, item );
+        if ( ( result == EOK ) && ( memoize == true ) )
+        {
+            memset( &value, 0, sizeof( value ) );
+
+            switch ( attr )
+            {
+                case VARATTR_TYPE:
+                    value.type = pVarInfo->var.type;
+                    break;
+
+                case VARATTR_FLAGS:
+                    value.flags = pVarInfo->flags;
+                    break;
+
+                case VARATTR_READ:
+                    value.perms.n = pPerms->nreads;
+                    memcpy( value.perms.gids,
+                            pPerms->read,
+                            pPerms->nreads * sizeof( gid_t ) );
+                    break;
+
+                default:
+                    value.perms.n = pPerms->nwrites;
+                    memcpy( value.perms.gids,
+                            pPerms->write,
+                            pPerms->nwrites * sizeof( gid_t ) );
+                    break;
+            }
+
+            /* a full memo table only costs the conversion next time */
+            (void)varmemo_Add( &pLoad->memo, attr, item->valuestring, &value );
+        }
+    }
+
+    return result;
+}
+/*============================================================================*/
+/*  varcreate_fnQueue                                                         */
+/*!
+    Queue a variable built into a pipeline slot for creation
+
+    The varcreate_fnQueue function copies the string value and the alias
+    names of the variable into the pipeline entry, since the parsed JSON
+    tree they belong to is deleted before the variable is created, and
+    passes the variable to the creator thread.  A variable which could
+    not be built is queued too, so that its failure is reported in
+    input order.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in,out]
+        pVarInfo
+            pointer to the VarInfo object in the reserved slot
+
+    @param[in]
+        pEntry
+            pointer to the entry of the reserved slot
+
+    @param[in]
+        result
+            EOK if the variable was built successfully, otherwise
+            the error to report for the variable
+
+    @param[in]
+        alias
+            pointer to the cJSON 'alias' attribute, or NULL if the
+            variable has no aliases
+
+    @param[in]
+        index
+            template index to substitute into the alias names, or NULL
+
+    @retval EOK - the variable was queued
+
+==============================================================================*/
+static int varcreate_fnQueue( VarLoad *pLoad,
+                              VarInfo *pVarInfo,
+                              VarPipeEntry *pEntry,
+                              int result,
+                              const cJSON *alias,
+                              const char *index )
+{
+    const cJSON *first = NULL;
+    const cJSON *item;
+    bool array;
+    size_t vlen = 0;
+    size_t size;
+    size_t len;
+    char *p;
+
+    /* a single alias is a string, several are an array */
+    array = cJSON_IsArray( alias );
+    if ( array == true )
+    {
+        first = alias->child;
+    }
+    else if ( cJSON_IsString( alias ) )
+    {
+        first = alias;
+    }
+
+    if ( result == EOK )
+    {
+        if ( ( pVarInfo->var.type == VARTYPE_STR ) &&
+             ( pVarInfo->var.val.str != NULL ) )
+        {
+            vlen = strlen( pVarInfo->var.val.str ) + 1;
+        }
+
+        size = vlen;
+        for ( item = first ; item != NULL ; item = array ? item->next : NULL )
+        {
+            if ( item->valuestring != NULL )
+            {
+                size += strlen( item->valuestring ) + 1;
+            }
+        }
+
+        result = varpipe_Store( pEntry, size );
+    }
+
+    if ( result == EOK )
+    {
+        p = pEntry->buf;
+
+        if ( vlen > 0 )
+        {
+            memcpy( p, pVarInfo->var.val.str, vlen );
+            pVarInfo->var.val.str = p;
+            p += vlen;
+        }
+
+        pEntry->aliases = vlen;
+        pEntry->naliases = 0;
+
+        for ( item = first ; item != NULL ; item = array ? item->next : NULL )
+        {
+            if ( item->valuestring != NULL )
+            {
+                len = strlen( item->valuestring ) + 1;
+                memcpy( p, item->valuestring, len );
+                p += len;
+                pEntry->naliases++;
+            }
+        }
+
+        snprintf( pEntry->index,
+                  sizeof pEntry->index,
+                  "%s",
+                  ( index != NULL ) ? index : "" );
+
+        if ( pLoad->options->verbose )
+        {
+            varlog_Printf( pLoad->options,
+                           "VARCREATE: Creating variable: %s\n",
+                           pVarInfo->name );
+        }
+    }
+
+    pEntry->item = pLoad->index;
+    pEntry->result = result;
+    varpipe_Commit( pLoad->pPipe );
+
+    return EOK;
+}
+
+/*============================================================================*/
+/*  varcreate_fnPipeCreate                                                    */
+/*!
+    Create a run of variables taken from the pipeline
+
+    The varcreate_fnPipeCreate function is the pipeline callback, which
+    runs on the creator thread.  Each consecutive run of variables which
+    were built successfully is submitted together, and the aliases of
+    each variable which was created are created in turn.  Every failure
+    is reported in input order.
+
+    @param[in]
+        arg
+            pointer to the VarLoad object
+
+    @param[in,out]
+        info
+            pointer to the array of variables to create
+
+    @param[in]
+        entries
+            pointer to the array of pipeline entries of the variables
+
+    @param[out]
+        results
+            pointer to an array to store the creation results in
+
+    @param[in]
+        n
+            number of variables to create
+
+    @retval EOK - every variable and alias was created
+    @retval other - one or more variables or aliases could not be created
+
+==============================================================================*/
+static int varcreate_fnPipeCreate( void *arg,
+                                   VarInfo *info,
+                                   VarPipeEntry *entries,
+                                   int *results,
+                                   size_t n )
+{
+    int result = EOK;
+    VarLoad *pLoad = (VarLoad *)arg;
+    size_t i = 0;
+    size_t k;
+    size_t run;
+    int rc;
+
+    while ( i < n )
+    {
+        if ( entries[i].result != EOK )
+        {
+            /* the attributes which failed have been reported */
+            varlog_Printf( pLoad->options,
+                           "Failed to create variable: %s\n",
+                           info[i].name );
+            pLoad->stats.failed++;
+            result = entries[i].result;
+            i++;
+            continue;
+        }
+
+        run = 1;
+        while ( ( i + run < n ) && ( entries[i + run].result == EOK ) )
+        {
+            run++;
+        }
+
+        rc = varcreate_fnSubmit( pLoad, &info[i], run, &results[i] );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        for ( k = i ; k < i + run ; k++ )
+        {
+            if ( ( results[k] == EOK ) &&
+                 ( info[k].hVar != VAR_INVALID ) )
+            {
+                rc = varcreate_fnPipeAliases( pLoad, &info[k], &entries[k] );
+                if ( rc != EOK )
+                {
+                    varlog_Printf( pLoad->options, "Failed handler: alias\n" );
+                    varlog_Report( pLoad->options,
+                                   pLoad->filename,
+                                   entries[k].item,
+                                   info[k].name,
+                                   "alias",
+                                   rc );
+                    result = rc;
+                }
+            }
+            else
+            {
+                varcreate_fnFailed( pLoad,
+                                    entries[k].item,
+                                    info[k].name,
+                                    results[k] );
+            }
+        }
+
+        i += run;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnPipeAliases                                                   */
+/*!
+    Create the aliases of a variable taken from the pipeline
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        pVarInfo
+            pointer to the VarInfo object of the created variable
+
+    @param[in]
+        pEntry
+            pointer to the pipeline entry holding the alias names
+
+    @retval EOK - every alias was created
+    @retval other - one or more aliases could not be created
+
+==============================================================================*/
+static int varcreate_fnPipeAliases( VarLoad *pLoad,
+                                    VarInfo *pVarInfo,
+                                    const VarPipeEntry *pEntry )
+{
+    int result = EOK;
+    const char *index;
+    char *name;
+    size_t i;
+    int rc;
+
+    index = ( pEntry->index[0] != '\0' ) ? pEntry->index : NULL;
+    name = &pEntry->buf[pEntry->aliases];
+
+    for ( i = 0 ; i < pEntry->naliases ; i++ )
+    {
+        rc = varcreate_fnAlias( pLoad,
+                                pVarInfo->hVar,
+                                name,
+                                index,
+                                pEntry->item );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        name += strlen( name ) + 1;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnBatchInit                                                     */
+/*!
+    Initialize a variable batch
+
+    The varcreate_fnBatchInit function allocates the storage for a
+    batch of variables to be created together
+
+    @param[in]
+        pBatch
+            pointer to the batch to initialize
+
+    @param[in]
+        size
+            maximum number of variables in the batch
+
+    @retval EOK - the batch was initialized
+    @retval ENOMEM - memory allocation problem
+    @retval EINVAL - invalid arguments
+
+==============================================================================*/
+static int varcreate_fnBatchInit( VarBatch *pBatch, size_t size )
+{
+    int result = EINVAL;
+
+    if ( ( pBatch != NULL ) &&
+         ( size > 0 ) )
+    {
+        pBatch->size = size;
+        pBatch->count = 0;
+        pBatch->info = calloc( size, sizeof( VarInfo ) );
+        pBatch->results = calloc( size, sizeof( int ) );
+        pBatch->items = calloc( size, sizeof( size_t ) );
+        pBatch->aliases = calloc( size, sizeof( cJSON * ) );
+        pBatch->objects = calloc( size, sizeof( cJSON * ) );
+
+        if ( ( pBatch->info != NULL ) &&
+             ( pBatch->results != NULL ) &&
+             ( pBatch->items != NULL ) &&
+             ( pBatch->aliases != NULL ) &&
+             ( pBatch->objects != NULL ) )
+        {
+            result = EOK;
+        }
+        else
+        {
+            varcreate_fnBatchFree( pBatch );
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnBatchFlush                                                    */
+/*!
+    Submit a batch of variables to the variable server
+
+    The varcreate_fnBatchFlush function creates all of the variables
+    gathered in the batch, reports each variable which failed, and
+    creates the aliases of each variable which succeeded.  The batch
+    is empty on return, and any JSON objects owned by the batch have
+    been deleted.
+
+    If the load has a pipeline, the function instead waits until the
+    creator thread has created every queued variable.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object whose batch is to be submitted.
+            Nothing is done if the load does not have a batch.
+
+    @retval EOK - all variables in the batch were created successfully
+    @retval other - one or more variables or aliases could not be created
+
+==============================================================================*/
+static int varcreate_fnBatchFlush( VarLoad *pLoad )
+{
+    int result = EOK;
+    VarBatch *pBatch = pLoad->pBatch;
+    size_t i;
+    int rc;
+    VarInfo *pVarInfo;
+
+    if ( pLoad->pPipe != NULL )
+    {
+        /* wait for the creator thread to catch up */
+        result = varpipe_Drain( pLoad->pPipe );
+    }
+    else if ( ( pBatch != NULL ) &&
+              ( pBatch->count > 0 ) )
+    {
+        result = varcreate_fnSubmit( pLoad,
+                                     pBatch->info,
+                                     pBatch->count,
+                                     pBatch->results );
+
+        for ( i = 0 ; i < pBatch->count ; i++ )
+        {
+            pVarInfo = &pBatch->info[i];
+
+            if ( ( pBatch->results[i] == EOK ) &&
+                 ( pVarInfo->hVar != VAR_INVALID ) )
+            {
+                if ( pBatch->aliases[i] != NULL )
+                {
+                    rc = varcreate_ProcessAlias( pLoad,
+                                                 pVarInfo,
+                                                 (cJSON *)pBatch->aliases[i],
+                                                 NULL,
+                                                 pBatch->items[i] );
+                    if ( rc != EOK )
+                    {
+                        varlog_Printf( pLoad->options,
+                                       "Failed handler: alias\n" );
+                        varlog_Report( pLoad->options,
+                                       pLoad->filename,
+                                       pBatch->items[i],
+                                       pVarInfo->name,
+                                       "alias",
+                                       rc );
+                        result = rc;
+                    }
+                }
+            }
+            else
+            {
+                varcreate_fnFailed( pLoad,
+                                    pBatch->items[i],
+                                    pVarInfo->name,
+                                    pBatch->results[i] );
+            }
+
+            if ( pBatch->objects[i] != NULL )
+            {
+                /* the variable definition is no longer required */
+                varcreate_fnDelete( pLoad, pBatch->objects[i] );
+                pBatch->objects[i] = NULL;
+            }
+        }
+
+        pBatch->count = 0;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnBatchFree                                                     */
+/*!
+    Release the storage used by a variable batch
+
+    @param[in]
+        pBatch
+            pointer to the batch to release
+
+==============================================================================*/
+static void varcreate_fnBatchFree( VarBatch *pBatch )
+{
+    size_t i;
+
+    if ( pBatch != NULL )
+    {
+        free( pBatch->info );
+        pBatch->info = NULL;
+
+        free( pBatch->results );
+        pBatch->results = NULL;
+
+        free( pBatch->items );
+        pBatch->items = NULL;
+
+        free( pBatch->aliases );
+        pBatch->aliases = NULL;
+
+        if ( pBatch->objects != NULL )
+        {
+            for ( i = 0 ; i < pBatch->count ; i++ )
+            {
+                cJSON_Delete( pBatch->objects[i] );
+            }
+
+            free( pBatch->objects );
+            pBatch->objects = NULL;
+        }
+
+        pBatch->size = 0;
+        pBatch->count = 0;
+    }
+}
+
+/*============================================================================*/
+/*  varcreate_fnStreamFile                                                    */
+/*!
+    Create variables from a JSON config file which is scanned incrementally
+
+    The varcreate_fnStreamFile function reads the config file in blocks
+    and feeds each block to the incremental scanner, so that each
+    variable is created as soon as its definition has been read.
+    There is no limit on the size of the file.  A .json.gz or .json.zst
+    file is decompressed a block at a time as it is read.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOENT - unable to open the file
+    @retval ENOTSUP - cannot read this file type or compression
+    @retval EIO - read operation failed
+    @retval EBADMSG - the file is truncated or malformed
+
+==============================================================================*/
+static int varcreate_fnStreamFile( VarLoad *pLoad, char *filename )
+{
+    int result = EINVAL;
+    VarStream vs;
+    VarZip zip;
+    struct stat st;
+    char buf[VARCREATE_STREAM_BLOCK_SIZE];
+    uint64_t start;
+    ssize_t n;
+    int fd;
+    int rc;
+
+    fd = open( filename, O_RDONLY );
+    if ( fd != -1 )
+    {
+        if ( ( fstat( fd, &st ) == 0 ) &&
+             ( S_ISREG( st.st_mode ) ) )
+        {
+            result = varzip_Open( &zip, fd, varzip_Format( filename ) );
+            if ( result == EOK )
+            {
+                result = varstream_Init( &vs,
+                                         varcreate_fnStreamElement,
+                                         varcreate_fnStreamDefaults,
+                                         pLoad );
+                if ( result == EOK )
+                {
+                    do
+                    {
+                        start = varcreate_fnClock( pLoad );
+                        n = varzip_Read( &zip, buf, sizeof buf );
+                        pLoad->stats.readTime += varcreate_fnElapsed( pLoad,
+                                                                      start );
+                        if ( n > 0 )
+                        {
+                            pLoad->stats.bytes += n;
+                            (void)varstream_Feed( &vs, buf, n );
+                        }
+                    } while ( n > 0 );
+
+                    rc = varcreate_fnStreamClose( pLoad, &vs );
+                    result = ( n == -1 ) ? zip.result : rc;
+                }
+
+                varzip_Close( &zip );
+            }
+        }
+        else
+        {
+            /* invalid file type */
+            result = ENOTSUP;
+        }
+
+        close( fd );
+    }
+    else
+    {
+        /* file cannot be opened for reading */
+        result = ENOENT;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnStreamClose                                                   */
+/*!
+    Complete an incremental scan
+
+    The varcreate_fnStreamClose function checks that the scanned
+    document was complete, submits the remainder of the last batch,
+    and releases the defaults and the resources used by the scanner.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        pStream
+            pointer to the scanner state
+
+    @retval EOK - variable creation was successful
+    @retval EBADMSG - the document was truncated or malformed
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+static int varcreate_fnStreamClose( VarLoad *pLoad, VarStream *pStream )
+{
+    int result;
+    int rc;
+
+    rc = pStream->result;
+    result = varstream_Finish( pStream );
+    if ( ( result == EBADMSG ) &&
+         ( rc != EBADMSG ) )
+    {
+        /* the document itself, rather than one of its elements, is
+           malformed */
+        varlog_Printf( pLoad->options,
+                       "Malformed or truncated varcreate JSON\n" );
+        varlog_Report( pLoad->options,
+                       pLoad->filename,
+                       pLoad->index,
+                       NULL,
+                       NULL,
+                       EBADMSG );
+    }
+
+    /* submit the remainder of the last batch */
+    rc = varcreate_fnBatchFlush( pLoad );
+    if ( rc != EOK )
+    {
+        result = rc;
+    }
+
+    /* the defaults only apply to the file they were found in */
+    cJSON_Delete( pLoad->defaults );
+    pLoad->defaults = NULL;
+
+    varstream_Free( pStream );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnStreamElement                                                 */
+/*!
+    Process a variable definition extracted by the incremental scanner
+
+    The varcreate_fnStreamElement function is the scanner callback.
+    It parses a single element of the "vars" array and processes it.
+    If the variable was added to a batch, the parsed object is owned
+    by the batch until the batch has been submitted, otherwise it is
+    deleted immediately.
+
+    @param[in]
+        arg
+            pointer to the VarLoad object
+
+    @param[in]
+        element
+            pointer to the NUL terminated JSON text of the element, or
+            NULL if the element was too large to be extracted
+
+    @param[in]
+        len
+            length of the JSON text
+
+    @retval EOK - the variable was processed successfully
+    @retval EBADMSG - the element is not valid JSON
+    @retval E2BIG - the element was too large
+    @retval other - the variable could not be created
+
+==============================================================================*/
+static int varcreate_fnStreamElement( void *arg,
+                                      const char *element,
+                                      size_t len )
+{
+    int result = EINVAL;
+    VarLoad *pLoad = (VarLoad *)arg;
+    VarBatch *pBatch;
+    cJSON *var;
+    size_t count;
+
+    if ( ( pLoad != NULL ) &&
+         ( element != NULL ) )
+    {
+        pBatch = pLoad->pBatch;
+
+        var = varcreate_fnParse( pLoad, element, len );
+        if ( var != NULL )
+        {
+            count = ( pBatch != NULL ) ? pBatch->count : 0;
+
+            result = varcreate_fnProcessVar( pLoad, var );
+
+            if ( ( pBatch != NULL ) &&
+                 ( pBatch->count > count ) )
+            {
+                /* the variable is waiting in the batch and still
+                   refers to its JSON object */
+                pBatch->objects[count] = var;
+            }
+            else
+            {
+                varcreate_fnDelete( pLoad, var );
+            }
+        }
+        else
+        {
+            result = varcreate_fnMalformed( pLoad, element, len, EBADMSG );
+        }
+    }
+    else if ( pLoad != NULL )
+    {
+        /* the scanner discarded an element which was too large */
+        result = varcreate_fnMalformed( pLoad, NULL, 0, E2BIG );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnStreamDefaults                                                */
+/*!
+    Process the "defaults" object extracted by the incremental scanner
+
+    The varcreate_fnStreamDefaults function is the scanner callback for
+    the "defaults" object.  The object is parsed from the heap rather
+    than from the load's arena, since it is used by every variable of
+    the file, and the arena is reset after each variable.  The object
+    is deleted by varcreate_fnStreamClose.  As with the whole document
+    parser, only the first "defaults" object is used.
+
+    @param[in]
+        arg
+            pointer to the VarLoad object
+
+    @param[in]
+        element
+            pointer to the NUL terminated JSON text of the object, or
+            NULL if the object was too large to be extracted
+
+    @param[in]
+        len
+            length of the JSON text
+
+    @retval EOK - the defaults were stored
+    @retval EBADMSG - the object is not valid JSON
+    @retval E2BIG - the object was too large
+
+==============================================================================*/
+static int varcreate_fnStreamDefaults( void *arg,
+                                       const char *element,
+                                       size_t len )
+{
+    int result = EINVAL;
+    VarLoad *pLoad = (VarLoad *)arg;
+    VarArena *pPrevious;
+    cJSON *defaults;
+    uint64_t start;
+
+    if ( ( pLoad != NULL ) &&
+         ( element != NULL ) )
+    {
+        start = varcreate_fnClock( pLoad );
+
+        pPrevious = vararena_Select( NULL );
+        defaults = cJSON_ParseWithLength( element, len );
+        vararena_Select( pPrevious );
+
+        pLoad->stats.parseTime += varcreate_fnElapsed( pLoad, start );
+
+        if ( defaults == NULL )
+        {
+            varlog_Printf( pLoad->options,
+                           "Malformed defaults: %s\n",
+                           element );
+            varlog_Report( pLoad->options,
+                           pLoad->filename,
+                           pLoad->index,
+                           NULL,
+                           "defaults",
+                           EBADMSG );
+            result = EBADMSG;
+        }
+        else if ( pLoad->defaults == NULL )
+        {
+            pLoad->defaults = defaults;
+            result = EOK;
+        }
+        else
+        {
+            /* ignore any subsequent defaults */
+            cJSON_Delete( defaults );
+            result = EOK;
+        }
+    }
+    else if ( pLoad != NULL )
+    {
+        varlog_Printf( pLoad->options,
+                       "Variable definition exceeds %d bytes\n",
+                       VARSTREAM_MAX_ELEMENT_SIZE );
+        varlog_Report( pLoad->options,
+                       pLoad->filename,
+                       pLoad->index,
+                       NULL,
+                       "defaults",
+                       E2BIG );
+        result = E2BIG;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnParse                                                         */
+/*!
+    Parse JSON text into a cJSON tree allocated from the load's arena
+
+    The position at which parsing stopped is stored in the load's
+    parseEnd field, from which a parse error is reported.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        data
+            pointer to the JSON text, which need not be NUL terminated
+
+    @param[in]
+        len
+            number of bytes of JSON text
+
+    @retval pointer to the parsed tree, to be deleted with
+            varcreate_fnDelete
+    @retval NULL if the JSON text is not valid
+
+==============================================================================*/
+static cJSON *varcreate_fnParse( VarLoad *pLoad,
+                                 const char *data,
+                                 size_t len )
+{
+    VarArena *pPrevious;
+    cJSON *item;
+    uint64_t start;
+
+    VARPROBE_BEGIN( parse, pLoad->filename, len );
+
+    start = varcreate_fnClock( pLoad );
+
+    pPrevious = vararena_Select( &pLoad->arena );
+    pLoad->parseEnd = NULL;
+    item = cJSON_ParseWithLengthOpts( data, len, &pLoad->parseEnd, false );
+    vararena_Select( pPrevious );
+
+    pLoad->stats.parseTime += varcreate_fnElapsed( pLoad, start );
+
+    VARPROBE_END( parse, pLoad->filename, ( item != NULL ) ? EOK : EBADMSG );
+
+    if ( item != NULL )
+    {
+        pLoad->trees++;
+    }
+    else if ( pLoad->trees == 0 )
+    {
+        /* recover the partially parsed tree */
+        vararena_Reset( &pLoad->arena );
+    }
+
+    return item;
+}
+
+/*============================================================================*/
+/*  varcreate_fnMalformed                                                     */
+/*!
+    Report a variable definition which could not be parsed
+
+    The varcreate_fnMalformed function tells the user where parsing of
+    a definition stopped, or that the definition was too large, and
+    passes the failure to the report function of the load.  The
+    definition is skipped, so the load moves on to the next index.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        data
+            pointer to the JSON text which was parsed, which need not be
+            NUL terminated, or NULL if it was too large to be parsed
+
+    @param[in]
+        len
+            number of bytes of JSON text
+
+    @param[in]
+        result
+            EBADMSG if the text is not valid JSON, or E2BIG if it was
+            too large
+
+    @retval the result passed in
+
+==============================================================================*/
+static int varcreate_fnMalformed( VarLoad *pLoad,
+                                  const char *data,
+                                  size_t len,
+                                  int result )
+{
+    const char *error_ptr = pLoad->parseEnd;
+
+    if ( result == E2BIG )
+    {
+        varlog_Printf( pLoad->options,
+                       "Variable definition exceeds %d bytes\n",
+                       VARSTREAM_MAX_ELEMENT_SIZE );
+    }
+    else if ( ( data != NULL ) &&
+              ( error_ptr != NULL ) &&
+              ( error_ptr >= data ) &&
+              ( error_ptr < data + len ) )
+    {
+        /* indicate the error to the user.  The buffer is not
+           necessarily NUL terminated */
+        varlog_Printf( pLoad->options,
+                       "Error before: %.*s\n",
+                       (int)( len - ( error_ptr - data ) ),
+                       error_ptr );
+    }
+
+    varlog_Report( pLoad->options,
+                   pLoad->filename,
+                   pLoad->index,
+                   NULL,
+                   NULL,
+                   result );
+
+    pLoad->index++;
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnDelete                                                        */
+/*!
+    Delete a cJSON tree created by varcreate_fnParse
+
+    The memory of the tree is recovered in one step by resetting the
+    arena once no other parsed trees remain.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        item
+            pointer to the tree to delete
+
+==============================================================================*/
+static void varcreate_fnDelete( VarLoad *pLoad, cJSON *item )
+{
+    if ( item != NULL )
+    {
+        if ( pLoad->trees > 0 )
+        {
+            pLoad->trees--;
+        }
+
+        if ( pLoad->trees == 0 )
+        {
+            vararena_Reset( &pLoad->arena );
+        }
+    }
+}
+
+/*============================================================================*/
+/*  varcreate_fnLoadString                                                    */
+/*!
+    Create variables from a JSON configuration string as part of a load
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filedata
+            NUL terminated string containing variable creation JSON
+            config data
+
+    @retval EOK - variable creation was successful
+    @retval EBADMSG - the JSON config data is malformed
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+static int varcreate_fnLoadString( VarLoad *pLoad, const char *filedata )
+{
+    int result;
+    uint64_t start;
+    size_t len;
+
+    start = varcreate_fnClock( pLoad );
+
+    pLoad->index = 0;
+
+    len = strlen( filedata );
+    pLoad->stats.bytes += len;
+
+    result = varcreate_fnCreateFromBuffer( pLoad,
+                                           filedata,
+                                           len,
+                                           pLoad->options->stream );
+
+    varcreate_fnFileStats( pLoad, NULL, start );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcreate_fnNow                                                           */
+/*!
+    Read the monotonic clock
+
+    @retval the monotonic clock time in nanoseconds
+
 ==============================================================================*/
+uint64_t varcreate_fnNow( void )
+{
+    struct timespec ts;
 
-void __attribute__ ((constructor)) initLibrary(void) {
- //
- // Function that is called when the library is loaded
- //
-}
-void __attribute__ ((destructor)) cleanUpLibrary(void) {
- //
- // Function that is called when the library is »closed«.
- //
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
 }
 
 /*============================================================================*/
-/*  VARCREATE_CreateFromFile                                                  */
+/*  varcreate_fnLoadLines                                                     */
 /*!
-    Create variables from a JSON config file
-
-    The VARCREATE_CreateFromFile function dynamically creates varserver
-    variables at run-time by parsing a JSON configuration file.
+    Create variables from newline delimited JSON as part of a load
 
-    @param[in]
-        hVarServer
-            handle to the Variable Server to create variables for
+    The varcreate_fnLoadLines function reads the input in blocks and
+    processes each complete line as soon as it has been read.  Since a
+    JSON string cannot contain an unescaped newline, every newline ends
+    a variable definition.  The batch is submitted whenever a read
+    returns less than a full block, which indicates that the producer
+    has no more input ready.  The index of each definition is the
+    index of its line, counting blank lines, so a failure names the
+    line of the input it came from.
 
     @param[in]
-        filename
-            name of the variable creation JSON config file
+        pLoad
+            pointer to the VarLoad object
 
     @param[in]
-        options
-            pointer to the options used to modify the variable creation
-            behavior.
+        fd
+            file descriptor to read the variable definitions from
 
     @retval EOK - variable creation was successful
-    @retval EINVAL - invalid arguments
     @retval ENOMEM - memory allocation problem
+    @retval EIO - the input could not be read
+    @retval E2BIG - a line is too long
+    @retval other - one or more variables could not be created
 
 ==============================================================================*/
-int VARCREATE_CreateFromFile( VARSERVER_HANDLE hVarServer,
-                              char *filename,
-                              VarCreateOptions *options )
+static int varcreate_fnLoadLines( VarLoad *pLoad, int fd )
 {
-    int result = EINVAL;
-    char *filedata;
-    size_t filesize;
+    int result = EOK;
+    char buf[VARCREATE_STREAM_BLOCK_SIZE];
+    char *line;
+    char *p;
+    char *end;
+    char *nl;
+    size_t len = 0;
+    size_t n;
+    ssize_t rc;
+    uint64_t start;
+    size_t lines = 0;
+    bool overflow = false;
+    int err;
+
+    /* one extra byte for the NUL terminator */
+    line = malloc( VARSTREAM_MAX_ELEMENT_SIZE + 1 );
+    if ( line != NULL )
+    {
+        do
+        {
+            start = varcreate_fnClock( pLoad );
+            rc = read( fd, buf, sizeof buf );
+            pLoad->stats.readTime += varcreate_fnElapsed( pLoad, start );
+
+            if ( rc > 0 )
+            {
+                pLoad->stats.bytes += rc;
+
+                p = buf;
+                end = buf + rc;
+                while ( p < end )
+                {
+                    nl = memchr( p, '\n', end - p );
+                    n = ( ( nl != NULL ) ? nl : end ) - p;
+
+                    if ( len + n > VARSTREAM_MAX_ELEMENT_SIZE )
+                    {
+                        /* discard the rest of the line */
+                        overflow = true;
+                    }
+                    else if ( overflow == false )
+                    {
+                        memcpy( &line[len], p, n );
+                        len += n;
+                    }
+
+                    if ( nl != NULL )
+                    {
+                        /* report each definition by its line */
+                        pLoad->index = lines++;
+
+                        if ( overflow == true )
+                        {
+                            result = varcreate_fnMalformed( pLoad,
+                                                            NULL,
+                                                            0,
+                                                            E2BIG );
+                        }
+                        else
+                        {
+                            err = varcreate_fnLoadLine( pLoad, line, len );
+                            if ( err != EOK )
+                            {
+                                result = err;
+                            }
+                        }
+
+                        overflow = false;
+                        len = 0;
+                        p = nl + 1;
+                    }
+                    else
+                    {
+                        p = end;
+                    }
+                }
+
+                if ( (size_t)rc < sizeof buf )
+                {
+                    /* the producer has paused, so do not hold variables
+                       or messages back waiting for more */
+                    err = varcreate_fnBatchFlush( pLoad );
+                    if ( err != EOK )
+                    {
+                        result = err;
+                    }
+
+                    varlog_Flush();
+                }
+            }
+            else if ( ( rc == -1 ) && ( errno != EINTR ) )
+            {
+                result = EIO;
+            }
+        } while ( ( rc > 0 ) || ( ( rc == -1 ) && ( errno == EINTR ) ) );
+
+        /* the last line need not be terminated */
+        pLoad->index = lines;
+
+        if ( overflow == true )
+        {
+            result = varcreate_fnMalformed( pLoad, NULL, 0, E2BIG );
+        }
+        else if ( len > 0 )
+        {
+            err = varcreate_fnLoadLine( pLoad, line, len );
+            if ( err != EOK )
+            {
+                result = err;
+            }
+        }
 
-    /* read the varcreate file */
-    result = varcreate_fnReadFile( filename, &filedata, &filesize );
-    if( result == EOK )
+        /* submit the remainder of the last batch */
+        err = varcreate_fnBatchFlush( pLoad );
+        if ( err != EOK )
+        {
+            result = err;
+        }
+
+        free( line );
+    }
+    else
     {
-        /* parse the JSON data read from the file */
-        result = VARCREATE_CreateFromString(hVarServer, filedata, options);
+        result = ENOMEM;
     }
 
     return result;
 }
 
-/*==========================================================================*/
-/*  VARCREATE_CreateFromString                                              */
+/*============================================================================*/
+/*  varcreate_fnLoadLine                                                      */
 /*!
-    Create variables from a string containing JSON configuration
-
-    The VARCREATE_CreateFromString function dynamically creates varserver
-    variables at run-time by parsing a JSON configuration string.
+    Create the variable described by a line of newline delimited JSON
 
     @param[in]
-        hVarServer
-            handle to the Variable Server to create variables for
+        pLoad
+            pointer to the VarLoad object
 
     @param[in]
-        filedata
-            string containing variable creation JSON config data
+        line
+            pointer to the line, with room for a NUL terminator
 
     @param[in]
-        options
-            pointer to the options used to modify the variable creation
-            behavior.
+        len
+            length of the line, excluding the newline
 
-    @retval EOK - variable creation was successful
-    @retval EINVAL - invalid arguments
+    @retval EOK - the variable was processed, or the line was blank
+    @retval EBADMSG - the line is not valid JSON
+    @retval other - the variable could not be created
 
-============================================================================*/
-int VARCREATE_CreateFromString( VARSERVER_HANDLE hVarServer,
-                                const char *filedata,
-                                VarCreateOptions *options )
+==============================================================================*/
+static int varcreate_fnLoadLine( VarLoad *pLoad, char *line, size_t len )
 {
-    int result = EINVAL;
-    cJSON *vardata;
-    const char *error_ptr;
+    int result = EOK;
+    size_t i;
 
-    vardata = cJSON_Parse( filedata );
-    if( vardata != NULL )
-    {
-        /* process the variable data */
-        result = varcreate_fnProcessVarData( hVarServer, vardata, options );
+    line[len] = '\0';
 
-        /* delete the vardata JSON object now that we are done with it */
-        cJSON_Delete( vardata );
-    }
-    else
+    for ( i = 0 ; i < len ; i++ )
     {
-        /* parsing failed, find out where */
-        error_ptr = cJSON_GetErrorPtr();
-        if( error_ptr != NULL )
+        if ( !isspace( (unsigned char)line[i] ) )
         {
-            /* indicate the error to the user */
-            fprintf(stderr, "Error before: %s\n", error_ptr );
-            result = EBADMSG;
+            /* the line is not blank */
+            result = varcreate_fnStreamElement( pLoad, line, len );
+            break;
         }
     }
 
@@ -271,233 +4817,154 @@ int VARCREATE_CreateFromString( VARSERVER_HANDLE hVarServer,
 }
 
 /*============================================================================*/
-/*  varcreate_fnProcessVarData                                                */
+/*  varcreate_fnClock                                                         */
 /*!
-    Process the variables specified in the varcreate JSON
-
-    The varcreate_fnProcessVarData function processes the varcreates JSON
-    object specified in vardata, iterates through the variables in the
-    JSON array and creates them via a call to the variable server.
-
-    @param[in]
-        hVarServer
-            handle to the Variable Server to create variables for
+    Start timing a phase of a variable load
 
-    @param[in]
-        vardata
-            pointer to a cJSON object containing the variable data
+    The clock is only read if the load is gathering statistics.
 
     @param[in]
-        options
-            pointer to the options used to modify the variable creation
-            behavior.
+        pLoad
+            pointer to the VarLoad object
 
-    @retval EOK - variable creation was successful
-    @retval EINVAL - invalid arguments
-    @retval ENOMEM - memory allocation problem
+    @retval the start time to pass to varcreate_fnElapsed
 
 ==============================================================================*/
-static int varcreate_fnProcessVarData( VARSERVER_HANDLE hVarServer,
-                                       cJSON *vardata,
-                                       VarCreateOptions *options )
+static uint64_t varcreate_fnClock( VarLoad *pLoad )
 {
-    int result = EINVAL;
-    const cJSON *desc;
-    const cJSON *vars;
-    const cJSON *var;
-    int rc;
+    return ( pLoad->timing == true ) ? varcreate_fnNow() : 0;
+}
 
-    if( ( vardata != NULL ) &&
-        ( options != NULL ) )
-    {
-        /* get the description of the variables being created */
-        desc = cJSON_GetObjectItemCaseSensitive( vardata,
-                                                 "description" );
+/*============================================================================*/
+/*  varcreate_fnElapsed                                                       */
+/*!
+    Finish timing a phase of a variable load
 
-        /* not doing anything with desc right now */
-        (void)desc;
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
 
-        /* get a pointer to the array of variables to be created */
-        vars = cJSON_GetObjectItemCaseSensitive( vardata, "vars" );
-        if( ( vars != NULL ) &&
-            ( cJSON_IsArray( vars ) ) )
-        {
-            result = EOK;
+    @param[in]
+        start
+            start time returned by varcreate_fnClock
 
-            /* iterate through each variable to be created */
-            cJSON_ArrayForEach( var, vars )
-            {
-                /* process each variable one at a time */
-                rc = varcreate_fnProcessVar( hVarServer, var, options );
-                if( rc != EOK )
-                {
-                    /* variable creation failed */
-                    result = rc;
-                }
-            }
-        }
-    }
+    @retval the time elapsed since the start time in nanoseconds
+    @retval 0 if the load is not gathering statistics
 
-    return result;
+==============================================================================*/
+static uint64_t varcreate_fnElapsed( VarLoad *pLoad, uint64_t start )
+{
+    return ( pLoad->timing == true ) ? varcreate_fnNow() - start : 0;
 }
 
 /*============================================================================*/
-/*  varcreate_fnProcessVar                                                    */
+/*  varcreate_fnFileStats                                                     */
 /*!
-    Process a variable specified in the varcreate JSON
+    Report the statistics of a file once it has been loaded
 
-    The varcreate_fnProcessVar function processes a single variable
-    in the specified JSON object.
-}    @param[in]
-        hVarServer
-            handle to the Variable Server to create variables for
+    The varcreate_fnFileStats function adds the statistics of the file
+    to the statistics of the load options, passes them to the fileStats
+    function if there is one, and clears them ready for the next file.
+    The buffered messages of the file are written out first.
 
     @param[in]
-        vardata
-            pointer to a cJSON object containing the variable data
+        pLoad
+            pointer to the VarLoad object
 
     @param[in]
-        options
-            pointer to the options used to modify the variable creation
-            behavior.
+        filename
+            name of the file which was loaded, or NULL for a string
 
-    @retval EOK - variable creation was successful
-    @retval EINVAL - invalid arguments
-    @retval ENOMEM - memory allocation problem
+    @param[in]
+        start
+            time at which the file load started
 
 ==============================================================================*/
-static int varcreate_fnProcessVar( VARSERVER_HANDLE hVarServer,
-                                   const cJSON *vardata,
-                                   VarCreateOptions *options )
+static void varcreate_fnFileStats( VarLoad *pLoad,
+                                   const char *filename,
+                                   uint64_t start )
 {
-    cJSON *item;
-    int i = 0;
-    int rc;
-    VarInfo variableInfo;
-    int result = EINVAL;
-    char buf[MAX_NAME_LEN+1];
-    size_t len;
+    VarCreateOptions *options = pLoad->options;
 
-    JSONHandler handlers[] =
-        {
-            { "name", varcreate_ProcessName },
-            { "guid", varcreate_ProcessGUID },
-            { "type", varcreate_ProcessType },
-            { "fmt", varcreate_ProcessFormat },
-            { "length", varcreate_ProcessLength },
-            { "value", varcreate_ProcessValue },
-            { "tags", varcreate_ProcessTags },
-            { "flags", varcreate_ProcessFlags },
-            { "description", varcreate_ProcessDescription },
-            { "shortname", varcreate_ProcessShortName },
-            { "read", varcreate_ProcessReadPermissions },
-            { "write", varcreate_ProcessWritePermissions },
-            { NULL, NULL }
-        };
-
-    if( ( hVarServer != NULL ) &&
-        ( vardata != NULL ) &&
-        ( cJSON_IsObject( vardata ) ) &&
-        ( options != NULL ) )
-    {
-        /* clear the Variable Info object */
-        memset( &variableInfo, 0, sizeof( VarInfo ) );
+    /* write out the messages of the input together, ahead of its
+       statistics */
+    varlog_Flush();
 
-        /* assume success until something fails */
-        result = EOK;
+    if ( pLoad->timing == true )
+    {
+        pLoad->stats.files = 1;
+        pLoad->stats.totalTime = varcreate_fnElapsed( pLoad, start );
 
-        /* process the attributes */
-        while( handlers[i].attribute != NULL )
+        if ( pLoad->tier == VARLOAD_TIER_CRITICAL )
         {
-            /* get the JSON object item */
-            item = cJSON_GetObjectItem( vardata, handlers[i].attribute );
-            if( item != NULL )
-            {
-                /* process the object item */
-                rc = handlers[i].fn( hVarServer, &variableInfo, item );
-                if( rc != EOK )
-                {
-                    printf("Failed handler: %s\n", handlers[i].attribute );
-                    result = rc;
-                }
-            }
-
-            /* move to the next JSON attribute */
-            i++;
+            /* the file is counted, and reported, by the pass which
+               creates the rest of its variables */
+            pLoad->stats.files = 0;
+            pLoad->stats.skipped = 0;
+            pLoad->stats.bytes = 0;
         }
 
-        if ( options->flags )
+        varcreate_fnAddStats( options, &pLoad->stats );
+
+        if ( ( options->fileStats != NULL ) &&
+             ( pLoad->tier != VARLOAD_TIER_CRITICAL ) )
         {
-            variableInfo.flags |= (options->flags);
+            options->fileStats( filename, &pLoad->stats );
         }
 
-        if ( ( variableInfo.var.type == VARTYPE_STR ) &&
-             ( variableInfo.var.len > 0 ) )
-        {
-            /* increment the length by 1 to account for the NUL terminator */
-            variableInfo.var.len++;
+        memset( &pLoad->stats, 0, sizeof( VarCreateStats ) );
+    }
+}
 
-            if ( variableInfo.var.val.str != NULL )
-            {
-                len = strlen( variableInfo.var.val.str );
-                if ( len >= variableInfo.var.len )
-                {
-                    printf( "Value too large for variable: %s\n",
-                            variableInfo.name );
-                    result = E2BIG;
-                }
-            }
-        }
+/*============================================================================*/
+/*  varcreate_fnAddStats                                                      */
+/*!
+    Add statistics to the statistics of the load options
 
-        variableInfo.instanceID = options->instanceID;
+    The statistics of the options may be shared by several threads,
+    so they are updated under a lock.
 
-        if ( options->prefix != NULL )
-        {
-            /* prepend the variable name with the variable prefix */
-            snprintf( buf,
-                      MAX_NAME_LEN+1,
-                      "%s%s",
-                      options->prefix,
-                      variableInfo.name );
-            strcpy( variableInfo.name, buf );
-        }
+    @param[in]
+        options
+            pointer to the options whose statistics are to be updated.
+            Nothing is done if the options have no statistics.
 
-        if( result == EOK )
-        {
-            /* create the variable */
-            if ( options->verbose )
-            {
-                printf("VARCREATE: Creating variable: %s\n", variableInfo.name);
-            }
+    @param[in]
+        pStats
+            pointer to the statistics to add
 
-            result = VARSERVER_CreateVar( hVarServer, &variableInfo );
-            if ( ( result == EOK ) && ( variableInfo.hVar != VAR_INVALID ) )
-            {
-                /* check for aliases */
-                item = cJSON_GetObjectItem( vardata, "alias" );
-                if ( item != NULL )
-                {
-                    result = varcreate_ProcessAlias( hVarServer,
-                                                     &variableInfo,
-                                                     item );
-                    if ( result != EOK )
-                    {
-                        printf("Failed handler: alias\n" );
-                    }
-                }
-            }
-            else
-            {
-                printf("Failed to create variable: %s\n", variableInfo.name );
-            }
-        }
-        else
-	{
-            printf("Failed to create variable: %s\n", variableInfo.name );
-        }
-    }
+==============================================================================*/
+void varcreate_fnAddStats( VarCreateOptions *options,
+                           const VarCreateStats *pStats )
+{
+    VarCreateStats *pTotal;
 
-    return result;
+    if ( ( options != NULL ) &&
+         ( options->stats != NULL ) &&
+         ( pStats != NULL ) )
+    {
+        pTotal = options->stats;
+
+        pthread_mutex_lock( &statsLock );
+
+        pTotal->readTime += pStats->readTime;
+        pTotal->parseTime += pStats->parseTime;
+        pTotal->handlerTime += pStats->handlerTime;
+        pTotal->createTime += pStats->createTime;
+        pTotal->aliasTime += pStats->aliasTime;
+        pTotal->totalTime += pStats->totalTime;
+        pTotal->files += pStats->files;
+        pTotal->skipped += pStats->skipped;
+        pTotal->created += pStats->created;
+        pTotal->failed += pStats->failed;
+        pTotal->aliased += pStats->aliased;
+        pTotal->existing += pStats->existing;
+        pTotal->changed += pStats->changed;
+        pTotal->updated += pStats->updated;
+        pTotal->bytes += pStats->bytes;
+
+        pthread_mutex_unlock( &statsLock );
+    }
 }
 
 /*============================================================================*/
@@ -640,7 +5107,6 @@ static int varcreate_ProcessType( VARSERVER_HANDLE hVarServer,
                                   cJSON *type )
 {
     int result = EINVAL;
-    char buf[64];
 
     /* hVarServer unused */
     (void)hVarServer;
@@ -651,12 +5117,10 @@ static int varcreate_ProcessType( VARSERVER_HANDLE hVarServer,
         if( ( cJSON_IsString( type ) ) &&
             ( type->valuestring != NULL ) )
         {
-            result = VARSERVER_TypeNameToType( type->valuestring,
-                                               &pVarInfo->var.type );
-
-            VARSERVER_TypeToTypeName( pVarInfo->var.type,
-                                      buf,
-                                      sizeof(buf) );
+            /* an unknown type leaves the variable type unset, which
+               the variable server rejects */
+            (void)VARSERVER_TypeNameToType( type->valuestring,
+                                            &pVarInfo->var.type );
 
             result = EOK;
         }
@@ -1038,19 +5502,9 @@ static int varcreate_ProcessFlags( VARSERVER_HANDLE hVarServer,
         if( ( cJSON_IsString( flags ) ) &&
             ( flags->valuestring != NULL ) )
         {
+            /* a failure is reported with the rest of the variable */
             result = VARSERVER_StrToFlags( flags->valuestring,
                                            &pVarInfo->flags );
-            if ( result != EOK )
-            {
-                fprintf(stderr,
-                        "Failed to convert flag string: %s, "
-                        "flag value: %" PRIu32 ", "
-                        "result: %d %s\n",
-                        flags->valuestring,
-                        pVarInfo->flags,
-                        result,
-                        strerror( result ) );
-            }
         }
     }
 
@@ -1063,41 +5517,48 @@ static int varcreate_ProcessFlags( VARSERVER_HANDLE hVarServer,
     Process variable aliases from the varcreate JSON object
 
     The varcreate_fnProcessAlias function processes the variable
-    aliases from the varcreate JSON object
+    aliases from the varcreate JSON object.  Every alias is attempted
+    even if an earlier alias could not be created.
 
     @param[in]
-        hVarServer
-            handle to the Variable Server to create variables for
+        pLoad
+            pointer to the VarLoad object
 
     @param[in]
         pVarInfo
-            pointer to the VarInfo object where the flags will be stored
+            pointer to the VarInfo object of the created variable
 
     @param[in]
         aliases
             pointer to the cJSON object attribute 'alias' to be processed
 
-    @retval EOK - variable flags were parsed successfully
-    @retval E2BIG - the variable flags were too long
+    @param[in]
+        index
+            index of a template variable, which replaces each {i}
+            placeholder in the alias names, or NULL
+
+    @param[in]
+        item
+            index of the variable definition in the input
+
+    @retval EOK - the aliases were created successfully
     @retval EINVAL - invalid arguments
-    @retval ENOENT - one or more flag names were invalid
+    @retval other - one or more aliases could not be created
 
 ==============================================================================*/
-static int varcreate_ProcessAlias( VARSERVER_HANDLE hVarServer,
+static int varcreate_ProcessAlias( VarLoad *pLoad,
                                    VarInfo *pVarInfo,
-                                   cJSON *alias )
+                                   cJSON *alias,
+                                   const char *index,
+                                   size_t item )
 {
     int result = EINVAL;
-    int n;
-    int i;
-    cJSON *item;
+    cJSON *element;
     VAR_HANDLE hVar;
     int rc;
 
-    /* hVarServer unused */
-    (void)hVarServer;
-
-    if( ( pVarInfo != NULL ) &&
+    if( ( pLoad != NULL ) &&
+        ( pVarInfo != NULL ) &&
         ( alias != NULL ) )
     {
         hVar = pVarInfo->hVar;
@@ -1105,20 +5566,25 @@ static int varcreate_ProcessAlias( VARSERVER_HANDLE hVarServer,
         if( ( cJSON_IsString( alias ) ) &&
             ( alias->valuestring != NULL ) )
         {
-            result = VAR_Alias( hVarServer, hVar, alias->valuestring, NULL );
+            result = varcreate_fnAlias( pLoad,
+                                        hVar,
+                                        alias->valuestring,
+                                        index,
+                                        item );
         }
         else if ( cJSON_IsArray( alias ) )
         {
-            n = cJSON_GetArraySize( alias );
-            for ( i = 0 ; i < n ; i ++ )
-            {
-                result = EOK;
+            result = EOK;
 
-                item = cJSON_GetArrayItem( alias, i );
-                if ( ( item != NULL ) &&
-                     ( item->valuestring != NULL ) )
+            cJSON_ArrayForEach( element, alias )
+            {
+                if ( element->valuestring != NULL )
                 {
-                    rc = VAR_Alias( hVarServer, hVar, item->valuestring, NULL );
+                    rc = varcreate_fnAlias( pLoad,
+                                            hVar,
+                                            element->valuestring,
+                                            index,
+                                            item );
                     if ( rc != EOK )
                     {
                         result = rc;
@@ -1262,6 +5728,7 @@ static int varcreate_ProcessWritePermissions( VARSERVER_HANDLE hVarServer,
     @retval EINVAL - invalid arguments
     @retval ENOMEM - memory allocation problem
     @retval ENOTSUP - cannot read this file type
+    @retval EFBIG - the file is too large to read into memory
     @retval ENOENT - unable to stat or open the file
 
 ==============================================================================*/
@@ -1333,7 +5800,7 @@ static int varcreate_fnReadFile( char *filename,
     @retval EOK - the file content was read into memory
     @retval EINVAL - invalid arguments
     @retval ENOMEM - memory allocation problem
-    @retval ENOTSUP - invalid file size
+    @retval EFBIG - the file is too large to read into memory
     @retval ENOENT - unable to open the file for reading
     @retval EIO - read operation failed
 
@@ -1388,8 +5855,8 @@ static int varcreate_fnGetFileData( char *filename,
         }
         else
         {
-            /* invalid file size */
-            result = ENOTSUP;
+            /* the file is too large to read into memory */
+            result = EFBIG;
         }
     }
 
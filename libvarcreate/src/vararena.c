@@ -0,0 +1,326 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file vararena.c
+
+    Variable Creation parse arena
+
+    The parse arena supplies the memory for the cJSON trees built while
+    loading a config file.  Instead of one heap allocation and one free
+    per node and string, the tree is carved out of a few large blocks
+    which are recovered together once the tree has been deleted.
+
+    The cJSON allocation hooks are global, so the hooks installed by the
+    library consult an arena selected by the calling thread.  When the
+    thread has no arena selected, the hooks fall through to malloc and
+    free, so each thread, and each worker of a parallel load, uses only
+    its own arena.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cJSON.h"
+#include "vararena.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! alignment of each allocation from the arena */
+#define VARARENA_ALIGN      ( sizeof( max_align_t ) )
+
+/*! size of the block header, rounded up to the allocation alignment */
+#define VARARENA_HEADER_SIZE \
+    ( ( sizeof( VarArenaBlock ) + VARARENA_ALIGN - 1 ) & ~( VARARENA_ALIGN - 1 ) )
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! arena selected by the calling thread, or NULL to use the heap */
+static _Thread_local VarArena *selected;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static void *vararena_fnMalloc( size_t size );
+
+static void vararena_fnFree( void *ptr );
+
+static void *vararena_fnAlloc( VarArena *pArena, size_t size );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  vararena_Init                                                             */
+/*!
+    Initialize an empty arena
+
+    No memory is allocated until the first allocation from the arena.
+
+    @param[in]
+        pArena
+            pointer to the arena to initialize
+
+==============================================================================*/
+void vararena_Init( VarArena *pArena )
+{
+    pArena->blocks = NULL;
+}
+
+/*============================================================================*/
+/*  vararena_Reset                                                            */
+/*!
+    Recover all of the memory allocated from an arena
+
+    The vararena_Reset function releases every block except the most
+    recently allocated standard sized block, which is kept for reuse
+    so repeated parses do not return to the heap at all.  Nothing which
+    was allocated from the arena may be used after it has been reset.
+
+    @param[in]
+        pArena
+            pointer to the arena to reset
+
+==============================================================================*/
+void vararena_Reset( VarArena *pArena )
+{
+    VarArenaBlock *pBlock = pArena->blocks;
+    VarArenaBlock *pKeep = NULL;
+    VarArenaBlock *pNext;
+
+    while ( pBlock != NULL )
+    {
+        pNext = pBlock->next;
+
+        if ( ( pKeep == NULL ) &&
+             ( pBlock->size == VARARENA_BLOCK_SIZE - VARARENA_HEADER_SIZE ) )
+        {
+            pKeep = pBlock;
+            pKeep->next = NULL;
+            pKeep->used = 0;
+        }
+        else
+        {
+            free( pBlock );
+        }
+
+        pBlock = pNext;
+    }
+
+    pArena->blocks = pKeep;
+}
+
+/*============================================================================*/
+/*  vararena_Free                                                             */
+/*!
+    Release all of the memory owned by an arena
+
+    @param[in]
+        pArena
+            pointer to the arena to release
+
+==============================================================================*/
+void vararena_Free( VarArena *pArena )
+{
+    VarArenaBlock *pNext;
+
+    while ( pArena->blocks != NULL )
+    {
+        pNext = pArena->blocks->next;
+        free( pArena->blocks );
+        pArena->blocks = pNext;
+    }
+}
+
+/*============================================================================*/
+/*  vararena_Select                                                           */
+/*!
+    Select the arena used by cJSON in the calling thread
+
+    @param[in]
+        pArena
+            pointer to the arena to allocate cJSON trees from, or NULL
+            to allocate them from the heap
+
+    @retval the previously selected arena, so it can be restored
+
+==============================================================================*/
+VarArena *vararena_Select( VarArena *pArena )
+{
+    VarArena *pPrevious = selected;
+
+    selected = pArena;
+
+    return pPrevious;
+}
+
+/*============================================================================*/
+/*  vararena_InstallHooks                                                     */
+/*!
+    Install the arena aware cJSON allocation hooks
+
+    The vararena_InstallHooks function is called once when the library
+    is loaded, before any thread can be parsing.
+
+==============================================================================*/
+void vararena_InstallHooks( void )
+{
+    cJSON_Hooks hooks;
+
+    hooks.malloc_fn = vararena_fnMalloc;
+    hooks.free_fn = vararena_fnFree;
+
+    cJSON_InitHooks( &hooks );
+}
+
+/*============================================================================*/
+/*  vararena_fnMalloc                                                         */
+/*!
+    cJSON allocation hook
+
+    @param[in]
+        size
+            number of bytes to allocate
+
+    @retval pointer to the allocated memory
+    @retval NULL if the memory could not be allocated
+
+==============================================================================*/
+static void *vararena_fnMalloc( size_t size )
+{
+    return ( selected != NULL ) ? vararena_fnAlloc( selected, size )
+                                : malloc( size );
+}
+
+/*============================================================================*/
+/*  vararena_fnFree                                                           */
+/*!
+    cJSON free hook
+
+    Memory allocated from an arena is recovered when the arena is reset,
+    so nothing is done while an arena is selected.
+
+    @param[in]
+        ptr
+            pointer to the memory to free
+
+==============================================================================*/
+static void vararena_fnFree( void *ptr )
+{
+    if ( selected == NULL )
+    {
+        free( ptr );
+    }
+}
+
+/*============================================================================*/
+/*  vararena_fnAlloc                                                          */
+/*!
+    Allocate memory from an arena
+
+    The vararena_fnAlloc function carves the allocation from the current
+    block, starting a new block when the current one is full.
+    Allocations larger than a standard block get a block of their own.
+
+    @param[in]
+        pArena
+            pointer to the arena
+
+    @param[in]
+        size
+            number of bytes to allocate
+
+    @retval pointer to the allocated memory
+    @retval NULL if the memory could not be allocated
+
+==============================================================================*/
+static void *vararena_fnAlloc( VarArena *pArena, size_t size )
+{
+    VarArenaBlock *pBlock = pArena->blocks;
+    void *p = NULL;
+    size_t blocksize;
+
+    size = ( size + VARARENA_ALIGN - 1 ) & ~( VARARENA_ALIGN - 1 );
+
+    if ( ( pBlock == NULL ) ||
+         ( pBlock->size - pBlock->used < size ) )
+    {
+        blocksize = VARARENA_BLOCK_SIZE - VARARENA_HEADER_SIZE;
+        if ( size > blocksize )
+        {
+            blocksize = size;
+        }
+
+        pBlock = malloc( VARARENA_HEADER_SIZE + blocksize );
+        if ( pBlock == NULL )
+        {
+            /* out of memory */
+        }
+        else if ( ( size > VARARENA_BLOCK_SIZE - VARARENA_HEADER_SIZE ) &&
+                  ( pArena->blocks != NULL ) )
+        {
+            /* keep allocating from the current block after this one */
+            pBlock->size = blocksize;
+            pBlock->used = 0;
+            pBlock->next = pArena->blocks->next;
+            pArena->blocks->next = pBlock;
+        }
+        else
+        {
+            pBlock->size = blocksize;
+            pBlock->used = 0;
+            pBlock->next = pArena->blocks;
+            pArena->blocks = pBlock;
+        }
+    }
+
+    if ( pBlock != NULL )
+    {
+        p = (char *)pBlock + VARARENA_HEADER_SIZE + pBlock->used;
+        pBlock->used += size;
+    }
+
+    return p;
+}
+
+/*! @}
+ * end of libvarcreate group */
@@ -0,0 +1,84 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARARENA_H
+#define VARARENA_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stddef.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! size of the blocks the arena allocates from the heap */
+#define VARARENA_BLOCK_SIZE             ( 64 * 1024 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! a block of memory owned by an arena */
+typedef struct _VarArenaBlock
+{
+    /*! pointer to the next block in the arena */
+    struct _VarArenaBlock *next;
+
+    /*! number of bytes available in the block */
+    size_t size;
+
+    /*! number of bytes allocated from the block */
+    size_t used;
+
+} VarArenaBlock;
+
+/*! The VarArena object is a bump allocator for the nodes and strings of
+    parsed cJSON trees.  Individual allocations are never freed; all of
+    the memory is recovered at once when the arena is reset.  An arena
+    must only be used by one thread at a time */
+typedef struct _VarArena
+{
+    /*! list of blocks, most recently allocated first */
+    VarArenaBlock *blocks;
+
+} VarArena;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+void vararena_Init( VarArena *pArena );
+
+void vararena_Reset( VarArena *pArena );
+
+void vararena_Free( VarArena *pArena );
+
+VarArena *vararena_Select( VarArena *pArena );
+
+void vararena_InstallHooks( void );
+
+#endif
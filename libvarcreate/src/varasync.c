@@ -0,0 +1,440 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+/*============================================================================*/
+/*!
+@file varasync.c
+
+    Asynchronous Variable Creation
+
+    An asynchronous load creates the variables of a config file on a
+    worker thread owned by the library, with its own connection to the
+    variable server, so the application can continue its initialization
+    while the variables are being created.  The application is told
+    when the load is complete by a callback, and may wait for the load
+    to complete.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+
+/*==============================================================================
+        Type Definitions
+==============================================================================*/
+
+/*! state of an asynchronous load */
+struct _VarCreateAsync
+{
+    /*! worker thread identifier */
+    pthread_t thread;
+
+    /*! the worker's own connection to the variable server */
+    VARSERVER_HANDLE hVarServer;
+
+    /*! private copy of the name of the config file */
+    char *filename;
+
+    /*! private copy of the variable creation options */
+    VarCreateOptions options;
+
+    /*! statistics of the load */
+    VarCreateStats stats;
+
+    /*! function to call when the load is complete, or NULL */
+    VarCreateDoneFn fn;
+
+    /*! opaque argument to pass to the completion function */
+    void *arg;
+
+    /*! nobody will wait for the load, so the worker releases it */
+    bool detached;
+
+    /*! result of the load */
+    int result;
+
+};
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int varasync_fnCopy( VARCREATE_ASYNC hAsync,
+                            char *filename,
+                            VarCreateOptions *options );
+
+static int varasync_fnStart( VARCREATE_ASYNC hAsync );
+
+static void *varasync_fnWorker( void *arg );
+
+static void varasync_fnFree( VARCREATE_ASYNC hAsync );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  VARCREATE_CreateFromFileAsync                                             */
+/*!
+    Create variables from a JSON configuration file in the background
+
+    The VARCREATE_CreateFromFileAsync function starts loading a varcreate
+    config file on a worker thread, with its own connection to the
+    variable server, and returns without waiting for the variables to
+    be created.
+
+    The options, file name, prefix, cache name and instance identifiers
+    are copied, so they do not need to outlive the call.  The statistics of the load are always
+    gathered, and are passed to the completion function and returned
+    by VARCREATE_Wait instead of being accumulated in options->stats.
+    The completion function, and the fileStats function of the options,
+    are called on the worker thread.
+
+    If phAsync is NULL, the load is detached and releases its own
+    resources once the completion function returns.  Otherwise the
+    application must call VARCREATE_Wait with the returned handle.
+
+    @param[in]
+        filename
+            name of the config file to load
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @param[in]
+        fn
+            function to call when the load is complete, or NULL
+
+    @param[in]
+        arg
+            opaque argument to pass to the completion function
+
+    @param[out]
+        phAsync
+            location to store the handle of the load, or NULL to
+            detach the load
+
+    @retval EOK - the load was started
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation failure
+    @retval ENOTCONN - no connection to the variable server
+    @retval other - the worker thread could not be started
+
+==============================================================================*/
+int VARCREATE_CreateFromFileAsync( char *filename,
+                                   VarCreateOptions *options,
+                                   VarCreateDoneFn fn,
+                                   void *arg,
+                                   VARCREATE_ASYNC *phAsync )
+{
+    int result = EINVAL;
+    VARCREATE_ASYNC hAsync;
+
+    if ( ( filename != NULL ) &&
+         ( options != NULL ) )
+    {
+        result = ENOMEM;
+
+        hAsync = calloc( 1, sizeof( struct _VarCreateAsync ) );
+        if ( hAsync != NULL )
+        {
+            hAsync->fn = fn;
+            hAsync->arg = arg;
+            hAsync->detached = ( phAsync == NULL );
+
+            result = varasync_fnCopy( hAsync, filename, options );
+            if ( result == EOK )
+            {
+                hAsync->hVarServer = VARSERVER_Open();
+                result = ( hAsync->hVarServer != NULL ) ? EOK : ENOTCONN;
+            }
+
+            if ( result == EOK )
+            {
+                result = varasync_fnStart( hAsync );
+            }
+
+            if ( result == EOK )
+            {
+                if ( phAsync != NULL )
+                {
+                    *phAsync = hAsync;
+                }
+            }
+            else
+            {
+                varasync_fnFree( hAsync );
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_Wait                                                            */
+/*!
+    Wait for an asynchronous load to complete
+
+    The VARCREATE_Wait function blocks until the load started by
+    VARCREATE_CreateFromFileAsync is complete, and its completion
+    function has returned, then releases the load.  The handle must
+    not be used again.
+
+    @param[in]
+        hAsync
+            handle of the load returned by VARCREATE_CreateFromFileAsync
+
+    @param[out]
+        stats
+            location to store the statistics of the load, or NULL
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval other - the result of the load
+
+==============================================================================*/
+int VARCREATE_Wait( VARCREATE_ASYNC hAsync, VarCreateStats *stats )
+{
+    int result = EINVAL;
+
+    if ( ( hAsync != NULL ) &&
+         ( hAsync->detached == false ) )
+    {
+        result = pthread_join( hAsync->thread, NULL );
+        if ( result == EOK )
+        {
+            result = hAsync->result;
+
+            if ( stats != NULL )
+            {
+                *stats = hAsync->stats;
+            }
+
+            varasync_fnFree( hAsync );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varasync_fnCopy                                                           */
+/*!
+    Take private copies of the arguments of an asynchronous load
+
+    @param[in]
+        hAsync
+            handle of the load
+
+    @param[in]
+        filename
+            name of the config file to load
+
+    @param[in]
+        options
+            pointer to the options to copy
+
+    @retval EOK - the arguments were copied
+    @retval ENOMEM - memory allocation failure
+
+==============================================================================*/
+static int varasync_fnCopy( VARCREATE_ASYNC hAsync,
+                            char *filename,
+                            VarCreateOptions *options )
+{
+    int result = ENOMEM;
+
+    hAsync->options = *options;
+    hAsync->options.prefix = NULL;
+    hAsync->options.cache = NULL;
+    hAsync->options.instances = NULL;
+    hAsync->options.stats = &hAsync->stats;
+
+    hAsync->filename = strdup( filename );
+    if ( hAsync->filename != NULL )
+    {
+        result = EOK;
+
+        if ( options->prefix != NULL )
+        {
+            hAsync->options.prefix = strdup( options->prefix );
+            result = ( hAsync->options.prefix != NULL ) ? EOK : ENOMEM;
+        }
+
+        if ( ( result == EOK ) &&
+             ( options->cache != NULL ) )
+        {
+            hAsync->options.cache = strdup( options->cache );
+            result = ( hAsync->options.cache != NULL ) ? EOK : ENOMEM;
+        }
+
+        if ( ( result == EOK ) &&
+             ( options->instances != NULL ) &&
+             ( options->instanceCount > 0 ) )
+        {
+            hAsync->options.instances = malloc( options->instanceCount *
+                                                sizeof( uint32_t ) );
+            if ( hAsync->options.instances != NULL )
+            {
+                memcpy( hAsync->options.instances,
+                        options->instances,
+                        options->instanceCount * sizeof( uint32_t ) );
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varasync_fnStart                                                          */
+/*!
+    Start the worker thread of an asynchronous load
+
+    A detached load is started in the detached state, since its worker
+    may release the load before pthread_create returns.
+
+    @param[in]
+        hAsync
+            handle of the load
+
+    @retval EOK - the worker was started
+    @retval other - the worker thread could not be started
+
+==============================================================================*/
+static int varasync_fnStart( VARCREATE_ASYNC hAsync )
+{
+    int result;
+    pthread_attr_t attr;
+
+    result = pthread_attr_init( &attr );
+    if ( result == EOK )
+    {
+        if ( hAsync->detached == true )
+        {
+            result = pthread_attr_setdetachstate( &attr,
+                                                  PTHREAD_CREATE_DETACHED );
+        }
+
+        if ( result == EOK )
+        {
+            result = pthread_create( &hAsync->thread,
+                                     &attr,
+                                     varasync_fnWorker,
+                                     hAsync );
+        }
+
+        pthread_attr_destroy( &attr );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varasync_fnWorker                                                         */
+/*!
+    Asynchronous load worker thread
+
+    The varasync_fnWorker function loads the config file on the worker's
+    own variable server connection, closes the connection and calls the
+    completion function.  A detached load is then released.
+
+    @param[in]
+        arg
+            handle of the load
+
+    @retval NULL
+
+==============================================================================*/
+static void *varasync_fnWorker( void *arg )
+{
+    VARCREATE_ASYNC hAsync = (VARCREATE_ASYNC)arg;
+
+    hAsync->result = VARCREATE_CreateFromFile( hAsync->hVarServer,
+                                               hAsync->filename,
+                                               &hAsync->options );
+
+    VARSERVER_Close( hAsync->hVarServer );
+    hAsync->hVarServer = NULL;
+
+    if ( hAsync->fn != NULL )
+    {
+        hAsync->fn( hAsync->arg, hAsync->result, &hAsync->stats );
+    }
+
+    if ( hAsync->detached == true )
+    {
+        varasync_fnFree( hAsync );
+    }
+
+    return NULL;
+}
+
+/*============================================================================*/
+/*  varasync_fnFree                                                           */
+/*!
+    Release an asynchronous load
+
+    @param[in]
+        hAsync
+            handle of the load
+
+==============================================================================*/
+static void varasync_fnFree( VARCREATE_ASYNC hAsync )
+{
+    if ( hAsync->hVarServer != NULL )
+    {
+        VARSERVER_Close( hAsync->hVarServer );
+    }
+
+    free( hAsync->options.prefix );
+    free( hAsync->options.cache );
+    free( hAsync->options.instances );
+    free( hAsync->filename );
+    free( hAsync );
+}
+
+/*! @}
+ * end of libvarcreate group */
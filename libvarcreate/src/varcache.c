@@ -0,0 +1,717 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varcache.c
+
+    Variable Creation load cache
+
+    The load cache records each config file which was loaded
+    successfully, keyed by its path, together with a hash of its content
+    and of the options it was loaded with.  The cache also records the
+    name and handle of the first variable created from the file.  A file
+    is only skipped if its hash is unchanged and the variable server
+    still resolves that name to the same handle, so a restarted variable
+    server causes every file to be loaded again.
+
+    The cache is stored in a text state file with one line per file:
+
+    <hash> <handle> <variable name> <path>
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varcache.h"
+#include "varlog.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! FNV-1a 64-bit offset basis */
+#define VARCACHE_FNV_OFFSET     ( 14695981039346656037ULL )
+
+/*! FNV-1a 64-bit prime */
+#define VARCACHE_FNV_PRIME      ( 1099511628211ULL )
+
+/*! size of the blocks read when hashing a file */
+#define VARCACHE_BLOCK_SIZE     ( 16 * 1024 )
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static uint64_t varcache_fnHash( uint64_t hash, const void *data, size_t len );
+
+static VarCacheEntry *varcache_fnFind( VarCache *pCache, char *path );
+
+static int varcache_fnAdd( VarCache *pCache,
+                           char *path,
+                           uint64_t hash,
+                           VAR_HANDLE hVar,
+                           char *name );
+
+static int varcache_fnSave( VarCache *pCache );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varcache_Open                                                             */
+/*!
+    Open a load cache
+
+    The varcache_Open function reads the cache entries from the state
+    file.  A missing state file is treated as an empty cache, and lines
+    which cannot be parsed are ignored.
+
+    @param[in]
+        pCache
+            pointer to the VarCache object to initialize
+
+    @param[in]
+        filename
+            name of the state file
+
+    @param[in]
+        options
+            pointer to the options of the load using the cache
+
+    @retval EOK - the cache was opened
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varcache_Open( VarCache *pCache,
+                   char *filename,
+                   const VarCreateOptions *options )
+{
+    int result = EINVAL;
+    FILE *fp;
+    char *line = NULL;
+    size_t linelen = 0;
+    ssize_t n;
+    uint64_t hash;
+    VAR_HANDLE hVar;
+    char *name;
+    char *path;
+    char *p;
+
+    if ( ( pCache != NULL ) &&
+         ( filename != NULL ) )
+    {
+        memset( pCache, 0, sizeof( VarCache ) );
+        pCache->filename = filename;
+        pCache->options = options;
+        pthread_mutex_init( &pCache->lock, NULL );
+
+        result = EOK;
+
+        fp = fopen( filename, "r" );
+        if ( fp != NULL )
+        {
+            while ( ( result == EOK ) &&
+                    ( ( n = getline( &line, &linelen, fp ) ) > 0 ) )
+            {
+                if ( line[n-1] == '\n' )
+                {
+                    line[n-1] = '\0';
+                }
+
+                /* split the line into its hash, handle, name and path */
+                hash = strtoull( line, &p, 16 );
+                hVar = ( *p == ' ' ) ? strtoul( p + 1, &p, 10 ) : 0;
+                name = ( *p == ' ' ) ? p + 1 : NULL;
+                path = ( name != NULL ) ? strchr( name, ' ' ) : NULL;
+
+                if ( ( hVar != VAR_INVALID ) &&
+                     ( path != NULL ) &&
+                     ( path[1] != '\0' ) )
+                {
+                    *path++ = '\0';
+                    result = varcache_fnAdd( pCache,
+                                             path,
+                                             hash,
+                                             hVar,
+                                             name );
+                }
+            }
+
+            free( line );
+            fclose( fp );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_Hash                                                             */
+/*!
+    Calculate the cache hash of a config file
+
+    The varcache_Hash function calculates the FNV-1a hash of the file
+    content, followed by the options which change the variables the
+    file creates, so loading the same file with a different prefix,
+    instance identifier or flags is not mistaken for a repeated load.
+
+    @param[in]
+        path
+            path of the config file
+
+    @param[in]
+        options
+            pointer to the options the file is being loaded with
+
+    @param[out]
+        pHash
+            pointer to a location to store the hash
+
+    @retval EOK - the hash was calculated
+    @retval ENOENT - the file could not be opened
+    @retval EIO - the file could not be read
+
+==============================================================================*/
+int varcache_Hash( char *path, VarCreateOptions *options, uint64_t *pHash )
+{
+    int result = ENOENT;
+    uint64_t hash = VARCACHE_FNV_OFFSET;
+    char buf[VARCACHE_BLOCK_SIZE];
+    ssize_t n;
+    int fd;
+
+    fd = open( path, O_RDONLY );
+    if ( fd != -1 )
+    {
+        do
+        {
+            n = read( fd, buf, sizeof buf );
+            if ( n > 0 )
+            {
+                hash = varcache_fnHash( hash, buf, n );
+            }
+        } while ( ( n > 0 ) ||
+                  ( ( n == -1 ) && ( errno == EINTR ) ) );
+
+        close( fd );
+
+        if ( options->prefix != NULL )
+        {
+            hash = varcache_fnHash( hash,
+                                    options->prefix,
+                                    strlen( options->prefix ) + 1 );
+        }
+
+        hash = varcache_fnHash( hash,
+                                &options->instanceID,
+                                sizeof( options->instanceID ) );
+        hash = varcache_fnHash( hash,
+                                &options->flags,
+                                sizeof( options->flags ) );
+
+        *pHash = hash;
+        result = ( n == -1 ) ? EIO : EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_Check                                                            */
+/*!
+    Check whether a config file can be skipped
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server the file is being loaded into
+
+    @param[in]
+        path
+            path of the config file
+
+    @param[in]
+        hash
+            cache hash of the config file
+
+    @retval true - the file is unchanged and its variables still exist
+    @retval false - the file must be loaded
+
+==============================================================================*/
+bool varcache_Check( VarCache *pCache,
+                     VARSERVER_HANDLE hVarServer,
+                     char *path,
+                     uint64_t hash )
+{
+    bool result = false;
+    VarCacheEntry *pEntry;
+
+    pthread_mutex_lock( &pCache->lock );
+
+    pEntry = varcache_fnFind( pCache, path );
+    if ( ( pEntry != NULL ) &&
+         ( pEntry->hash == hash ) &&
+         ( pEntry->hVar != VAR_INVALID ) )
+    {
+        /* make sure this is the same variable server instance */
+        result = ( VAR_FindByName( hVarServer, pEntry->name ) == pEntry->hVar );
+    }
+
+    pthread_mutex_unlock( &pCache->lock );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_Update                                                           */
+/*!
+    Record a config file which was loaded successfully
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @param[in]
+        path
+            path of the config file
+
+    @param[in]
+        hash
+            cache hash of the config file
+
+    @param[in]
+        hVar
+            handle of the first variable created from the file
+
+    @param[in]
+        name
+            name of the first variable created from the file
+
+    @retval EOK - the cache was updated
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varcache_Update( VarCache *pCache,
+                     char *path,
+                     uint64_t hash,
+                     VAR_HANDLE hVar,
+                     char *name )
+{
+    int result = ENOMEM;
+    VarCacheEntry *pEntry;
+    char *p;
+
+    pthread_mutex_lock( &pCache->lock );
+
+    pEntry = varcache_fnFind( pCache, path );
+    if ( pEntry != NULL )
+    {
+        p = strdup( name );
+        if ( p != NULL )
+        {
+            free( pEntry->name );
+            pEntry->name = p;
+            pEntry->hash = hash;
+            pEntry->hVar = hVar;
+            result = EOK;
+        }
+    }
+    else
+    {
+        result = varcache_fnAdd( pCache, path, hash, hVar, name );
+    }
+
+    if ( result == EOK )
+    {
+        pCache->modified = true;
+    }
+
+    pthread_mutex_unlock( &pCache->lock );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_Remove                                                           */
+/*!
+    Forget a config file, so it is loaded again next time
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @param[in]
+        path
+            path of the config file
+
+==============================================================================*/
+void varcache_Remove( VarCache *pCache, char *path )
+{
+    VarCacheEntry *pEntry;
+
+    pthread_mutex_lock( &pCache->lock );
+
+    pEntry = varcache_fnFind( pCache, path );
+    if ( pEntry != NULL )
+    {
+        free( pEntry->path );
+        free( pEntry->name );
+        *pEntry = pCache->entries[--pCache->count];
+        pCache->modified = true;
+    }
+
+    pthread_mutex_unlock( &pCache->lock );
+}
+
+/*============================================================================*/
+/*  varcache_Sync                                                             */
+/*!
+    Write a load cache to its state file
+
+    The varcache_Sync function writes the cache to its state file if it
+    has changed since it was read or last written, so a long running
+    load can keep the state file up to date without closing the cache.
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @retval EOK - the state file is up to date
+    @retval EIO - the state file could not be written
+
+==============================================================================*/
+int varcache_Sync( VarCache *pCache )
+{
+    int result = EOK;
+
+    pthread_mutex_lock( &pCache->lock );
+
+    if ( pCache->modified == true )
+    {
+        result = varcache_fnSave( pCache );
+        if ( result == EOK )
+        {
+            pCache->modified = false;
+        }
+    }
+
+    pthread_mutex_unlock( &pCache->lock );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_Close                                                            */
+/*!
+    Close a load cache
+
+    The varcache_Close function writes the cache to its state file if
+    it has changed, and releases the cache.  The state file is replaced
+    atomically.
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @retval EOK - the cache was closed
+    @retval EIO - the state file could not be written
+
+==============================================================================*/
+int varcache_Close( VarCache *pCache )
+{
+    int result = EOK;
+    size_t i;
+
+    if ( pCache->modified == true )
+    {
+        result = varcache_fnSave( pCache );
+    }
+
+    for ( i = 0 ; i < pCache->count ; i++ )
+    {
+        free( pCache->entries[i].path );
+        free( pCache->entries[i].name );
+    }
+
+    free( pCache->entries );
+    pCache->entries = NULL;
+    pCache->count = 0;
+    pCache->size = 0;
+
+    pthread_mutex_destroy( &pCache->lock );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_fnHash                                                           */
+/*!
+    Add data to an FNV-1a hash
+
+    @param[in]
+        hash
+            hash of the preceding data
+
+    @param[in]
+        data
+            pointer to the data to add
+
+    @param[in]
+        len
+            number of bytes to add
+
+    @retval the updated hash
+
+==============================================================================*/
+static uint64_t varcache_fnHash( uint64_t hash, const void *data, size_t len )
+{
+    const unsigned char *p = (const unsigned char *)data;
+
+    while ( len-- > 0 )
+    {
+        hash = ( hash ^ *p++ ) * VARCACHE_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/*============================================================================*/
+/*  varcache_fnFind                                                           */
+/*!
+    Find the cache entry for a config file
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @param[in]
+        path
+            path of the config file
+
+    @retval pointer to the cache entry
+    @retval NULL if the file is not in the cache
+
+==============================================================================*/
+static VarCacheEntry *varcache_fnFind( VarCache *pCache, char *path )
+{
+    VarCacheEntry *pEntry = NULL;
+    size_t i;
+
+    for ( i = 0 ; ( pEntry == NULL ) && ( i < pCache->count ) ; i++ )
+    {
+        if ( strcmp( pCache->entries[i].path, path ) == 0 )
+        {
+            pEntry = &pCache->entries[i];
+        }
+    }
+
+    return pEntry;
+}
+
+/*============================================================================*/
+/*  varcache_fnAdd                                                            */
+/*!
+    Append an entry to the cache
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @param[in]
+        path
+            path of the config file
+
+    @param[in]
+        hash
+            cache hash of the config file
+
+    @param[in]
+        hVar
+            handle of the first variable created from the file
+
+    @param[in]
+        name
+            name of the first variable created from the file
+
+    @retval EOK - the entry was added
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varcache_fnAdd( VarCache *pCache,
+                           char *path,
+                           uint64_t hash,
+                           VAR_HANDLE hVar,
+                           char *name )
+{
+    int result = EOK;
+    VarCacheEntry *p;
+    size_t size;
+
+    if ( pCache->count == pCache->size )
+    {
+        size = ( pCache->size == 0 ) ? 16 : pCache->size * 2;
+        p = realloc( pCache->entries, size * sizeof( VarCacheEntry ) );
+        if ( p != NULL )
+        {
+            pCache->entries = p;
+            pCache->size = size;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    if ( result == EOK )
+    {
+        p = &pCache->entries[pCache->count];
+        p->path = strdup( path );
+        p->name = strdup( name );
+        p->hash = hash;
+        p->hVar = hVar;
+
+        if ( ( p->path != NULL ) &&
+             ( p->name != NULL ) )
+        {
+            pCache->count++;
+        }
+        else
+        {
+            free( p->path );
+            free( p->name );
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcache_fnSave                                                           */
+/*!
+    Write the cache to its state file
+
+    The cache is written to a temporary file which then replaces the
+    state file, so an interrupted write never leaves a partial cache.
+
+    @param[in]
+        pCache
+            pointer to the VarCache object
+
+    @retval EOK - the state file was written
+    @retval ENOMEM - memory allocation problem
+    @retval EIO - the state file could not be written
+
+==============================================================================*/
+static int varcache_fnSave( VarCache *pCache )
+{
+    int result = ENOMEM;
+    VarCacheEntry *p;
+    char *tmpname;
+    size_t len;
+    size_t i;
+    FILE *fp;
+    int rc;
+
+    len = strlen( pCache->filename ) + sizeof( ".tmp" );
+    tmpname = malloc( len );
+    if ( tmpname != NULL )
+    {
+        snprintf( tmpname, len, "%s.tmp", pCache->filename );
+
+        result = EIO;
+
+        fp = fopen( tmpname, "w" );
+        if ( fp != NULL )
+        {
+            for ( i = 0 ; i < pCache->count ; i++ )
+            {
+                p = &pCache->entries[i];
+                fprintf( fp,
+                         "%016" PRIx64 " %u %s %s\n",
+                         p->hash,
+                         (unsigned int)p->hVar,
+                         p->name,
+                         p->path );
+            }
+
+            rc = ferror( fp );
+            if ( fclose( fp ) != 0 )
+            {
+                rc = EIO;
+            }
+
+            if ( ( rc == 0 ) &&
+                 ( rename( tmpname, pCache->filename ) == 0 ) )
+            {
+                result = EOK;
+            }
+            else
+            {
+                unlink( tmpname );
+            }
+        }
+
+        if ( result != EOK )
+        {
+            varlog_Printf( pCache->options,
+                           "Unable to write cache: %s\n",
+                           pCache->filename );
+
+            /* the cache is written after the load has flushed its
+               messages */
+            varlog_Flush();
+        }
+
+        free( tmpname );
+    }
+
+    return result;
+}
+
+/*! @}
+ * end of libvarcreate group */
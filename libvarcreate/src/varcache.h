@@ -0,0 +1,117 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARCACHE_H
+#define VARCACHE_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! The VarCacheEntry object records a config file which was loaded
+    successfully */
+typedef struct _VarCacheEntry
+{
+    /*! path of the config file */
+    char *path;
+
+    /*! hash of the file content and the options it was loaded with */
+    uint64_t hash;
+
+    /*! handle of the first variable created from the file */
+    VAR_HANDLE hVar;
+
+    /*! name of the first variable created from the file */
+    char *name;
+
+} VarCacheEntry;
+
+/*! The VarCache object records the config files which have been
+    loaded, so unchanged files can be skipped when they are loaded
+    again by the same variable server */
+typedef struct _VarCache
+{
+    /*! name of the state file holding the cache */
+    char *filename;
+
+    /*! options of the load using the cache, through which a failure
+        to write the state file is reported */
+    const VarCreateOptions *options;
+
+    /*! array of cache entries */
+    VarCacheEntry *entries;
+
+    /*! number of cache entries */
+    size_t count;
+
+    /*! number of entries the cache can hold before it must grow */
+    size_t size;
+
+    /*! the cache has changed since it was read */
+    bool modified;
+
+    /*! mutex protecting the cache when it is shared by worker threads */
+    pthread_mutex_t lock;
+
+} VarCache;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+int varcache_Open( VarCache *pCache,
+                   char *filename,
+                   const VarCreateOptions *options );
+
+int varcache_Hash( char *path, VarCreateOptions *options, uint64_t *pHash );
+
+bool varcache_Check( VarCache *pCache,
+                     VARSERVER_HANDLE hVarServer,
+                     char *path,
+                     uint64_t hash );
+
+int varcache_Update( VarCache *pCache,
+                     char *path,
+                     uint64_t hash,
+                     VAR_HANDLE hVar,
+                     char *name );
+
+void varcache_Remove( VarCache *pCache, char *path );
+
+int varcache_Sync( VarCache *pCache );
+
+int varcache_Close( VarCache *pCache );
+
+#endif
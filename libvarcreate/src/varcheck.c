@@ -0,0 +1,719 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varcheck.c
+
+    Variable Creation duplicate check
+
+    The duplicate check parses a set of config files exactly as they
+    would be loaded, with the prefix and instance identifier applied,
+    but records each variable and alias instead of creating it.  Names
+    and GUIDs which are defined more than once are reported without
+    making any request to the variable server, so a load can be
+    rejected before anything is created, and config files can be
+    checked on a machine which has no variable server.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varload.h"
+#include "varcheck.h"
+#include "varlog.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! number of slots in a hash table when it is first allocated */
+#define VARCHECK_INITIAL_SLOTS  ( 1024 )
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int varcheck_fnRecord( VarCheck *pCheck,
+                              const char *name,
+                              uint32_t guid,
+                              uint32_t instanceID,
+                              const char *filename,
+                              size_t index );
+
+static uint32_t *varcheck_fnFindName( VarCheck *pCheck,
+                                      const char *name,
+                                      uint32_t instanceID );
+
+static uint32_t *varcheck_fnFindGuid( VarCheck *pCheck,
+                                      uint32_t guid,
+                                      uint32_t instanceID );
+
+static int varcheck_fnGrow( VarCheck *pCheck, bool guids );
+
+static void varcheck_fnFree( VarCheck *pCheck );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  VARCREATE_CheckFiles                                                      */
+/*!
+    Check config files for duplicate variable names and GUIDs
+
+    The VARCREATE_CheckFiles function parses every config file in the
+    list, in order, as a single load and reports each variable or alias
+    whose name, and each variable whose GUID, was already defined by an
+    earlier variable with the same instance identifier.  The prefix,
+    instanceID and flags options are applied as they would be by a
+    load.  No variable server connection is required and no variables
+    are created.
+
+    Each duplicate is printed unless the quiet option is set, and is
+    passed to the report function of the options with an attribute of
+    "name", "alias" or "guid" and a result of EEXIST.
+
+    @param[in]
+        pList
+            pointer to the list of config files to check
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - there are no duplicates
+    @retval EINVAL - invalid arguments
+    @retval EEXIST - one or more names or GUIDs are duplicated
+    @retval ENOMEM - memory allocation problem
+    @retval other - a config file could not be processed
+
+==============================================================================*/
+int VARCREATE_CheckFiles( VarCreateFileList *pList, VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarCreateOptions opts;
+    VarCheck check;
+    VarLoad load;
+    size_t i;
+    int rc;
+
+    if ( ( pList != NULL ) &&
+         ( options != NULL ) )
+    {
+        /* only the options which affect the names, GUIDs and reporting
+           apply to a check */
+        opts = *options;
+        opts.batchSize = 0;
+        opts.pipeline = false;
+        opts.deferAliases = false;
+        opts.priority = false;
+        opts.workers = 0;
+        opts.cache = NULL;
+        opts.index = NULL;
+        opts.stats = NULL;
+        opts.fileStats = NULL;
+
+        memset( &check, 0, sizeof( VarCheck ) );
+
+        result = varcreate_fnLoadBegin( &load, NULL, &opts );
+        if ( result == EOK )
+        {
+            load.pCheck = &check;
+
+            for ( i = 0 ; i < pList->count ; i++ )
+            {
+                rc = varcreate_fnLoadFile( &load, pList->files[i] );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+            }
+
+            varcreate_fnLoadEnd( &load );
+        }
+
+        if ( ( result == EOK ) &&
+             ( check.conflicts > 0 ) )
+        {
+            result = EEXIST;
+        }
+
+        varcheck_fnFree( &check );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcheck_Add                                                              */
+/*!
+    Check a variable against those already seen
+
+    The varcheck_Add function reports the variable if its name or GUID
+    has already been seen with the same instance identifier, and then
+    records it.  The hVar member of the VarInfo object is set to a handle
+    which identifies the record, so the aliases of the variable are
+    checked too.
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+    @param[in]
+        options
+            pointer to the options which duplicates are reported to
+
+    @param[in]
+        filename
+            name of the config file defining the variable, or NULL
+
+    @param[in]
+        index
+            index of the variable definition in the config file
+
+    @param[in,out]
+        pVarInfo
+            pointer to the populated VarInfo object
+
+    @retval EOK - the variable was checked
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varcheck_Add( VarCheck *pCheck,
+                  const VarCreateOptions *options,
+                  const char *filename,
+                  size_t index,
+                  VarInfo *pVarInfo )
+{
+    int result = EINVAL;
+    VarCheckRecord *r;
+    uint32_t *pName;
+    uint32_t *pGuid = NULL;
+
+    if ( ( pCheck != NULL ) &&
+         ( pVarInfo != NULL ) )
+    {
+        result = varcheck_fnGrow( pCheck, false );
+        if ( ( result == EOK ) &&
+             ( pVarInfo->guid != 0 ) )
+        {
+            result = varcheck_fnGrow( pCheck, true );
+        }
+
+        if ( result == EOK )
+        {
+            pName = varcheck_fnFindName( pCheck,
+                                         pVarInfo->name,
+                                         pVarInfo->instanceID );
+            if ( *pName != 0 )
+            {
+                r = &pCheck->records[*pName - 1];
+                varlog_Printf( options,
+                               "Duplicate variable name: %s (first defined "
+                               "in %s:%zu)\n",
+                               pVarInfo->name,
+                               ( r->filename != NULL ) ? r->filename : "-",
+                               r->index );
+                varlog_Report( options,
+                               filename,
+                               index,
+                               pVarInfo->name,
+                               "name",
+                               EEXIST );
+                pCheck->conflicts++;
+            }
+
+            if ( pVarInfo->guid != 0 )
+            {
+                pGuid = varcheck_fnFindGuid( pCheck,
+                                             pVarInfo->guid,
+                                             pVarInfo->instanceID );
+                if ( *pGuid != 0 )
+                {
+                    r = &pCheck->records[*pGuid - 1];
+                    varlog_Printf( options,
+                                   "Duplicate GUID 0x%X: %s (first used by "
+                                   "%s in %s:%zu)\n",
+                                   (unsigned int)pVarInfo->guid,
+                                   pVarInfo->name,
+                                   &pCheck->strings[r->name],
+                                   ( r->filename != NULL ) ? r->filename
+                                                           : "-",
+                                   r->index );
+                    varlog_Report( options,
+                                   filename,
+                                   index,
+                                   pVarInfo->name,
+                                   "guid",
+                                   EEXIST );
+                    pCheck->conflicts++;
+                }
+            }
+
+            result = varcheck_fnRecord( pCheck,
+                                        pVarInfo->name,
+                                        pVarInfo->guid,
+                                        pVarInfo->instanceID,
+                                        filename,
+                                        index );
+            if ( result == EOK )
+            {
+                /* the first definition stays in the tables, so every
+                   later duplicate is reported against it */
+                if ( *pName == 0 )
+                {
+                    *pName = pCheck->count;
+                    pCheck->nnames++;
+                }
+
+                if ( ( pGuid != NULL ) &&
+                     ( *pGuid == 0 ) )
+                {
+                    *pGuid = pCheck->count;
+                    pCheck->nguids++;
+                }
+
+                pVarInfo->hVar = pCheck->count;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcheck_AddAlias                                                         */
+/*!
+    Check an alias against the names already seen
+
+    The varcheck_AddAlias function reports the alias if a variable or
+    alias of the same name has already been seen with the instance
+    identifier of the load, and then records it.
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+    @param[in]
+        options
+            pointer to the options which duplicates are reported to
+
+    @param[in]
+        filename
+            name of the config file defining the alias, or NULL
+
+    @param[in]
+        index
+            index of the variable definition in the config file
+
+    @param[in]
+        name
+            NUL terminated name of the alias
+
+    @retval EOK - the alias was checked
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varcheck_AddAlias( VarCheck *pCheck,
+                       const VarCreateOptions *options,
+                       const char *filename,
+                       size_t index,
+                       const char *name )
+{
+    int result = EINVAL;
+    VarCheckRecord *r;
+    uint32_t *pName;
+
+    if ( ( pCheck != NULL ) &&
+         ( options != NULL ) &&
+         ( name != NULL ) )
+    {
+        result = varcheck_fnGrow( pCheck, false );
+        if ( result == EOK )
+        {
+            pName = varcheck_fnFindName( pCheck, name, options->instanceID );
+            if ( *pName != 0 )
+            {
+                r = &pCheck->records[*pName - 1];
+                varlog_Printf( options,
+                               "Duplicate alias name: %s (first defined "
+                               "in %s:%zu)\n",
+                               name,
+                               ( r->filename != NULL ) ? r->filename : "-",
+                               r->index );
+                varlog_Report( options,
+                               filename,
+                               index,
+                               name,
+                               "alias",
+                               EEXIST );
+                pCheck->conflicts++;
+            }
+            else
+            {
+                result = varcheck_fnRecord( pCheck,
+                                            name,
+                                            0,
+                                            options->instanceID,
+                                            filename,
+                                            index );
+                if ( result == EOK )
+                {
+                    *pName = pCheck->count;
+                    pCheck->nnames++;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcheck_fnRecord                                                         */
+/*!
+    Append a record to a duplicate check
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+    @param[in]
+        name
+            NUL terminated variable or alias name
+
+    @param[in]
+        guid
+            GUID of the variable, or 0
+
+    @param[in]
+        instanceID
+            instance identifier of the variable
+
+    @param[in]
+        filename
+            name of the config file, which must outlive the check
+
+    @param[in]
+        index
+            index of the variable definition in the config file
+
+    @retval EOK - the record was appended
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varcheck_fnRecord( VarCheck *pCheck,
+                              const char *name,
+                              uint32_t guid,
+                              uint32_t instanceID,
+                              const char *filename,
+                              size_t index )
+{
+    int result = EOK;
+    VarCheckRecord *records;
+    VarCheckRecord *r;
+    char *strings;
+    size_t size;
+    size_t len;
+
+    len = strlen( name ) + 1;
+
+    if ( pCheck->count == pCheck->size )
+    {
+        size = ( pCheck->size == 0 ) ? VARCHECK_INITIAL_SLOTS
+                                     : pCheck->size * 2;
+        records = realloc( pCheck->records, size * sizeof( VarCheckRecord ) );
+        if ( records != NULL )
+        {
+            pCheck->records = records;
+            pCheck->size = size;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    if ( ( result == EOK ) &&
+         ( pCheck->strlen + len > pCheck->strsize ) )
+    {
+        size = ( pCheck->strsize == 0 ) ? VARCHECK_INITIAL_SLOTS * 32
+                                        : pCheck->strsize * 2;
+        while ( size < pCheck->strlen + len )
+        {
+            size *= 2;
+        }
+
+        strings = realloc( pCheck->strings, size );
+        if ( strings != NULL )
+        {
+            pCheck->strings = strings;
+            pCheck->strsize = size;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    if ( result == EOK )
+    {
+        r = &pCheck->records[pCheck->count++];
+        r->name = pCheck->strlen;
+        r->guid = guid;
+        r->instanceID = instanceID;
+        r->filename = filename;
+        r->index = index;
+
+        memcpy( &pCheck->strings[pCheck->strlen], name, len );
+        pCheck->strlen += len;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcheck_fnFindName                                                       */
+/*!
+    Find the name table slot of a name and instance
+
+    The varcheck_fnFindName function hashes the name and instance with
+    FNV-1a and probes linearly from there.  The name table must have
+    at least one empty slot.
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+    @param[in]
+        name
+            NUL terminated name to look up
+
+    @param[in]
+        instanceID
+            instance identifier to look up
+
+    @retval pointer to the slot holding the name, or to the empty slot
+            where it belongs
+
+==============================================================================*/
+static uint32_t *varcheck_fnFindName( VarCheck *pCheck,
+                                      const char *name,
+                                      uint32_t instanceID )
+{
+    uint32_t h = 2166136261u;
+    const unsigned char *p = (const unsigned char *)name;
+    size_t mask = pCheck->nameSize - 1;
+    const VarCheckRecord *r;
+    size_t i;
+
+    while ( *p != '\0' )
+    {
+        h = ( h ^ *p++ ) * 16777619u;
+    }
+
+    h = ( h ^ instanceID ) * 16777619u;
+
+    i = h & mask;
+    while ( pCheck->names[i] != 0 )
+    {
+        r = &pCheck->records[pCheck->names[i] - 1];
+        if ( ( r->instanceID == instanceID ) &&
+             ( strcmp( &pCheck->strings[r->name], name ) == 0 ) )
+        {
+            break;
+        }
+
+        i = ( i + 1 ) & mask;
+    }
+
+    return &pCheck->names[i];
+}
+
+/*============================================================================*/
+/*  varcheck_fnFindGuid                                                       */
+/*!
+    Find the GUID table slot of a GUID and instance
+
+    The varcheck_fnFindGuid function mixes the GUID and instance with a
+    multiplicative hash and probes linearly from there.  The GUID table
+    must have at least one empty slot.
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+    @param[in]
+        guid
+            GUID to look up
+
+    @param[in]
+        instanceID
+            instance identifier to look up
+
+    @retval pointer to the slot holding the GUID, or to the empty slot
+            where it belongs
+
+==============================================================================*/
+static uint32_t *varcheck_fnFindGuid( VarCheck *pCheck,
+                                      uint32_t guid,
+                                      uint32_t instanceID )
+{
+    uint64_t h;
+    size_t mask = pCheck->guidSize - 1;
+    const VarCheckRecord *r;
+    size_t i;
+
+    h = ( ( (uint64_t)instanceID << 32 ) | guid ) * 0x9E3779B97F4A7C15ULL;
+
+    i = ( h >> 32 ) & mask;
+    while ( pCheck->guids[i] != 0 )
+    {
+        r = &pCheck->records[pCheck->guids[i] - 1];
+        if ( ( r->guid == guid ) &&
+             ( r->instanceID == instanceID ) )
+        {
+            break;
+        }
+
+        i = ( i + 1 ) & mask;
+    }
+
+    return &pCheck->guids[i];
+}
+
+/*============================================================================*/
+/*  varcheck_fnGrow                                                           */
+/*!
+    Make room for another entry in a hash table
+
+    The varcheck_fnGrow function doubles the size of the name or GUID
+    table and re-inserts its entries whenever it is half full, so every
+    probe sequence is short and ends at an empty slot.
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+    @param[in]
+        guids
+            true to grow the GUID table, false to grow the name table
+
+    @retval EOK - the table has room for another entry
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varcheck_fnGrow( VarCheck *pCheck, bool guids )
+{
+    int result = EOK;
+    uint32_t **pTable = guids ? &pCheck->guids : &pCheck->names;
+    size_t *pSize = guids ? &pCheck->guidSize : &pCheck->nameSize;
+    size_t used = guids ? pCheck->nguids : pCheck->nnames;
+    uint32_t *old = *pTable;
+    size_t oldSize = *pSize;
+    const VarCheckRecord *r;
+    size_t size;
+    size_t i;
+
+    if ( ( used + 1 ) * 2 > oldSize )
+    {
+        size = ( oldSize == 0 ) ? VARCHECK_INITIAL_SLOTS : oldSize * 2;
+        *pTable = calloc( size, sizeof( uint32_t ) );
+        if ( *pTable != NULL )
+        {
+            *pSize = size;
+
+            /* re-insert the existing records */
+            for ( i = 0 ; i < oldSize ; i++ )
+            {
+                if ( old[i] != 0 )
+                {
+                    r = &pCheck->records[old[i] - 1];
+                    if ( guids == true )
+                    {
+                        *varcheck_fnFindGuid( pCheck,
+                                              r->guid,
+                                              r->instanceID ) = old[i];
+                    }
+                    else
+                    {
+                        *varcheck_fnFindName( pCheck,
+                                              &pCheck->strings[r->name],
+                                              r->instanceID ) = old[i];
+                    }
+                }
+            }
+
+            free( old );
+        }
+        else
+        {
+            *pTable = old;
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varcheck_fnFree                                                           */
+/*!
+    Release the storage used by a duplicate check
+
+    @param[in]
+        pCheck
+            pointer to the duplicate check
+
+==============================================================================*/
+static void varcheck_fnFree( VarCheck *pCheck )
+{
+    free( pCheck->records );
+    free( pCheck->strings );
+    free( pCheck->names );
+    free( pCheck->guids );
+    memset( pCheck, 0, sizeof( VarCheck ) );
+}
+
+/*! @}
+ * end of libvarcreate group */
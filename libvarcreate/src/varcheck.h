@@ -0,0 +1,124 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARCHECK_H
+#define VARCHECK_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! a variable or alias name seen by a duplicate check */
+typedef struct _VarCheckRecord
+{
+    /*! offset of the name in the string table */
+    uint32_t name;
+
+    /*! GUID of the variable, or 0 for an alias or a variable without one */
+    uint32_t guid;
+
+    /*! instance identifier of the variable */
+    uint32_t instanceID;
+
+    /*! name of the config file which defined it, or NULL */
+    const char *filename;
+
+    /*! index of the variable definition in the config file */
+    size_t index;
+
+} VarCheckRecord;
+
+/*! The VarCheck object finds the variable and alias names, and the
+    variable GUIDs, which are defined more than once in a load, using
+    open addressing hash tables of record numbers plus one.  Zero is an
+    empty slot */
+typedef struct _VarCheck
+{
+    /*! array of records */
+    VarCheckRecord *records;
+
+    /*! number of records */
+    size_t count;
+
+    /*! number of records which can be held before growing */
+    size_t size;
+
+    /*! string table */
+    char *strings;
+
+    /*! number of bytes used in the string table */
+    size_t strlen;
+
+    /*! size of the string table buffer */
+    size_t strsize;
+
+    /*! hash table of the records keyed on name and instance */
+    uint32_t *names;
+
+    /*! number of slots in the name table, always a power of two */
+    size_t nameSize;
+
+    /*! number of records in the name table */
+    size_t nnames;
+
+    /*! hash table of the records keyed on GUID and instance */
+    uint32_t *guids;
+
+    /*! number of slots in the GUID table, always a power of two */
+    size_t guidSize;
+
+    /*! number of records in the GUID table */
+    size_t nguids;
+
+    /*! number of duplicates found */
+    size_t conflicts;
+
+} VarCheck;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+int varcheck_Add( VarCheck *pCheck,
+                  const VarCreateOptions *options,
+                  const char *filename,
+                  size_t index,
+                  VarInfo *pVarInfo );
+
+int varcheck_AddAlias( VarCheck *pCheck,
+                       const VarCreateOptions *options,
+                       const char *filename,
+                       size_t index,
+                       const char *name );
+
+#endif
@@ -0,0 +1,1390 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file vardir.c
+
+    Variable Creation from a directory of JSON config files
+
+    The directory loader creates variables from every varcreate JSON
+    file in a directory.  The files may be processed by a pool of
+    worker threads, each with its own variable server connection.
+    When files are processed in parallel, the aliases are created
+    once all of the primary variables in every file have been created,
+    so the result does not depend on the order the files complete in.
+
+    A directory can also be watched, so that the variables of each
+    config file are created as soon as the file is written to the
+    directory, over a single variable server connection.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varload.h"
+#include "varcache.h"
+#include "varsnap.h"
+#include "varlog.h"
+#include "varprobe.h"
+#include "varzip.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! suffix identifying varcreate JSON files */
+#define VARCREATE_FILE_SUFFIX       ".json"
+
+/*! size of the buffer used to read directory change events */
+#define VARDIR_EVENT_BUFFER_SIZE    ( 4096 )
+
+/*==============================================================================
+        Type Definitions
+==============================================================================*/
+
+/*! list of the files to be processed in a directory */
+typedef VarCreateFileList VarDirList;
+
+/*! state shared by the directory worker threads */
+typedef struct _VarDirJob
+{
+    /*! options used to modify the variable creation behavior */
+    VarCreateOptions *options;
+
+    /*! pointer to the cache shared by the workers, or NULL */
+    VarCache *pCache;
+
+    /*! the variables created by the workers */
+    VarLoadTier tier;
+
+    /*! list of files to process */
+    VarDirList *pList;
+
+    /*! index of the next file to be processed */
+    size_t next;
+
+    /*! mutex protecting the index of the next file */
+    pthread_mutex_t lock;
+
+} VarDirJob;
+
+/*! state of a directory worker thread */
+typedef struct _VarDirWorker
+{
+    /*! worker thread identifier */
+    pthread_t thread;
+
+    /*! the worker's own connection to the variable server */
+    VARSERVER_HANDLE hVarServer;
+
+    /*! pointer to the shared job state */
+    VarDirJob *pJob;
+
+    /*! aliases collected by the worker to be created after all of the
+        workers have finished */
+    VarAliasList aliases;
+
+    /*! aggregated result of the files processed by the worker */
+    int result;
+
+} VarDirWorker;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int vardir_fnList( char *dirname,
+                          bool recursive,
+                          const VarCreateOptions *options,
+                          VarDirList *pList );
+
+static int vardir_fnScan( int fd,
+                          char *dirname,
+                          bool recursive,
+                          const VarCreateOptions *options,
+                          VarDirList *pList );
+
+static int vardir_fnCompare( const void *a, const void *b );
+
+static bool vardir_fnIsConfig( const char *filename );
+
+static char *vardir_fnPath( const char *dirname, const char *filename );
+
+static int vardir_fnAdd( VarDirList *pList, char *dirname, char *filename );
+
+static int vardir_fnLoadSerial( VARSERVER_HANDLE hVarServer,
+                                VarDirList *pList,
+                                VarCreateOptions *options,
+                                VarCache *pCache,
+                                VarLoadTier tier );
+
+static int vardir_fnLoadParallel( VARSERVER_HANDLE hVarServer,
+                                  VarDirList *pList,
+                                  VarCreateOptions *options,
+                                  VarCache *pCache,
+                                  VarLoadTier tier );
+
+static void *vardir_fnWorker( void *arg );
+
+static int vardir_fnLoadFile( VarLoad *pLoad, char *filename );
+
+static int vardir_fnWatch( VarLoad *pLoad, int fd, char *dirname );
+
+static int vardir_fnRescan( VarLoad *pLoad, char *dirname );
+
+static int vardir_fnLoadEvent( VarLoad *pLoad,
+                               char *dirname,
+                               const struct inotify_event *pEvent );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  VARCREATE_CreateFromDirectory                                             */
+/*!
+    Create variables from all of the JSON config files in a directory
+
+    The VARCREATE_CreateFromDirectory function creates variables from
+    every *.json file in the specified directory, and in all of its
+    subdirectories if the recursive option is set.  Compressed *.json.gz
+    and *.json.zst files are loaded too.  The files are loaded
+    in order of their paths.  If the workers option
+    is greater than one, the files are spread across that many worker
+    threads, each with its own connection to the variable server, and
+    all of the aliases are created after all of the primary variables
+    have been created.
+
+    If the priority option is set, the critical variables of every file
+    are created first, in turn over the caller's connection, and the
+    ready function is called before the rest of the variables are
+    created.
+
+    If the preflight option is set, every file is checked for duplicate
+    names and GUIDs first, and no variables are created if there are any.
+
+    If the instances option is set, the files are parsed once and their
+    variables are created for each instance in turn, over the caller's
+    connection.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        dirname
+            name of the directory containing the JSON config files
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOENT - the directory was not found
+    @retval ENOMEM - memory allocation problem
+    @retval EEXIST - the preflight check found duplicate names or GUIDs
+    @retval other - one or more files could not be processed
+
+==============================================================================*/
+int VARCREATE_CreateFromDirectory( VARSERVER_HANDLE hVarServer,
+                                   char *dirname,
+                                   VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarDirList list;
+    VarCache cache;
+    VarCache *pCache = NULL;
+    VarLoadTier tier = VARLOAD_TIER_ALL;
+    int rc;
+
+    VARPROBE_BEGIN( load, dirname, 0 );
+
+    if ( ( hVarServer != NULL ) &&
+         ( dirname != NULL ) &&
+         ( options != NULL ) )
+    {
+        memset( &list, 0, sizeof( VarDirList ) );
+
+        result = vardir_fnList( dirname,
+                                options->recursive,
+                                options,
+                                &list );
+        if ( ( result == EOK ) &&
+             ( options->preflight == true ) )
+        {
+            /* reject the directory before anything is created */
+            result = VARCREATE_CheckFiles( &list, options );
+        }
+
+        if ( ( result == EOK ) &&
+             ( options->instances != NULL ) )
+        {
+            /* parse the files once and create them for every instance */
+            result = varsnap_CreateInstances( hVarServer, &list, options );
+        }
+        else if ( ( result == EOK ) &&
+                  ( options->cache != NULL ) )
+        {
+            result = varcache_Open( &cache, options->cache, options );
+            pCache = ( result == EOK ) ? &cache : NULL;
+        }
+
+        if ( ( result == EOK ) &&
+             ( options->instances == NULL ) )
+        {
+            if ( options->priority == true )
+            {
+                /* a first pass over every file for the critical
+                   variables */
+                result = vardir_fnLoadSerial( hVarServer,
+                                              &list,
+                                              options,
+                                              pCache,
+                                              VARLOAD_TIER_CRITICAL );
+                tier = VARLOAD_TIER_NORMAL;
+            }
+
+            if ( ( options->workers > 1 ) && ( list.count > 1 ) )
+            {
+                rc = vardir_fnLoadParallel( hVarServer,
+                                            &list,
+                                            options,
+                                            pCache,
+                                            tier );
+            }
+            else
+            {
+                rc = vardir_fnLoadSerial( hVarServer,
+                                          &list,
+                                          options,
+                                          pCache,
+                                          tier );
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+
+        if ( pCache != NULL )
+        {
+            rc = varcache_Close( pCache );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+
+        VARCREATE_FreeFileList( &list );
+    }
+
+    VARPROBE_END( load, dirname, result );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_WatchDirectory                                                  */
+/*!
+    Create variables from the JSON config files written to a directory
+
+    The VARCREATE_WatchDirectory function creates variables from every
+    *.json file in the specified directory as VARCREATE_CreateFromDirectory
+    does, and then watches the directory, creating the variables of each
+    config file which is written to, or moved into, the directory as
+    soon as the file is complete.  The same variable server connection
+    and load state are used for every file.
+
+    If the cache option is set, the state file is updated after every
+    file, so files which are rewritten without being changed are
+    skipped.  If so many files are written at once that directory
+    events are lost, every file in the directory is loaded again, so
+    the cache option should be set to skip the files which are already
+    loaded.
+
+    Only the directory itself is watched.  With the recursive option,
+    the initial load includes the subdirectories, but files written to
+    them afterwards are not loaded.
+
+    The function does not return until the directory is removed, or the
+    wait for directory changes is interrupted by a signal.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        dirname
+            name of the directory containing the JSON config files
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EINTR - the watch was interrupted by a signal
+    @retval ENOENT - the directory was not found, or has been removed
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval other - the directory could not be watched
+
+==============================================================================*/
+int VARCREATE_WatchDirectory( VARSERVER_HANDLE hVarServer,
+                              char *dirname,
+                              VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarLoad load;
+    VarCache cache;
+    int fd;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( dirname != NULL ) &&
+         ( options != NULL ) )
+    {
+        /* watch the directory before it is loaded, so no file which
+           is written during the initial load is missed */
+        fd = inotify_init1( IN_CLOEXEC );
+        if ( fd == -1 )
+        {
+            result = errno;
+        }
+        else if ( inotify_add_watch( fd,
+                                     dirname,
+                                     IN_CLOSE_WRITE | IN_MOVED_TO |
+                                     IN_ONLYDIR ) == -1 )
+        {
+            result = errno;
+            close( fd );
+        }
+        else
+        {
+            rc = VARCREATE_CreateFromDirectory( hVarServer,
+                                                dirname,
+                                                options );
+            if ( rc != EOK )
+            {
+                varlog_Printf( options,
+                               "Failed to create variables from %s\n",
+                               dirname );
+            }
+
+            result = varcreate_fnLoadBegin( &load, hVarServer, options );
+            if ( ( result == EOK ) &&
+                 ( options->cache != NULL ) )
+            {
+                result = varcache_Open( &cache, options->cache, options );
+                load.pCache = ( result == EOK ) ? &cache : NULL;
+            }
+
+            if ( result == EOK )
+            {
+                result = vardir_fnWatch( &load, fd, dirname );
+            }
+
+            if ( load.pCache != NULL )
+            {
+                (void)varcache_Close( load.pCache );
+            }
+
+            varcreate_fnLoadEnd( &load );
+
+            close( fd );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_ScanDirectory                                                   */
+/*!
+    List the varcreate JSON files in a directory
+
+    The VARCREATE_ScanDirectory function builds a list of the full
+    paths of all of the regular *.json files in the specified directory,
+    and optionally in all of its subdirectories, sorted by path so the
+    files are always loaded in the same order.  The file types reported
+    by the directory are used where possible, so a file is only examined
+    individually if its type is unknown or it is a symbolic link.
+    Symbolic links to directories are not followed.  An entry which
+    cannot be examined is skipped.
+
+    The list must be released with VARCREATE_FreeFileList, even if the
+    scan fails.
+
+    @param[in]
+        dirname
+            name of the directory to scan
+
+    @param[in]
+        recursive
+            true to include the files in the subdirectories
+
+    @param[in,out]
+        pList
+            pointer to an empty list to populate
+
+    @retval EOK - the directory was listed
+    @retval EINVAL - invalid arguments
+    @retval ENOENT - the directory was not found
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int VARCREATE_ScanDirectory( char *dirname,
+                             bool recursive,
+                             VarCreateFileList *pList )
+{
+    return vardir_fnList( dirname, recursive, NULL, pList );
+}
+
+/*============================================================================*/
+/*  VARCREATE_FreeFileList                                                    */
+/*!
+    Release the storage used by a file list
+
+    @param[in]
+        pList
+            pointer to the list to release
+
+==============================================================================*/
+void VARCREATE_FreeFileList( VarCreateFileList *pList )
+{
+    size_t i;
+
+    if ( pList != NULL )
+    {
+        for ( i = 0 ; i < pList->count ; i++ )
+        {
+            free( pList->files[i] );
+        }
+
+        free( pList->files );
+        pList->files = NULL;
+        pList->count = 0;
+        pList->size = 0;
+    }
+}
+
+/*============================================================================*/
+/*  vardir_fnList                                                             */
+/*!
+    List the varcreate JSON files in a directory
+
+    The vardir_fnList function implements VARCREATE_ScanDirectory.  An
+    entry which cannot be examined is reported through the options of
+    the load, if there are any, and skipped.
+
+    @param[in]
+        dirname
+            name of the directory to scan
+
+    @param[in]
+        recursive
+            true to include the files in the subdirectories
+
+    @param[in]
+        options
+            pointer to the options of the load, or NULL
+
+    @param[in,out]
+        pList
+            pointer to an empty list to populate
+
+    @retval EOK - the directory was listed
+    @retval EINVAL - invalid arguments
+    @retval ENOENT - the directory was not found
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int vardir_fnList( char *dirname,
+                          bool recursive,
+                          const VarCreateOptions *options,
+                          VarDirList *pList )
+{
+    int result = EINVAL;
+    int fd;
+
+    if ( ( dirname != NULL ) &&
+         ( pList != NULL ) )
+    {
+        fd = open( dirname, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        if ( fd != -1 )
+        {
+            result = vardir_fnScan( fd, dirname, recursive, options, pList );
+            if ( result == EOK )
+            {
+                qsort( pList->files,
+                       pList->count,
+                       sizeof( char * ),
+                       vardir_fnCompare );
+            }
+        }
+        else
+        {
+            /* directory not found */
+            result = ENOENT;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnScan                                                             */
+/*!
+    Add the varcreate JSON files in an open directory to a list
+
+    The vardir_fnScan function adds the regular *.json files in the
+    directory to the list, and descends into the subdirectories if
+    requested.  The directory file descriptor is always closed.
+
+    @param[in]
+        fd
+            file descriptor of the open directory
+
+    @param[in]
+        dirname
+            path of the directory, used to build the file paths
+
+    @param[in]
+        recursive
+            true to include the files in the subdirectories
+
+    @param[in]
+        options
+            pointer to the options of the load, or NULL
+
+    @param[in]
+        pList
+            pointer to the list to add the files to
+
+    @retval EOK - the directory was listed
+    @retval ENOENT - the directory could not be read
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int vardir_fnScan( int fd,
+                          char *dirname,
+                          bool recursive,
+                          const VarCreateOptions *options,
+                          VarDirList *pList )
+{
+    int result = EOK;
+    struct dirent *dp;
+    struct stat st;
+    unsigned char type;
+    char *path;
+    DIR *dfd;
+    int subfd;
+
+    dfd = fdopendir( fd );
+    if ( dfd != NULL )
+    {
+        /* iterate through each entry in the directory */
+        while ( ( result == EOK ) &&
+                ( ( dp = readdir( dfd ) ) != NULL ) )
+        {
+            if ( ( strcmp( dp->d_name, "." ) == 0 ) ||
+                 ( strcmp( dp->d_name, ".." ) == 0 ) )
+            {
+                continue;
+            }
+
+            type = dp->d_type;
+            if ( ( type == DT_UNKNOWN ) || ( type == DT_LNK ) )
+            {
+                /* the directory did not report the type of the file,
+                   or the type of the file a link refers to is needed */
+                if ( fstatat( fd,
+                              dp->d_name,
+                              &st,
+                              ( type == DT_LNK ) ? 0
+                                                 : AT_SYMLINK_NOFOLLOW ) == 0 )
+                {
+                    type = S_ISREG( st.st_mode ) ? DT_REG
+                         : ( S_ISDIR( st.st_mode ) && ( type != DT_LNK ) )
+                            ? DT_DIR
+                            : DT_UNKNOWN;
+                }
+                else
+                {
+                    varlog_Printf( options,
+                                   "Unable to stat file: %s\n",
+                                   dp->d_name );
+                    type = DT_UNKNOWN;
+                }
+            }
+
+            if ( type == DT_REG )
+            {
+                if ( vardir_fnIsConfig( dp->d_name ) )
+                {
+                    result = vardir_fnAdd( pList, dirname, dp->d_name );
+                }
+            }
+            else if ( ( type == DT_DIR ) && ( recursive == true ) )
+            {
+                path = vardir_fnPath( dirname, dp->d_name );
+                subfd = openat( fd,
+                                dp->d_name,
+                                O_RDONLY | O_DIRECTORY | O_CLOEXEC |
+                                O_NOFOLLOW );
+                if ( ( path != NULL ) && ( subfd != -1 ) )
+                {
+                    result = vardir_fnScan( subfd,
+                                            path,
+                                            recursive,
+                                            options,
+                                            pList );
+                    if ( result == ENOENT )
+                    {
+                        /* the subdirectory has gone, carry on */
+                        result = EOK;
+                    }
+                }
+                else if ( path == NULL )
+                {
+                    result = ENOMEM;
+                    if ( subfd != -1 )
+                    {
+                        close( subfd );
+                    }
+                }
+
+                free( path );
+            }
+        }
+
+        closedir( dfd );
+    }
+    else
+    {
+        close( fd );
+        result = ENOENT;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnCompare                                                          */
+/*!
+    Compare two file paths for sorting a file list
+
+    @param[in]
+        a
+            pointer to the first path
+
+    @param[in]
+        b
+            pointer to the second path
+
+    @retval the order of the paths, as strcmp
+
+==============================================================================*/
+static int vardir_fnCompare( const void *a, const void *b )
+{
+    return strcmp( *(char * const *)a, *(char * const *)b );
+}
+
+/*============================================================================*/
+/*  vardir_fnIsConfig                                                         */
+/*!
+    Determine whether a file is a varcreate JSON config file
+
+    @param[in]
+        filename
+            name of the file
+
+    @retval true - the file name ends in .json, .json.gz or .json.zst
+    @retval false - the file is not a config file
+
+==============================================================================*/
+static bool vardir_fnIsConfig( const char *filename )
+{
+    size_t len = strlen( filename );
+    size_t n = sizeof( VARCREATE_FILE_SUFFIX ) - 1;
+
+    return ( ( len > n ) &&
+             ( strcmp( &filename[len - n], VARCREATE_FILE_SUFFIX ) == 0 ) ) ||
+           ( varzip_Format( filename ) != VARZIP_NONE );
+}
+
+/*============================================================================*/
+/*  vardir_fnPath                                                             */
+/*!
+    Construct the full path of a file in a directory
+
+    @param[in]
+        dirname
+            pointer to the directory name
+
+    @param[in]
+        filename
+            pointer to the file name
+
+    @retval pointer to the allocated path, to be released with free
+    @retval NULL if memory allocation failed
+
+==============================================================================*/
+static char *vardir_fnPath( const char *dirname, const char *filename )
+{
+    char *path;
+    size_t len;
+    size_t n;
+
+    len = strlen( dirname );
+    n = len + strlen( filename ) + 2;
+    path = malloc( n );
+    if ( path != NULL )
+    {
+        snprintf( path,
+                  n,
+                  ( ( len > 0 ) && ( dirname[len-1] == '/' ) ) ? "%s%s"
+                                                               : "%s/%s",
+                  dirname,
+                  filename );
+    }
+
+    return path;
+}
+
+/*============================================================================*/
+/*  vardir_fnAdd                                                              */
+/*!
+    Add a file to a file list
+
+    The vardir_fnAdd function constructs the full path of the file
+    and appends it to the list.
+
+    @param[in]
+        pList
+            pointer to the list to add the file to
+
+    @param[in]
+        dirname
+            pointer to the directory name
+
+    @param[in]
+        filename
+            pointer to the file name
+
+    @retval EOK - the file was added
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int vardir_fnAdd( VarDirList *pList, char *dirname, char *filename )
+{
+    int result = EOK;
+    char *path;
+    char **p;
+    size_t size;
+
+    path = vardir_fnPath( dirname, filename );
+    if ( path != NULL )
+    {
+        if ( pList->count == pList->size )
+        {
+            size = ( pList->size == 0 ) ? 16 : pList->size * 2;
+            p = realloc( pList->files, size * sizeof( char * ) );
+            if ( p != NULL )
+            {
+                pList->files = p;
+                pList->size = size;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if ( result == EOK )
+        {
+            pList->files[pList->count++] = path;
+        }
+        else
+        {
+            free( path );
+        }
+    }
+    else
+    {
+        result = ENOMEM;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnLoadSerial                                                       */
+/*!
+    Create variables from each file in a directory list in turn
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        pList
+            pointer to the list of files to process
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @param[in]
+        pCache
+            pointer to the load cache, or NULL
+
+    @param[in]
+        tier
+            the variables to create.  The ready function is called at
+            the end of the pass which creates the critical variables
+
+    @retval EOK - variable creation was successful
+    @retval other - one or more files could not be processed
+
+==============================================================================*/
+static int vardir_fnLoadSerial( VARSERVER_HANDLE hVarServer,
+                                VarDirList *pList,
+                                VarCreateOptions *options,
+                                VarCache *pCache,
+                                VarLoadTier tier )
+{
+    int result;
+    VarLoad load;
+    size_t i;
+    int rc;
+
+    result = varcreate_fnLoadBegin( &load, hVarServer, options );
+    if ( result == EOK )
+    {
+        load.pCache = pCache;
+        load.tier = tier;
+
+        for ( i = 0 ; i < pList->count ; i++ )
+        {
+            rc = vardir_fnLoadFile( &load, pList->files[i] );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+
+        /* create the deferred aliases now that every file is loaded */
+        rc = ( tier == VARLOAD_TIER_CRITICAL )
+                ? varcreate_fnLoadReady( &load )
+                : varcreate_fnLoadAliases( &load );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        varcreate_fnLoadEnd( &load );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnLoadParallel                                                     */
+/*!
+    Create variables from the files in a directory list using workers
+
+    The vardir_fnLoadParallel function starts up to options->workers
+    worker threads, each with its own connection to the variable server,
+    which take files from the list until it is exhausted.  Once all of
+    the workers have finished, the aliases they collected are created.
+    If no worker can be started, the files are processed serially.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create the aliases for
+
+    @param[in]
+        pList
+            pointer to the list of files to process
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @param[in]
+        pCache
+            pointer to the load cache, or NULL
+
+    @param[in]
+        tier
+            the variables to create
+
+    @retval EOK - variable creation was successful
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more files could not be processed
+
+==============================================================================*/
+static int vardir_fnLoadParallel( VARSERVER_HANDLE hVarServer,
+                                  VarDirList *pList,
+                                  VarCreateOptions *options,
+                                  VarCache *pCache,
+                                  VarLoadTier tier )
+{
+    int result = ENOMEM;
+    VarDirJob job;
+    VarDirWorker *workers;
+    VarCreateStats stats;
+    size_t nworkers;
+    size_t started = 0;
+    size_t i;
+    int rc;
+
+    nworkers = ( options->workers < pList->count ) ? options->workers
+                                                   : pList->count;
+
+    workers = calloc( nworkers, sizeof( VarDirWorker ) );
+    if ( workers != NULL )
+    {
+        job.options = options;
+        job.pCache = pCache;
+        job.tier = tier;
+        job.pList = pList;
+        job.next = 0;
+        pthread_mutex_init( &job.lock, NULL );
+
+        for ( i = 0 ; i < nworkers ; i++ )
+        {
+            workers[started].pJob = &job;
+            workers[started].hVarServer = VARSERVER_Open();
+            if ( workers[started].hVarServer == NULL )
+            {
+                break;
+            }
+
+            if ( pthread_create( &workers[started].thread,
+                                 NULL,
+                                 vardir_fnWorker,
+                                 &workers[started] ) != 0 )
+            {
+                VARSERVER_Close( workers[started].hVarServer );
+                break;
+            }
+
+            started++;
+        }
+
+        if ( started > 0 )
+        {
+            result = EOK;
+
+            /* wait for all of the primary variables to be created */
+            for ( i = 0 ; i < started ; i++ )
+            {
+                pthread_join( workers[i].thread, NULL );
+                VARSERVER_Close( workers[i].hVarServer );
+
+                if ( workers[i].result != EOK )
+                {
+                    result = workers[i].result;
+                }
+            }
+
+            /* create the aliases now that every variable exists */
+            memset( &stats, 0, sizeof( VarCreateStats ) );
+            for ( i = 0 ; i < started ; i++ )
+            {
+                rc = varcreate_fnCreateAliases( hVarServer,
+                                                &workers[i].aliases,
+                                                options,
+                                                pCache,
+                                                &stats );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+
+                varcreate_fnFreeAliases( &workers[i].aliases );
+            }
+
+            /* the aliases are not attributed to their files */
+            varcreate_fnAddStats( options, &stats );
+            varlog_Flush();
+        }
+        else
+        {
+            /* no workers could be started */
+            result = vardir_fnLoadSerial( hVarServer,
+                                          pList,
+                                          options,
+                                          pCache,
+                                          tier );
+        }
+
+        pthread_mutex_destroy( &job.lock );
+        free( workers );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnWorker                                                           */
+/*!
+    Directory worker thread
+
+    The vardir_fnWorker function takes files from the shared list and
+    creates their variables on the worker's own variable server
+    connection until no files remain.  Aliases are collected rather
+    than created.
+
+    @param[in]
+        arg
+            pointer to the VarDirWorker object
+
+    @retval NULL
+
+==============================================================================*/
+static void *vardir_fnWorker( void *arg )
+{
+    VarDirWorker *pWorker = (VarDirWorker *)arg;
+    VarDirJob *pJob = pWorker->pJob;
+    VarLoad load;
+    size_t i;
+    int rc;
+
+    pWorker->result = varcreate_fnLoadBegin( &load,
+                                             pWorker->hVarServer,
+                                             pJob->options );
+    if ( pWorker->result == EOK )
+    {
+        load.pAliases = &pWorker->aliases;
+        load.pCache = pJob->pCache;
+        load.tier = pJob->tier;
+
+        while ( true )
+        {
+            pthread_mutex_lock( &pJob->lock );
+            i = pJob->next++;
+            pthread_mutex_unlock( &pJob->lock );
+
+            if ( i >= pJob->pList->count )
+            {
+                break;
+            }
+
+            rc = vardir_fnLoadFile( &load, pJob->pList->files[i] );
+            if ( rc != EOK )
+            {
+                pWorker->result = rc;
+            }
+        }
+
+        varcreate_fnLoadEnd( &load );
+    }
+
+    return NULL;
+}
+
+/*============================================================================*/
+/*  vardir_fnLoadFile                                                         */
+/*!
+    Create variables from one file of a directory
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        filename
+            name of the file to process
+
+    @retval EOK - variable creation was successful
+    @retval other - the file could not be processed
+
+==============================================================================*/
+static int vardir_fnLoadFile( VarLoad *pLoad, char *filename )
+{
+    int result;
+
+    if ( pLoad->options->verbose )
+    {
+        varlog_Printf( pLoad->options,
+                       "VARCREATE: Creating vars: %s\n",
+                       filename );
+    }
+
+    /* create variables from file */
+    result = varcreate_fnLoadFile( pLoad, filename );
+    if ( result != EOK )
+    {
+        varlog_Printf( pLoad->options,
+                       "Failed to create variables from %s\n",
+                       filename );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnWatch                                                            */
+/*!
+    Create variables from the config files as they are written
+
+    The vardir_fnWatch function waits for changes to the watched
+    directory, and loads each config file which has been written to,
+    or moved into, the directory.  A file which cannot be loaded is
+    reported, and does not stop the watch.  If the event queue
+    overflows, the whole directory is loaded again.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        fd
+            inotify file descriptor watching the directory
+
+    @param[in]
+        dirname
+            name of the watched directory
+
+    @retval EINTR - the watch was interrupted by a signal
+    @retval ENOENT - the directory has been removed
+    @retval EIO - the directory changes could not be read
+
+==============================================================================*/
+static int vardir_fnWatch( VarLoad *pLoad, int fd, char *dirname )
+{
+    int result = EOK;
+    char buf[VARDIR_EVENT_BUFFER_SIZE]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    const struct inotify_event *pEvent;
+    ssize_t n;
+    ssize_t i;
+
+    while ( result == EOK )
+    {
+        n = read( fd, buf, sizeof buf );
+        if ( n > 0 )
+        {
+            for ( i = 0 ; i < n ; i += sizeof( *pEvent ) + pEvent->len )
+            {
+                pEvent = (const struct inotify_event *)&buf[i];
+                if ( pEvent->mask & IN_IGNORED )
+                {
+                    /* the directory has been removed or unmounted */
+                    result = ENOENT;
+                }
+                else if ( pEvent->mask & IN_Q_OVERFLOW )
+                {
+                    /* events were dropped, so any file may be missing */
+                    (void)vardir_fnRescan( pLoad, dirname );
+                }
+                else if ( ( pEvent->len > 0 ) &&
+                          ( ( pEvent->mask & IN_ISDIR ) == 0 ) &&
+                          ( vardir_fnIsConfig( pEvent->name ) ) )
+                {
+                    (void)vardir_fnLoadEvent( pLoad, dirname, pEvent );
+                }
+            }
+        }
+        else
+        {
+            result = ( ( n == -1 ) && ( errno == EINTR ) ) ? EINTR : EIO;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnRescan                                                           */
+/*!
+    Load the watched directory again after directory events were lost
+
+    The vardir_fnRescan function loads every config file in the watched
+    directory, in the same order as the initial load, once the inotify
+    event queue has overflowed.  The files which were written while the
+    events were being dropped are only known to be somewhere in the
+    directory.  With the cache option, the unchanged files are skipped,
+    otherwise the variables of the files which were already loaded are
+    reported again as existing.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        dirname
+            name of the watched directory
+
+    @retval EOK - variable creation was successful
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more files could not be processed
+
+==============================================================================*/
+static int vardir_fnRescan( VarLoad *pLoad, char *dirname )
+{
+    int result;
+    VarDirList list;
+    size_t i;
+    int rc;
+
+    memset( &list, 0, sizeof( VarDirList ) );
+
+    if ( pLoad->options->verbose )
+    {
+        varlog_Printf( pLoad->options,
+                       "VARCREATE: Events lost, rescanning: %s\n",
+                       dirname );
+    }
+
+    /* only the top directory is watched */
+    result = vardir_fnList( dirname, false, pLoad->options, &list );
+    for ( i = 0 ; ( result == EOK ) && ( i < list.count ) ; i++ )
+    {
+        rc = vardir_fnLoadFile( pLoad, list.files[i] );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+    }
+
+    rc = varcreate_fnLoadAliases( pLoad );
+    if ( rc != EOK )
+    {
+        result = rc;
+    }
+
+    if ( pLoad->pCache != NULL )
+    {
+        rc = varcache_Sync( pLoad->pCache );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+    }
+
+    VARCREATE_FreeFileList( &list );
+    varlog_Flush();
+
+    return result;
+}
+
+/*============================================================================*/
+/*  vardir_fnLoadEvent                                                        */
+/*!
+    Create variables from a config file which has been written
+
+    The vardir_fnLoadEvent function creates the variables of the config
+    file named by a directory change event, along with their aliases,
+    and records the file in the cache.
+
+    @param[in]
+        pLoad
+            pointer to the VarLoad object
+
+    @param[in]
+        dirname
+            name of the watched directory
+
+    @param[in]
+        pEvent
+            pointer to the directory change event
+
+    @retval EOK - variable creation was successful
+    @retval ENOMEM - memory allocation problem
+    @retval other - the file could not be processed
+
+==============================================================================*/
+static int vardir_fnLoadEvent( VarLoad *pLoad,
+                               char *dirname,
+                               const struct inotify_event *pEvent )
+{
+    int result;
+    VarDirList list;
+    int rc;
+
+    memset( &list, 0, sizeof( VarDirList ) );
+
+    /* the name was checked when the event was read */
+    result = vardir_fnAdd( &list, dirname, (char *)pEvent->name );
+    if ( ( result == EOK ) &&
+         ( list.count == 1 ) )
+    {
+        result = vardir_fnLoadFile( pLoad, list.files[0] );
+
+        rc = varcreate_fnLoadAliases( pLoad );
+        if ( rc != EOK )
+        {
+            result = rc;
+        }
+
+        if ( pLoad->pCache != NULL )
+        {
+            rc = varcache_Sync( pLoad->pCache );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    VARCREATE_FreeFileList( &list );
+
+    /* the messages of the file are not held back until the next one */
+    varlog_Flush();
+
+    return result;
+}
+
+/*! @}
+ * end of libvarcreate group */
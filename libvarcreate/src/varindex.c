@@ -0,0 +1,775 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varindex.c
+
+    Variable Creation handle index
+
+    A handle index records the name and handle of every variable and
+    alias created by a load.  It is written to a file holding a sorted
+    array of entries followed by a string table, which a client maps
+    into memory and searches with a binary search, so it can resolve
+    the names of the variables it uses without a request to the variable
+    server for each one.
+
+    The handles are only meaningful to the variable server instance
+    which created the variables, so the index must be written again
+    whenever the variable server is restarted.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varindex.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! number of entries the index holds when it first grows */
+#define VARINDEX_INITIAL_SIZE   ( 256 )
+
+/*! number of string table bytes the index holds when it first grows */
+#define VARINDEX_INITIAL_STRSIZE    ( 8192 )
+
+/*==============================================================================
+        Type Definitions
+==============================================================================*/
+
+/*! a name and handle being sorted into an index image */
+typedef struct _VarIndexSort
+{
+    /*! NUL terminated name */
+    const char *name;
+
+    /*! handle of the variable */
+    uint32_t hVar;
+
+    /*! order in which the name was added */
+    size_t seq;
+
+} VarIndexSort;
+
+/*! state of a handle index */
+struct _VarCreateIndex
+{
+    /*! serializes the additions of the threads of a load */
+    pthread_mutex_t lock;
+
+    /*! entries in the order they were added, whose names are offsets
+        into the strings buffer */
+    VarIndexEntry *entries;
+
+    /*! number of entries added */
+    size_t count;
+
+    /*! number of entries which can be held before growing */
+    size_t size;
+
+    /*! names of the entries which have been added */
+    char *strings;
+
+    /*! number of bytes used in the strings buffer */
+    size_t strlen;
+
+    /*! size of the strings buffer */
+    size_t strsize;
+
+    /*! ENOMEM if an entry could not be added, otherwise EOK */
+    int result;
+
+    /*! sorted index image, or NULL if it must be rebuilt */
+    char *image;
+
+    /*! size of the index image */
+    size_t len;
+
+    /*! true if the image is a file mapped by VARCREATE_IndexOpen */
+    bool mapped;
+
+};
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int varindex_fnBuild( VARCREATE_INDEX hIndex );
+
+static int varindex_fnCompare( const void *p1, const void *p2 );
+
+static VAR_HANDLE varindex_fnSearch( const char *image, const char *name );
+
+static int varindex_fnCheck( const char *data, size_t len );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  VARCREATE_IndexCreate                                                     */
+/*!
+    Create an empty handle index
+
+    The VARCREATE_IndexCreate function creates an index to be set in the
+    index member of the VarCreateOptions object.  Every variable and
+    alias created by the loads made with those options is added to it.
+
+    @retval handle to the new index
+    @retval NULL if the index could not be created
+
+==============================================================================*/
+VARCREATE_INDEX VARCREATE_IndexCreate( void )
+{
+    VARCREATE_INDEX hIndex;
+
+    hIndex = calloc( 1, sizeof( struct _VarCreateIndex ) );
+    if ( hIndex != NULL )
+    {
+        pthread_mutex_init( &hIndex->lock, NULL );
+    }
+
+    return hIndex;
+}
+
+/*============================================================================*/
+/*  VARCREATE_IndexWrite                                                      */
+/*!
+    Write a handle index to a file
+
+    The VARCREATE_IndexWrite function writes the names and handles
+    added to the index, sorted by name, to a file which can be opened
+    with VARCREATE_IndexOpen.  The file is replaced atomically, so
+    clients never see a partially written index.  If a name was added
+    more than once, the most recent handle is kept.
+
+    @param[in]
+        hIndex
+            handle to the index created by VARCREATE_IndexCreate
+
+    @param[in]
+        filename
+            name of the index file to write
+
+    @retval EOK - the index was written
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval EIO - the index could not be written
+
+==============================================================================*/
+int VARCREATE_IndexWrite( VARCREATE_INDEX hIndex, char *filename )
+{
+    int result = EINVAL;
+    char *tmpname;
+    size_t len;
+    FILE *fp;
+    int rc;
+
+    if ( ( hIndex != NULL ) &&
+         ( filename != NULL ) &&
+         ( hIndex->mapped == false ) )
+    {
+        pthread_mutex_lock( &hIndex->lock );
+
+        result = varindex_fnBuild( hIndex );
+        if ( result == EOK )
+        {
+            result = ENOMEM;
+
+            len = strlen( filename ) + sizeof( ".tmp" );
+            tmpname = malloc( len );
+            if ( tmpname != NULL )
+            {
+                snprintf( tmpname, len, "%s.tmp", filename );
+
+                result = EIO;
+
+                fp = fopen( tmpname, "w" );
+                if ( fp != NULL )
+                {
+                    rc = ( fwrite( hIndex->image, 1, hIndex->len, fp )
+                            == hIndex->len ) ? 0 : EIO;
+
+                    if ( fclose( fp ) != 0 )
+                    {
+                        rc = EIO;
+                    }
+
+                    if ( ( rc == 0 ) &&
+                         ( rename( tmpname, filename ) == 0 ) )
+                    {
+                        result = EOK;
+                    }
+                    else
+                    {
+                        unlink( tmpname );
+                    }
+                }
+
+                free( tmpname );
+            }
+        }
+
+        pthread_mutex_unlock( &hIndex->lock );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_IndexOpen                                                       */
+/*!
+    Open a handle index file
+
+    The VARCREATE_IndexOpen function maps an index file written by
+    VARCREATE_IndexWrite into memory so it can be searched with
+    VARCREATE_IndexFind.  The mapping is shared by every process which
+    opens the same file.
+
+    @param[in]
+        filename
+            name of the index file
+
+    @retval handle to the open index
+    @retval NULL if the file could not be opened or is not a valid index
+
+==============================================================================*/
+VARCREATE_INDEX VARCREATE_IndexOpen( char *filename )
+{
+    VARCREATE_INDEX hIndex = NULL;
+    struct stat st;
+    size_t len;
+    void *p;
+    int fd;
+
+    if ( filename != NULL )
+    {
+        fd = open( filename, O_RDONLY );
+        if ( fd != -1 )
+        {
+            if ( ( fstat( fd, &st ) == 0 ) &&
+                 ( S_ISREG( st.st_mode ) ) &&
+                 ( (size_t)st.st_size >= sizeof( VarIndexHeader ) ) )
+            {
+                len = st.st_size;
+                p = mmap( NULL, len, PROT_READ, MAP_SHARED, fd, 0 );
+                if ( p != MAP_FAILED )
+                {
+                    if ( varindex_fnCheck( (const char *)p, len ) == EOK )
+                    {
+                        hIndex = calloc( 1, sizeof( struct _VarCreateIndex ) );
+                    }
+
+                    if ( hIndex != NULL )
+                    {
+                        pthread_mutex_init( &hIndex->lock, NULL );
+                        hIndex->image = (char *)p;
+                        hIndex->len = len;
+                        hIndex->mapped = true;
+                    }
+                    else
+                    {
+                        munmap( p, len );
+                    }
+                }
+            }
+
+            close( fd );
+        }
+    }
+
+    return hIndex;
+}
+
+/*============================================================================*/
+/*  VARCREATE_IndexFind                                                       */
+/*!
+    Find the handle of a variable in a handle index
+
+    The VARCREATE_IndexFind function searches the index for a variable
+    or alias name, without a request to the variable server.  Searching
+    an open index file is lock free.  An index which is still being
+    built is sorted on the first search after each addition.
+
+    @param[in]
+        hIndex
+            handle to the index
+
+    @param[in]
+        name
+            NUL terminated name of the variable or alias to find
+
+    @retval handle of the variable
+    @retval VAR_INVALID if the name is not in the index
+
+==============================================================================*/
+VAR_HANDLE VARCREATE_IndexFind( VARCREATE_INDEX hIndex, const char *name )
+{
+    VAR_HANDLE hVar = VAR_INVALID;
+
+    if ( ( hIndex != NULL ) &&
+         ( name != NULL ) )
+    {
+        if ( hIndex->mapped == true )
+        {
+            hVar = varindex_fnSearch( hIndex->image, name );
+        }
+        else
+        {
+            pthread_mutex_lock( &hIndex->lock );
+
+            if ( varindex_fnBuild( hIndex ) == EOK )
+            {
+                hVar = varindex_fnSearch( hIndex->image, name );
+            }
+
+            pthread_mutex_unlock( &hIndex->lock );
+        }
+    }
+
+    return hVar;
+}
+
+/*============================================================================*/
+/*  VARCREATE_IndexCount                                                      */
+/*!
+    Get the number of names in a handle index
+
+    @param[in]
+        hIndex
+            handle to the index
+
+    @retval number of distinct variable and alias names in the index
+
+==============================================================================*/
+size_t VARCREATE_IndexCount( VARCREATE_INDEX hIndex )
+{
+    size_t count = 0;
+
+    if ( hIndex != NULL )
+    {
+        pthread_mutex_lock( &hIndex->lock );
+
+        if ( ( hIndex->mapped == true ) ||
+             ( varindex_fnBuild( hIndex ) == EOK ) )
+        {
+            count = ( (const VarIndexHeader *)hIndex->image )->count;
+        }
+
+        pthread_mutex_unlock( &hIndex->lock );
+    }
+
+    return count;
+}
+
+/*============================================================================*/
+/*  VARCREATE_IndexDestroy                                                    */
+/*!
+    Release a handle index
+
+    The VARCREATE_IndexDestroy function releases an index created by
+    VARCREATE_IndexCreate or opened by VARCREATE_IndexOpen.  No load may
+    be using the index.
+
+    @param[in]
+        hIndex
+            handle to the index
+
+==============================================================================*/
+void VARCREATE_IndexDestroy( VARCREATE_INDEX hIndex )
+{
+    if ( hIndex != NULL )
+    {
+        if ( hIndex->mapped == true )
+        {
+            munmap( hIndex->image, hIndex->len );
+        }
+        else
+        {
+            free( hIndex->image );
+        }
+
+        free( hIndex->entries );
+        free( hIndex->strings );
+        pthread_mutex_destroy( &hIndex->lock );
+        free( hIndex );
+    }
+}
+
+/*============================================================================*/
+/*  varindex_Add                                                              */
+/*!
+    Add a variable or alias to a handle index
+
+    The varindex_Add function records the name and handle of a variable
+    or alias which has just been created.  It may be called from several
+    threads at once.  If the entry cannot be stored, the index remembers
+    the failure so it is not written incomplete.
+
+    @param[in]
+        hIndex
+            handle to the index, or NULL
+
+    @param[in]
+        name
+            NUL terminated name of the variable or alias
+
+    @param[in]
+        hVar
+            handle of the variable
+
+==============================================================================*/
+void varindex_Add( VARCREATE_INDEX hIndex, const char *name, VAR_HANDLE hVar )
+{
+    VarIndexEntry *entries;
+    char *strings;
+    size_t size;
+    size_t len;
+
+    if ( ( hIndex != NULL ) &&
+         ( name != NULL ) &&
+         ( hVar != VAR_INVALID ) &&
+         ( hIndex->mapped == false ) )
+    {
+        len = strlen( name ) + 1;
+
+        pthread_mutex_lock( &hIndex->lock );
+
+        if ( hIndex->count == hIndex->size )
+        {
+            size = ( hIndex->size == 0 ) ? VARINDEX_INITIAL_SIZE
+                                         : hIndex->size * 2;
+            entries = realloc( hIndex->entries,
+                               size * sizeof( VarIndexEntry ) );
+            if ( entries != NULL )
+            {
+                hIndex->entries = entries;
+                hIndex->size = size;
+            }
+        }
+
+        if ( hIndex->strlen + len > hIndex->strsize )
+        {
+            size = ( hIndex->strsize == 0 ) ? VARINDEX_INITIAL_STRSIZE
+                                            : hIndex->strsize * 2;
+            while ( size < hIndex->strlen + len )
+            {
+                size *= 2;
+            }
+
+            strings = realloc( hIndex->strings, size );
+            if ( strings != NULL )
+            {
+                hIndex->strings = strings;
+                hIndex->strsize = size;
+            }
+        }
+
+        if ( ( hIndex->count < hIndex->size ) &&
+             ( hIndex->strlen + len <= hIndex->strsize ) )
+        {
+            memcpy( &hIndex->strings[hIndex->strlen], name, len );
+            hIndex->entries[hIndex->count].name = hIndex->strlen;
+            hIndex->entries[hIndex->count].hVar = hVar;
+            hIndex->strlen += len;
+            hIndex->count++;
+
+            /* the image must be sorted again */
+            free( hIndex->image );
+            hIndex->image = NULL;
+        }
+        else
+        {
+            hIndex->result = ENOMEM;
+        }
+
+        pthread_mutex_unlock( &hIndex->lock );
+    }
+}
+
+/*============================================================================*/
+/*  varindex_fnBuild                                                          */
+/*!
+    Build the sorted image of a handle index
+
+    The varindex_fnBuild function sorts the entries added to the index
+    by name, drops all but the most recent entry of each name, and lays
+    out the header, entries and string table exactly as they are stored
+    in the index file.  The string table holds the names in sorted
+    order, so a search touches neighboring memory.  The image is kept
+    until the next entry is added.  The caller holds the index lock.
+
+    @param[in]
+        hIndex
+            handle to the index
+
+    @retval EOK - the image was built
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varindex_fnBuild( VARCREATE_INDEX hIndex )
+{
+    int result = hIndex->result;
+    VarIndexHeader *pHeader;
+    VarIndexEntry *pEntries;
+    VarIndexSort *sort;
+    char *strings;
+    size_t strsize;
+    size_t count;
+    size_t len;
+    size_t i;
+
+    if ( ( result == EOK ) &&
+         ( hIndex->image == NULL ) )
+    {
+        result = ENOMEM;
+
+        sort = malloc( ( hIndex->count + 1 ) * sizeof( VarIndexSort ) );
+        if ( sort != NULL )
+        {
+            for ( i = 0 ; i < hIndex->count ; i++ )
+            {
+                sort[i].name = &hIndex->strings[hIndex->entries[i].name];
+                sort[i].hVar = hIndex->entries[i].hVar;
+                sort[i].seq = i;
+            }
+
+            qsort( sort, hIndex->count, sizeof( VarIndexSort ),
+                   varindex_fnCompare );
+
+            /* keep the last of each run of equal names */
+            count = 0;
+            strsize = 0;
+            for ( i = 0 ; i < hIndex->count ; i++ )
+            {
+                if ( ( i + 1 == hIndex->count ) ||
+                     ( strcmp( sort[i].name, sort[i + 1].name ) != 0 ) )
+                {
+                    sort[count++] = sort[i];
+                    strsize += strlen( sort[i].name ) + 1;
+                }
+            }
+
+            hIndex->len = sizeof( VarIndexHeader ) +
+                          count * sizeof( VarIndexEntry ) +
+                          strsize;
+
+            hIndex->image = calloc( 1, hIndex->len );
+            if ( hIndex->image != NULL )
+            {
+                pHeader = (VarIndexHeader *)hIndex->image;
+                pEntries = (VarIndexEntry *)( &pHeader[1] );
+                strings = (char *)( &pEntries[count] );
+
+                memcpy( pHeader->magic,
+                        VARINDEX_MAGIC,
+                        sizeof( pHeader->magic ) );
+                pHeader->version = VARINDEX_VERSION;
+                pHeader->count = count;
+                pHeader->strsize = strsize;
+
+                strsize = 0;
+                for ( i = 0 ; i < count ; i++ )
+                {
+                    len = strlen( sort[i].name ) + 1;
+                    memcpy( &strings[strsize], sort[i].name, len );
+                    pEntries[i].name = strsize;
+                    pEntries[i].hVar = sort[i].hVar;
+                    strsize += len;
+                }
+
+                result = EOK;
+            }
+
+            free( sort );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varindex_fnCompare                                                        */
+/*!
+    Order two entries being sorted into an index image
+
+    Entries are ordered by name, and entries with the same name by the
+    order in which they were added.
+
+    @param[in]
+        p1
+            pointer to the first VarIndexSort object
+
+    @param[in]
+        p2
+            pointer to the second VarIndexSort object
+
+    @retval <0 - the first entry comes first
+    @retval >0 - the second entry comes first
+
+==============================================================================*/
+static int varindex_fnCompare( const void *p1, const void *p2 )
+{
+    const VarIndexSort *a = (const VarIndexSort *)p1;
+    const VarIndexSort *b = (const VarIndexSort *)p2;
+    int result;
+
+    result = strcmp( a->name, b->name );
+    if ( result == 0 )
+    {
+        result = ( a->seq < b->seq ) ? -1 : 1;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varindex_fnSearch                                                         */
+/*!
+    Search a sorted index image for a name
+
+    @param[in]
+        image
+            pointer to a valid index image
+
+    @param[in]
+        name
+            NUL terminated name to search for
+
+    @retval handle of the variable
+    @retval VAR_INVALID if the name is not in the image
+
+==============================================================================*/
+static VAR_HANDLE varindex_fnSearch( const char *image, const char *name )
+{
+    VAR_HANDLE hVar = VAR_INVALID;
+    const VarIndexHeader *pHeader = (const VarIndexHeader *)image;
+    const VarIndexEntry *pEntries = (const VarIndexEntry *)( &pHeader[1] );
+    const char *strings = (const char *)( &pEntries[pHeader->count] );
+    size_t lo = 0;
+    size_t hi = pHeader->count;
+    size_t mid;
+    int rc;
+
+    while ( lo < hi )
+    {
+        mid = lo + ( hi - lo ) / 2;
+        rc = strcmp( &strings[pEntries[mid].name], name );
+        if ( rc < 0 )
+        {
+            lo = mid + 1;
+        }
+        else if ( rc > 0 )
+        {
+            hi = mid;
+        }
+        else
+        {
+            hVar = pEntries[mid].hVar;
+            break;
+        }
+    }
+
+    return hVar;
+}
+
+/*============================================================================*/
+/*  varindex_fnCheck                                                          */
+/*!
+    Validate an index image
+
+    The varindex_fnCheck function checks the index header against the
+    size of the image, and checks that every name lies within the
+    string table, so the image can be searched without further bounds
+    checks.
+
+    @param[in]
+        data
+            pointer to the index image
+
+    @param[in]
+        len
+            size of the index image
+
+    @retval EOK - the index is valid
+    @retval EBADMSG - the index is not valid
+
+==============================================================================*/
+static int varindex_fnCheck( const char *data, size_t len )
+{
+    int result = EBADMSG;
+    const VarIndexHeader *pHeader = (const VarIndexHeader *)data;
+    const VarIndexEntry *pEntries;
+    uint64_t expected;
+    size_t i;
+
+    expected = (uint64_t)sizeof( VarIndexHeader ) +
+               (uint64_t)pHeader->count * sizeof( VarIndexEntry ) +
+               pHeader->strsize;
+
+    if ( ( memcmp( pHeader->magic,
+                   VARINDEX_MAGIC,
+                   sizeof( pHeader->magic ) ) == 0 ) &&
+         ( pHeader->version == VARINDEX_VERSION ) &&
+         ( expected == len ) &&
+         ( ( pHeader->strsize == 0 ) || ( data[len - 1] == '\0' ) ) )
+    {
+        result = EOK;
+
+        pEntries = (const VarIndexEntry *)( &pHeader[1] );
+        for ( i = 0 ; ( result == EOK ) && ( i < pHeader->count ) ; i++ )
+        {
+            if ( pEntries[i].name >= pHeader->strsize )
+            {
+                result = EBADMSG;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*! @}
+ * end of libvarcreate group */
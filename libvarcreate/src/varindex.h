@@ -0,0 +1,88 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARINDEX_H
+#define VARINDEX_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdint.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! identifies a varcreate handle index file */
+#define VARINDEX_MAGIC                  "VCX1"
+
+/*! version of the index layout */
+#define VARINDEX_VERSION                ( 1 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! The VarIndexHeader object is at the start of every index file.  It is
+    followed by the entries, sorted by name, then the string table.  All
+    values are stored in the byte order of the machine which wrote the
+    index */
+typedef struct _VarIndexHeader
+{
+    /*! identifies the file as a handle index */
+    char magic[4];
+
+    /*! version of the index layout */
+    uint32_t version;
+
+    /*! number of entries */
+    uint32_t count;
+
+    /*! size of the string table in bytes */
+    uint32_t strsize;
+
+} VarIndexHeader;
+
+/*! The VarIndexEntry object associates a variable or alias name with
+    the handle of its variable */
+typedef struct _VarIndexEntry
+{
+    /*! offset of the name in the string table */
+    uint32_t name;
+
+    /*! handle of the variable */
+    uint32_t hVar;
+
+} VarIndexEntry;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+void varindex_Add( VARCREATE_INDEX hIndex, const char *name, VAR_HANDLE hVar );
+
+#endif
@@ -0,0 +1,218 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARLOAD_H
+#define VARLOAD_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "vararena.h"
+#include "varmemo.h"
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! the variables created by a pass of a prioritized load */
+typedef enum _VarLoadTier
+{
+    /*! create every variable */
+    VARLOAD_TIER_ALL = 0,
+
+    /*! create only the critical variables */
+    VARLOAD_TIER_CRITICAL,
+
+    /*! create only the variables which are not critical */
+    VARLOAD_TIER_NORMAL
+
+} VarLoadTier;
+
+/*! an alias waiting to be created for a variable */
+typedef VarCreateAlias VarAlias;
+
+/*! where an alias waiting to be created was defined, so a failure can
+    be reported against its config file */
+typedef struct _VarAliasOrigin
+{
+    /*! name of the config file, or NULL for a string or a stream */
+    const char *filename;
+
+    /*! index of the variable definition in the input */
+    size_t index;
+
+} VarAliasOrigin;
+
+/*! The VarAliasList object collects aliases so they can be created
+    after all of the primary variables have been created */
+typedef struct _VarAliasList
+{
+    /*! array of aliases */
+    VarAlias *aliases;
+
+    /*! array of the origins of the aliases, in the same order */
+    VarAliasOrigin *origins;
+
+    /*! number of aliases in the list */
+    size_t count;
+
+    /*! number of aliases the list can hold before it must grow */
+    size_t size;
+
+} VarAliasList;
+
+/*! The VarLoad object holds the state of a variable load from one or
+    more varcreate JSON documents */
+typedef struct _VarLoad
+{
+    /*! handle to the Variable Server to create variables for */
+    VARSERVER_HANDLE hVarServer;
+
+    /*! options used to modify the variable creation behavior */
+    VarCreateOptions *options;
+
+    /*! length of the variable name prefix, or 0 if there is none */
+    size_t prefixLen;
+
+    /*! pointer to the variable batch, or NULL if batching is disabled */
+    struct _VarBatch *pBatch;
+
+    /*! pointer to the pipeline which creates the variables on a
+        separate thread, or NULL to create them on the calling thread */
+    struct _VarPipe *pPipe;
+
+    /*! pointer to a list to collect aliases into so they can be created
+        once all of the primary variables exist, or NULL to create each
+        alias as soon as its variable has been created */
+    VarAliasList *pAliases;
+
+    /*! aliases deferred by the deferAliases option, which are created
+        by varcreate_fnLoadAliases */
+    VarAliasList aliases;
+
+    /*! pointer to a snapshot writer to store the variables and aliases
+        in instead of creating them, or NULL to create the variables */
+    struct _VarSnapWriter *pSnapshot;
+
+    /*! pointer to a duplicate check to record the variables and aliases
+        in instead of creating them, or NULL to create the variables */
+    struct _VarCheck *pCheck;
+
+    /*! pointer to the cache used to skip unchanged files, or NULL */
+    struct _VarCache *pCache;
+
+    /*! the variables created by the current pass of the load */
+    VarLoadTier tier;
+
+    /*! name of the config file being loaded, or NULL for a string or
+        a stream */
+    const char *filename;
+
+    /*! index of the current variable definition in the input */
+    size_t index;
+
+    /*! handle of the first variable created from the current file.
+        With a pipeline, it is written by the creator thread, and the
+        thread reading the file only accesses it while the creator
+        thread is idle */
+    VAR_HANDLE hFirst;
+
+    /*! hFirst is known to be valid, so the thread reading the file
+        need not wait for the creator thread to check it again */
+    bool hasFirst;
+
+    /*! name of the first variable created from the current file */
+    char firstName[MAX_NAME_LEN+1];
+
+    /*! arena holding the parsed cJSON trees of this load */
+    VarArena arena;
+
+    /*! number of parsed cJSON trees which have not yet been deleted.
+        The arena is reset whenever this drops to zero */
+    size_t trees;
+
+    /*! position in the JSON text at which the last parse of this load
+        stopped.  Unlike cJSON_GetErrorPtr, this is private to the load,
+        so concurrent loads do not report each other's errors */
+    const char *parseEnd;
+
+    /*! the "defaults" object of the current file, whose attributes
+        are applied to every variable which does not specify them, or
+        NULL if the file has no defaults */
+    struct cJSON *defaults;
+
+    /*! converted values of the repetitive attribute strings */
+    VarMemo memo;
+
+    /*! true if the load is gathering statistics */
+    bool timing;
+
+    /*! statistics of the current file, which are added to the
+        statistics of the options once the file has been loaded */
+    VarCreateStats stats;
+
+} VarLoad;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+int varcreate_fnLoadBegin( VarLoad *pLoad,
+                           VARSERVER_HANDLE hVarServer,
+                           VarCreateOptions *options );
+
+int varcreate_fnLoadFile( VarLoad *pLoad, char *filename );
+
+int varcreate_fnLoadAliases( VarLoad *pLoad );
+
+int varcreate_fnLoadReady( VarLoad *pLoad );
+
+void varcreate_fnLoadEnd( VarLoad *pLoad );
+
+int varcreate_fnAddAlias( VarAliasList *pAliases,
+                          VAR_HANDLE hVar,
+                          const char *name,
+                          const char *filename,
+                          size_t index );
+
+int varcreate_fnCreateAliases( VARSERVER_HANDLE hVarServer,
+                               VarAliasList *pAliases,
+                               VarCreateOptions *options,
+                               struct _VarCache *pCache,
+                               VarCreateStats *pStats );
+
+void varcreate_fnFreeAliases( VarAliasList *pAliases );
+
+uint64_t varcreate_fnNow( void );
+
+void varcreate_fnAddStats( VarCreateOptions *options,
+                           const VarCreateStats *pStats );
+
+#endif
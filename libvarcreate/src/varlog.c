@@ -0,0 +1,235 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+/*============================================================================*/
+/*!
+@file varlog.c
+
+    Variable Creation message log and result reporting
+
+    The progress and error messages of the library are collected in a
+    buffer and written to the standard output together at the end of
+    each input, rather than one line at a time.  When the standard
+    output is a terminal or a serial console, writing every message as
+    it is produced can take longer than creating the variables.
+
+    Failures are also passed, one record at a time, to the report
+    function of the load options, so an application can collect them
+    without parsing the messages.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <varcreate/libvarcreate.h>
+#include "varlog.h"
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! messages waiting to be written */
+static char varlog_buffer[VARLOG_BUFFER_SIZE];
+
+/*! number of characters in the message buffer */
+static size_t varlog_len;
+
+/*! serializes access to the message buffer */
+static pthread_mutex_t varlog_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*! serializes calls to the report functions */
+static pthread_mutex_t varlog_reportLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static void varlog_fnWrite( void );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varlog_Printf                                                             */
+/*!
+    Add a message to the message buffer
+
+    The varlog_Printf function formats a message into the message
+    buffer.  If the message does not fit behind the messages already in
+    the buffer, they are written out first.  A message longer than the
+    buffer is truncated.
+
+    @param[in]
+        options
+            pointer to the options of the load.  Nothing is done if
+            the quiet option is set
+
+    @param[in]
+        fmt
+            printf style format of the message
+
+==============================================================================*/
+void varlog_Printf( const VarCreateOptions *options, const char *fmt, ... )
+{
+    va_list args;
+    size_t space;
+    int n;
+
+    if ( ( options != NULL ) &&
+         ( options->quiet == false ) )
+    {
+        pthread_mutex_lock( &varlog_lock );
+
+        space = VARLOG_BUFFER_SIZE - varlog_len;
+
+        va_start( args, fmt );
+        n = vsnprintf( &varlog_buffer[varlog_len], space, fmt, args );
+        va_end( args );
+
+        if ( ( n > 0 ) &&
+             ( (size_t)n >= space ) &&
+             ( varlog_len > 0 ) )
+        {
+            /* make room for the message */
+            varlog_fnWrite();
+            space = VARLOG_BUFFER_SIZE;
+
+            va_start( args, fmt );
+            n = vsnprintf( varlog_buffer, space, fmt, args );
+            va_end( args );
+        }
+
+        if ( n > 0 )
+        {
+            varlog_len += ( (size_t)n < space ) ? (size_t)n : space - 1;
+        }
+
+        pthread_mutex_unlock( &varlog_lock );
+    }
+}
+
+/*============================================================================*/
+/*  varlog_Flush                                                              */
+/*!
+    Write out the messages in the message buffer
+
+==============================================================================*/
+void varlog_Flush( void )
+{
+    pthread_mutex_lock( &varlog_lock );
+    varlog_fnWrite();
+    pthread_mutex_unlock( &varlog_lock );
+}
+
+/*============================================================================*/
+/*  varlog_Report                                                             */
+/*!
+    Pass a failure to the report function of the load options
+
+    The report function may be shared by the threads of a load, so it
+    is only called by one thread at a time.
+
+    @param[in]
+        options
+            pointer to the options of the load.  Nothing is done if
+            the options have no report function
+
+    @param[in]
+        filename
+            name of the config file, or NULL
+
+    @param[in]
+        index
+            index of the variable definition in its input
+
+    @param[in]
+        name
+            name of the variable or alias which failed
+
+    @param[in]
+        attribute
+            name of the attribute which failed, or NULL
+
+    @param[in]
+        result
+            error number describing the failure
+
+==============================================================================*/
+void varlog_Report( const VarCreateOptions *options,
+                    const char *filename,
+                    size_t index,
+                    const char *name,
+                    const char *attribute,
+                    int result )
+{
+    VarCreateResult record;
+
+    if ( ( options != NULL ) &&
+         ( options->report != NULL ) )
+    {
+        record.filename = filename;
+        record.index = index;
+        record.name = name;
+        record.attribute = attribute;
+        record.result = result;
+
+        pthread_mutex_lock( &varlog_reportLock );
+        options->report( options->reportArg, &record );
+        pthread_mutex_unlock( &varlog_reportLock );
+    }
+}
+
+/*============================================================================*/
+/*  varlog_fnWrite                                                            */
+/*!
+    Write the message buffer to the standard output
+
+    The messages go through the stdio stream so they stay in order with
+    anything the application prints.  The caller holds the lock.
+
+==============================================================================*/
+static void varlog_fnWrite( void )
+{
+    if ( varlog_len > 0 )
+    {
+        fwrite( varlog_buffer, 1, varlog_len, stdout );
+        fflush( stdout );
+        varlog_len = 0;
+    }
+}
+
+/*! @}
+ * end of libvarcreate group */
@@ -0,0 +1,59 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARLOG_H
+#define VARLOG_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stddef.h>
+#include <varcreate/libvarcreate.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! size of the buffer which collects the messages of the library.  The
+    buffer is written out whenever the next message does not fit */
+#define VARLOG_BUFFER_SIZE              ( 16384 )
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+void varlog_Printf( const VarCreateOptions *options, const char *fmt, ... )
+    __attribute__ ((format (printf, 2, 3)));
+
+void varlog_Flush( void );
+
+void varlog_Report( const VarCreateOptions *options,
+                    const char *filename,
+                    size_t index,
+                    const char *name,
+                    const char *attribute,
+                    int result );
+
+#endif
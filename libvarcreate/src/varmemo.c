@@ -0,0 +1,282 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+/*============================================================================*/
+/*!
+@file varmemo.c
+
+    Variable Creation attribute memo table
+
+    The attribute memo table remembers what the repetitive attribute
+    strings of a config file were converted to.  Large config files
+    typically use a handful of distinct type names, flag strings and
+    permission specifiers across thousands of variables, so looking
+    the converted value up in a small hash table is much cheaper than
+    calling the variable server conversion functions for every
+    variable.
+
+    The table has a fixed number of slots and is never resized.  Once
+    it is three quarters full, strings which are not already in the
+    table are simply converted every time.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <varcreate/libvarcreate.h>
+#include "varmemo.h"
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static uint32_t varmemo_fnHash( int attr, const char *key );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varmemo_Init                                                              */
+/*!
+    Initialize an empty memo table
+
+    @param[in]
+        pMemo
+            pointer to the memo table to initialize
+
+==============================================================================*/
+void varmemo_Init( VarMemo *pMemo )
+{
+    memset( pMemo, 0, sizeof( VarMemo ) );
+}
+
+/*============================================================================*/
+/*  varmemo_Find                                                              */
+/*!
+    Look up the converted value of an attribute string
+
+    @param[in]
+        pMemo
+            pointer to the memo table
+
+    @param[in]
+        attr
+            attribute which the string is the value of
+
+    @param[in]
+        key
+            pointer to the NUL terminated attribute string
+
+    @retval pointer to the converted value
+    @retval NULL if the string has not been stored in the table
+
+==============================================================================*/
+const VarMemoValue *varmemo_Find( VarMemo *pMemo,
+                                  int attr,
+                                  const char *key )
+{
+    const VarMemoValue *pValue = NULL;
+    VarMemoEntry *pEntry;
+    uint32_t hash;
+    size_t i;
+
+    if ( ( pMemo != NULL ) &&
+         ( key != NULL ) &&
+         ( pMemo->count > 0 ) )
+    {
+        hash = varmemo_fnHash( attr, key );
+        i = hash & ( VARMEMO_SIZE - 1 );
+
+        /* the table is never full, so the probe ends at an empty slot */
+        while ( ( pEntry = pMemo->entries[i] ) != NULL )
+        {
+            if ( ( pEntry->hash == hash ) &&
+                 ( pEntry->attr == attr ) &&
+                 ( strcmp( pEntry->key, key ) == 0 ) )
+            {
+                pValue = &pEntry->value;
+                break;
+            }
+
+            i = ( i + 1 ) & ( VARMEMO_SIZE - 1 );
+        }
+    }
+
+    return pValue;
+}
+
+/*============================================================================*/
+/*  varmemo_Add                                                               */
+/*!
+    Store the converted value of an attribute string
+
+    The string is copied, so it need not outlive the call.  The caller
+    is expected to have checked that the string is not already in the
+    table using varmemo_Find.
+
+    @param[in]
+        pMemo
+            pointer to the memo table
+
+    @param[in]
+        attr
+            attribute which the string is the value of
+
+    @param[in]
+        key
+            pointer to the NUL terminated attribute string
+
+    @param[in]
+        pValue
+            pointer to the value converted from the string
+
+    @retval EOK - the value was stored
+    @retval ENOSPC - the table is full
+    @retval ENOMEM - memory allocation failed
+    @retval EINVAL - invalid arguments
+
+==============================================================================*/
+int varmemo_Add( VarMemo *pMemo,
+                 int attr,
+                 const char *key,
+                 const VarMemoValue *pValue )
+{
+    int result = EINVAL;
+    VarMemoEntry *pEntry;
+    uint32_t hash;
+    size_t len;
+    size_t i;
+
+    if ( ( pMemo != NULL ) &&
+         ( key != NULL ) &&
+         ( pValue != NULL ) )
+    {
+        if ( pMemo->count < VARMEMO_MAX_ENTRIES )
+        {
+            len = strlen( key );
+            pEntry = malloc( sizeof( VarMemoEntry ) + len + 1 );
+            if ( pEntry != NULL )
+            {
+                hash = varmemo_fnHash( attr, key );
+                pEntry->hash = hash;
+                pEntry->attr = attr;
+                pEntry->value = *pValue;
+                memcpy( pEntry->key, key, len + 1 );
+
+                i = hash & ( VARMEMO_SIZE - 1 );
+                while ( pMemo->entries[i] != NULL )
+                {
+                    i = ( i + 1 ) & ( VARMEMO_SIZE - 1 );
+                }
+
+                pMemo->entries[i] = pEntry;
+                pMemo->count++;
+
+                result = EOK;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+        else
+        {
+            result = ENOSPC;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varmemo_Free                                                              */
+/*!
+    Release all of the entries of a memo table
+
+    The table is left empty and ready for reuse.
+
+    @param[in]
+        pMemo
+            pointer to the memo table to release
+
+==============================================================================*/
+void varmemo_Free( VarMemo *pMemo )
+{
+    size_t i;
+
+    if ( pMemo != NULL )
+    {
+        for ( i = 0 ; i < VARMEMO_SIZE ; i++ )
+        {
+            free( pMemo->entries[i] );
+            pMemo->entries[i] = NULL;
+        }
+
+        pMemo->count = 0;
+    }
+}
+
+/*============================================================================*/
+/*  varmemo_fnHash                                                            */
+/*!
+    Calculate the FNV-1a hash of an attribute string
+
+    @param[in]
+        attr
+            attribute which the string is the value of
+
+    @param[in]
+        key
+            pointer to the NUL terminated attribute string
+
+    @retval the hash of the attribute and the string
+
+==============================================================================*/
+static uint32_t varmemo_fnHash( int attr, const char *key )
+{
+    uint32_t hash = 2166136261u;
+
+    hash = ( hash ^ (uint8_t)attr ) * 16777619u;
+
+    while ( *key != '\0' )
+    {
+        hash = ( hash ^ (uint8_t)*key++ ) * 16777619u;
+    }
+
+    return hash;
+}
+
+/*! @}
+ * end of libvarcreate group */
@@ -0,0 +1,122 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARMEMO_H
+#define VARMEMO_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <varserver/varserver.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! number of slots in the memo table.  This must be a power of two */
+#define VARMEMO_SIZE                    ( 256 )
+
+/*! maximum number of entries stored in the memo table.  Once the table
+    is this full, new strings are converted every time they are seen */
+#define VARMEMO_MAX_ENTRIES             ( VARMEMO_SIZE * 3 / 4 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! converted value of an attribute string */
+typedef union _VarMemoValue
+{
+    /*! variable type converted from a type name */
+    VarType type;
+
+    /*! variable flags converted from a flags string */
+    uint32_t flags;
+
+    /*! group list converted from a permission specifier */
+    struct
+    {
+        /*! number of groups in the list */
+        size_t n;
+
+        /*! groups in the list */
+        gid_t gids[VARSERVER_MAX_UIDS];
+    } perms;
+
+} VarMemoValue;
+
+/*! a converted attribute string stored in the memo table */
+typedef struct _VarMemoEntry
+{
+    /*! hash of the attribute and the string */
+    uint32_t hash;
+
+    /*! attribute which the string was the value of */
+    int attr;
+
+    /*! value converted from the string */
+    VarMemoValue value;
+
+    /*! copy of the string, which must outlive the parsed tree it came from */
+    char key[];
+
+} VarMemoEntry;
+
+/*! The VarMemo object remembers the result of converting the attribute
+    strings which repeat across the variables of a load, such as type
+    names, flags and permission specifiers, so that each distinct
+    string is only converted once.  A memo table must only be used by
+    one thread at a time */
+typedef struct _VarMemo
+{
+    /*! open addressed table of entries */
+    VarMemoEntry *entries[VARMEMO_SIZE];
+
+    /*! number of entries in the table */
+    size_t count;
+
+} VarMemo;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+void varmemo_Init( VarMemo *pMemo );
+
+const VarMemoValue *varmemo_Find( VarMemo *pMemo,
+                                  int attr,
+                                  const char *key );
+
+int varmemo_Add( VarMemo *pMemo,
+                 int attr,
+                 const char *key,
+                 const VarMemoValue *pValue );
+
+void varmemo_Free( VarMemo *pMemo );
+
+#endif
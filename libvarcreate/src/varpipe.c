@@ -0,0 +1,542 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+/*============================================================================*/
+/*!
+@file varpipe.c
+
+    Variable Creation pipeline
+
+    The pipeline overlaps the parsing of a config file with the creation
+    of its variables.  The thread which reads the input parses each
+    variable definition and builds its VarInfo object directly into the
+    next free slot of a ring, while a creator thread submits the queued
+    variables to the variable server, so the parse cost is hidden behind
+    the variable server round trips.
+
+    The ring has exactly one producer and one consumer, so each index is
+    only ever written by one thread and no lock is needed to queue or
+    dequeue a variable.  A thread only takes the mutex to sleep when the
+    ring is full or empty, and the other thread only takes it to wake a
+    thread which is known to be sleeping.
+
+    Variables are created, and their outcomes reported, in the order
+    they were queued.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <varcreate/libvarcreate.h>
+#include "varpipe.h"
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static void *varpipe_fnCreator( void *arg );
+
+static void varpipe_fnWaitCreated( VarPipe *pPipe, size_t tail );
+
+static void varpipe_fnWaitQueued( VarPipe *pPipe, size_t head );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varpipe_Init                                                              */
+/*!
+    Initialize a pipeline and start its creator thread
+
+    @param[in]
+        pPipe
+            pointer to the pipeline to initialize
+
+    @param[in]
+        depth
+            number of variables which can be waiting to be created.
+            This is rounded up to a power of two.  Set to 0 to use
+            VARPIPE_DEFAULT_DEPTH
+
+    @param[in]
+        batchSize
+            maximum number of variables to pass to the callback at once
+
+    @param[in]
+        fn
+            callback which creates a run of queued variables
+
+    @param[in]
+        arg
+            opaque argument to pass to the callback
+
+    @retval EOK - the pipeline was started
+    @retval ENOMEM - memory allocation problem
+    @retval EINVAL - invalid arguments
+    @retval other - the creator thread could not be started
+
+==============================================================================*/
+int varpipe_Init( VarPipe *pPipe,
+                  size_t depth,
+                  size_t batchSize,
+                  VarPipeFn fn,
+                  void *arg )
+{
+    int result = EINVAL;
+    size_t n = 2;
+
+    if ( ( pPipe != NULL ) &&
+         ( fn != NULL ) )
+    {
+        memset( pPipe, 0, sizeof( VarPipe ) );
+
+        if ( depth == 0 )
+        {
+            depth = VARPIPE_DEFAULT_DEPTH;
+        }
+
+        while ( n < depth )
+        {
+            n *= 2;
+        }
+
+        pPipe->depth = n;
+        pPipe->batchSize = ( batchSize == 0 ) ? 1
+                         : ( batchSize > n ) ? n
+                         : batchSize;
+        pPipe->fn = fn;
+        pPipe->arg = arg;
+        pPipe->result = EOK;
+
+        atomic_init( &pPipe->head, 0 );
+        atomic_init( &pPipe->tail, 0 );
+        atomic_init( &pPipe->closed, false );
+        atomic_init( &pPipe->creatorWaiting, false );
+        atomic_init( &pPipe->producerWaiting, false );
+
+        pPipe->info = calloc( n, sizeof( VarInfo ) );
+        pPipe->results = calloc( n, sizeof( int ) );
+        pPipe->entries = calloc( n, sizeof( VarPipeEntry ) );
+
+        if ( ( pPipe->info != NULL ) &&
+             ( pPipe->results != NULL ) &&
+             ( pPipe->entries != NULL ) )
+        {
+            pthread_mutex_init( &pPipe->lock, NULL );
+            pthread_cond_init( &pPipe->queued, NULL );
+            pthread_cond_init( &pPipe->created, NULL );
+
+            result = pthread_create( &pPipe->thread,
+                                     NULL,
+                                     varpipe_fnCreator,
+                                     pPipe );
+            if ( result != EOK )
+            {
+                pthread_cond_destroy( &pPipe->created );
+                pthread_cond_destroy( &pPipe->queued );
+                pthread_mutex_destroy( &pPipe->lock );
+            }
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+
+        if ( result != EOK )
+        {
+            free( pPipe->info );
+            free( pPipe->results );
+            free( pPipe->entries );
+            memset( pPipe, 0, sizeof( VarPipe ) );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varpipe_Reserve                                                           */
+/*!
+    Get the next free slot of the pipeline
+
+    The varpipe_Reserve function waits until the ring has a free slot,
+    and returns the slot so the producer can build a variable directly
+    into it.  The variable is not seen by the creator until it has been
+    queued with varpipe_Commit.
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+    @param[out]
+        ppEntry
+            pointer to a location to store the entry of the slot
+
+    @retval pointer to the VarInfo object of the slot
+
+==============================================================================*/
+VarInfo *varpipe_Reserve( VarPipe *pPipe, VarPipeEntry **ppEntry )
+{
+    size_t head;
+    size_t tail;
+    size_t i;
+
+    /* only the producer updates the head */
+    head = atomic_load_explicit( &pPipe->head, memory_order_relaxed );
+
+    while ( head - ( tail = atomic_load( &pPipe->tail ) ) == pPipe->depth )
+    {
+        /* the ring is full */
+        varpipe_fnWaitCreated( pPipe, tail );
+    }
+
+    i = head & ( pPipe->depth - 1 );
+    *ppEntry = &pPipe->entries[i];
+
+    return &pPipe->info[i];
+}
+
+/*============================================================================*/
+/*  varpipe_Commit                                                            */
+/*!
+    Queue the variable in the reserved slot for creation
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+==============================================================================*/
+void varpipe_Commit( VarPipe *pPipe )
+{
+    size_t head;
+
+    head = atomic_load_explicit( &pPipe->head, memory_order_relaxed );
+    atomic_store( &pPipe->head, head + 1 );
+
+    if ( atomic_load( &pPipe->creatorWaiting ) == true )
+    {
+        pthread_mutex_lock( &pPipe->lock );
+        pthread_cond_signal( &pPipe->queued );
+        pthread_mutex_unlock( &pPipe->lock );
+    }
+}
+
+/*============================================================================*/
+/*  varpipe_Wait                                                              */
+/*!
+    Wait until every queued variable has been created
+
+    The varpipe_Wait function waits for the creator thread to become
+    idle, so the caller can access the state which the callback
+    updates.  Unlike varpipe_Drain, the error reported by the callback
+    is kept for the next drain.
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+==============================================================================*/
+void varpipe_Wait( VarPipe *pPipe )
+{
+    size_t head;
+    size_t tail;
+
+    head = atomic_load_explicit( &pPipe->head, memory_order_relaxed );
+
+    while ( ( tail = atomic_load( &pPipe->tail ) ) != head )
+    {
+        varpipe_fnWaitCreated( pPipe, tail );
+    }
+}
+
+/*============================================================================*/
+/*  varpipe_Drain                                                             */
+/*!
+    Wait until every queued variable has been created
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+    @retval EOK - every variable since the last drain was created
+    @retval other - the last error reported by the callback since the
+            last drain
+
+==============================================================================*/
+int varpipe_Drain( VarPipe *pPipe )
+{
+    int result;
+
+    varpipe_Wait( pPipe );
+
+    /* the creator is idle, and its updates are visible since the tail
+       was read */
+    result = pPipe->result;
+    pPipe->result = EOK;
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varpipe_Store                                                             */
+/*!
+    Make sure an entry has enough storage for its strings
+
+    The storage of the entry is grown if necessary.  Its previous
+    content is not preserved.
+
+    @param[in]
+        pEntry
+            pointer to the entry
+
+    @param[in]
+        size
+            number of bytes of storage required
+
+    @retval EOK - the entry has enough storage
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varpipe_Store( VarPipeEntry *pEntry, size_t size )
+{
+    int result = EOK;
+    char *p;
+
+    if ( size > pEntry->size )
+    {
+        p = realloc( pEntry->buf, size );
+        if ( p != NULL )
+        {
+            pEntry->buf = p;
+            pEntry->size = size;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varpipe_Free                                                              */
+/*!
+    Stop a pipeline and release its resources
+
+    Any variables which are still queued are created first.
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+==============================================================================*/
+void varpipe_Free( VarPipe *pPipe )
+{
+    size_t i;
+
+    if ( ( pPipe != NULL ) &&
+         ( pPipe->info != NULL ) )
+    {
+        (void)varpipe_Drain( pPipe );
+
+        atomic_store( &pPipe->closed, true );
+
+        pthread_mutex_lock( &pPipe->lock );
+        pthread_cond_signal( &pPipe->queued );
+        pthread_mutex_unlock( &pPipe->lock );
+
+        pthread_join( pPipe->thread, NULL );
+
+        pthread_cond_destroy( &pPipe->created );
+        pthread_cond_destroy( &pPipe->queued );
+        pthread_mutex_destroy( &pPipe->lock );
+
+        for ( i = 0 ; i < pPipe->depth ; i++ )
+        {
+            free( pPipe->entries[i].buf );
+        }
+
+        free( pPipe->info );
+        free( pPipe->results );
+        free( pPipe->entries );
+        memset( pPipe, 0, sizeof( VarPipe ) );
+    }
+}
+
+/*============================================================================*/
+/*  varpipe_fnCreator                                                         */
+/*!
+    Creator thread of a pipeline
+
+    The varpipe_fnCreator function passes each contiguous run of queued
+    variables, up to the batch size, to the callback, and releases their
+    slots once they have been created.
+
+    @param[in]
+        arg
+            pointer to the pipeline
+
+    @retval NULL
+
+==============================================================================*/
+static void *varpipe_fnCreator( void *arg )
+{
+    VarPipe *pPipe = (VarPipe *)arg;
+    size_t head;
+    size_t tail;
+    size_t start;
+    size_t n;
+    int rc;
+
+    for ( ;; )
+    {
+        /* only the creator updates the tail */
+        tail = atomic_load_explicit( &pPipe->tail, memory_order_relaxed );
+        head = atomic_load( &pPipe->head );
+
+        if ( head == tail )
+        {
+            if ( ( atomic_load( &pPipe->closed ) == true ) &&
+                 ( atomic_load( &pPipe->head ) == tail ) )
+            {
+                break;
+            }
+
+            varpipe_fnWaitQueued( pPipe, tail );
+            continue;
+        }
+
+        /* submit the longest run which does not wrap around the ring */
+        start = tail & ( pPipe->depth - 1 );
+        n = head - tail;
+        if ( n > pPipe->depth - start )
+        {
+            n = pPipe->depth - start;
+        }
+
+        if ( n > pPipe->batchSize )
+        {
+            n = pPipe->batchSize;
+        }
+
+        rc = pPipe->fn( pPipe->arg,
+                        &pPipe->info[start],
+                        &pPipe->entries[start],
+                        &pPipe->results[start],
+                        n );
+        if ( rc != EOK )
+        {
+            pPipe->result = rc;
+        }
+
+        atomic_store( &pPipe->tail, tail + n );
+
+        if ( atomic_load( &pPipe->producerWaiting ) == true )
+        {
+            pthread_mutex_lock( &pPipe->lock );
+            pthread_cond_signal( &pPipe->created );
+            pthread_mutex_unlock( &pPipe->lock );
+        }
+    }
+
+    return NULL;
+}
+
+/*============================================================================*/
+/*  varpipe_fnWaitCreated                                                     */
+/*!
+    Sleep until the creator releases a slot
+
+    The waiting flag is set before the tail is checked again, and the
+    creator checks the flag after it has updated the tail, so the
+    producer cannot sleep through an update.
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+    @param[in]
+        tail
+            the tail which the producer last saw
+
+==============================================================================*/
+static void varpipe_fnWaitCreated( VarPipe *pPipe, size_t tail )
+{
+    pthread_mutex_lock( &pPipe->lock );
+
+    atomic_store( &pPipe->producerWaiting, true );
+    while ( atomic_load( &pPipe->tail ) == tail )
+    {
+        pthread_cond_wait( &pPipe->created, &pPipe->lock );
+    }
+
+    atomic_store( &pPipe->producerWaiting, false );
+
+    pthread_mutex_unlock( &pPipe->lock );
+}
+
+/*============================================================================*/
+/*  varpipe_fnWaitQueued                                                      */
+/*!
+    Sleep until the producer queues a variable or closes the pipeline
+
+    @param[in]
+        pPipe
+            pointer to the pipeline
+
+    @param[in]
+        head
+            the head which the creator last saw
+
+==============================================================================*/
+static void varpipe_fnWaitQueued( VarPipe *pPipe, size_t head )
+{
+    pthread_mutex_lock( &pPipe->lock );
+
+    atomic_store( &pPipe->creatorWaiting, true );
+    while ( ( atomic_load( &pPipe->head ) == head ) &&
+            ( atomic_load( &pPipe->closed ) == false ) )
+    {
+        pthread_cond_wait( &pPipe->queued, &pPipe->lock );
+    }
+
+    atomic_store( &pPipe->creatorWaiting, false );
+
+    pthread_mutex_unlock( &pPipe->lock );
+}
+
+/*! @}
+ * end of libvarcreate group */
@@ -0,0 +1,176 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARPIPE_H
+#define VARPIPE_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <varserver/varserver.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! default number of variables which can be waiting in the pipeline */
+#define VARPIPE_DEFAULT_DEPTH           ( 256 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! The VarPipeEntry object holds everything about a queued variable
+    other than its VarInfo object.  The parsed JSON tree is released
+    as soon as the variable has been queued, so the entry owns a copy
+    of the string value and of the alias names */
+typedef struct _VarPipeEntry
+{
+    /*! EOK if the variable was built successfully, otherwise the error
+        to report for the variable when it reaches the creator */
+    int result;
+
+    /*! storage for the string value and the alias names, which is
+        reused by every variable queued in the same slot */
+    char *buf;
+
+    /*! size of the storage */
+    size_t size;
+
+    /*! offset of the first of the NUL terminated alias names */
+    size_t aliases;
+
+    /*! number of alias names */
+    size_t naliases;
+
+    /*! template index substituted into the alias names, or an empty
+        string if the variable is not part of a template */
+    char index[16];
+
+    /*! index of the variable definition in the input, which failures
+        are reported against */
+    size_t item;
+
+} VarPipeEntry;
+
+/*! callback which creates a run of queued variables.  The run is
+    contiguous and in input order */
+typedef int (*VarPipeFn)( void *arg,
+                          VarInfo *info,
+                          VarPipeEntry *entries,
+                          int *results,
+                          size_t n );
+
+/*! The VarPipe object is a bounded single producer, single consumer
+    ring of variables which have been built but not yet created.  The
+    producer, which parses the input, fills the slots in order, and a
+    creator thread submits them to the variable server in the same
+    order.  The ring indices are updated without locks; the mutex and
+    condition variables are only used when a thread has to sleep
+    because the ring is empty or full */
+typedef struct _VarPipe
+{
+    /*! array of variables, so a contiguous run of slots can be
+        submitted as a batch */
+    VarInfo *info;
+
+    /*! array of creation results, parallel to the variables */
+    int *results;
+
+    /*! array of entries, parallel to the variables */
+    VarPipeEntry *entries;
+
+    /*! number of slots, which is a power of two */
+    size_t depth;
+
+    /*! maximum number of variables passed to the callback at once */
+    size_t batchSize;
+
+    /*! callback which creates the variables */
+    VarPipeFn fn;
+
+    /*! argument to pass to the callback */
+    void *arg;
+
+    /*! number of variables which have been queued */
+    atomic_size_t head;
+
+    /*! number of variables which have been created */
+    atomic_size_t tail;
+
+    /*! no more variables will be queued */
+    atomic_bool closed;
+
+    /*! the creator is waiting for a variable to be queued */
+    atomic_bool creatorWaiting;
+
+    /*! the producer is waiting for a variable to be created */
+    atomic_bool producerWaiting;
+
+    /*! aggregated result of the variables created since the pipeline
+        was last drained.  Only written by the creator thread */
+    int result;
+
+    /*! mutex protecting the condition variables */
+    pthread_mutex_t lock;
+
+    /*! signalled when a variable has been queued */
+    pthread_cond_t queued;
+
+    /*! signalled when a variable has been created */
+    pthread_cond_t created;
+
+    /*! creator thread identifier */
+    pthread_t thread;
+
+} VarPipe;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+int varpipe_Init( VarPipe *pPipe,
+                  size_t depth,
+                  size_t batchSize,
+                  VarPipeFn fn,
+                  void *arg );
+
+VarInfo *varpipe_Reserve( VarPipe *pPipe, VarPipeEntry **ppEntry );
+
+void varpipe_Commit( VarPipe *pPipe );
+
+void varpipe_Wait( VarPipe *pPipe );
+
+int varpipe_Drain( VarPipe *pPipe );
+
+int varpipe_Store( VarPipeEntry *pEntry, size_t size );
+
+void varpipe_Free( VarPipe *pPipe );
+
+#endif
@@ -0,0 +1,88 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARPROBE_H
+#define VARPROBE_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#if defined( VARCREATE_USDT )
+#include <sys/sdt.h>
+#endif
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! The VARPROBE_BEGIN and VARPROBE_END macros mark the start and end of
+    a step of a load.  Each has a label, which is a file or variable name
+    or NULL, and an integer argument, which is the result code of the
+    step for VARPROBE_END.
+
+    With VARCREATE_USDT they are the varcreate:<probe>__begin and
+    varcreate:<probe>__end USDT probes, which are a single nop until a
+    tracer such as bpftrace or perf attaches to them.  With
+    VARCREATE_TRACE they also write a Chrome trace event.  Otherwise
+    they compile to nothing */
+
+#if defined( VARCREATE_USDT )
+#define VARPROBE_USDT( probe, label, arg ) \
+    DTRACE_PROBE2( varcreate, \
+                   probe, \
+                   (const char *)( label ), \
+                   (long)( arg ) )
+#else
+#define VARPROBE_USDT( probe, label, arg ) ( (void)0 )
+#endif
+
+#if defined( VARCREATE_TRACE )
+
+void vartrace_Event( char phase,
+                     const char *probe,
+                     const char *label,
+                     long arg );
+
+#define VARPROBE_TRACE( phase, probe, label, arg ) \
+    vartrace_Event( phase, #probe, label, (long)( arg ) )
+#else
+#define VARPROBE_TRACE( phase, probe, label, arg ) ( (void)0 )
+#endif
+
+#define VARPROBE_BEGIN( probe, label, arg ) \
+    do \
+    { \
+        VARPROBE_USDT( probe##__begin, label, arg ); \
+        VARPROBE_TRACE( 'B', probe, label, arg ); \
+    } while ( 0 )
+
+#define VARPROBE_END( probe, label, arg ) \
+    do \
+    { \
+        VARPROBE_USDT( probe##__end, label, arg ); \
+        VARPROBE_TRACE( 'E', probe, label, arg ); \
+    } while ( 0 )
+
+#endif
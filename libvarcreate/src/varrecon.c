@@ -0,0 +1,442 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varrecon.c
+
+    Variable Creation reconcile
+
+    A reconciling load brings the variable server up to date with a
+    config which may already have been loaded, possibly in an earlier
+    version.  Each variable and alias is looked up by name before it is
+    created.  Those which already exist are left unchanged, and their
+    existing handles are used for their aliases and the handle index,
+    so only the variables and aliases added to the config are created.
+
+    The flags of an existing variable are read back and brought up to
+    date with the config, and the variable is counted as updated.  The
+    variable server has no request to change the other attributes of an
+    existing variable.  The type and string length are read back and
+    compared with the config, and a variable which differs is reported
+    and counted as changed rather than as unchanged.  The tags and
+    permissions cannot be read back, so they are not compared, and the
+    description is not passed to the variable server at all.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <varserver/varserver.h>
+#include <varserver/var.h>
+#include <varcreate/libvarcreate.h>
+#include "varrecon.h"
+#include "varlog.h"
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static bool varrecon_fnChanged( VARSERVER_HANDLE hVarServer,
+                                VAR_HANDLE hVar,
+                                const VarInfo *pVarInfo );
+
+static int varrecon_fnUpdateFlags( VARSERVER_HANDLE hVarServer,
+                                   VAR_HANDLE hVar,
+                                   const VarInfo *pVarInfo,
+                                   bool *pUpdated );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varrecon_CreateBatch                                                      */
+/*!
+    Create the variables of a batch which do not exist yet
+
+    The varrecon_CreateBatch function looks up each variable of the
+    batch by name.  An existing variable is given its existing handle
+    and counted, as changed if its type or string length differs from
+    the config, as updated if its flags had to be brought up to date,
+    or as unchanged, and the other variables are created with
+    VARCREATE_CreateBatch.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        options
+            pointer to the options of the load, which the changed
+            variables are reported to
+
+    @param[in,out]
+        pVarInfo
+            pointer to an array of n VarInfo objects
+
+    @param[in]
+        n
+            number of VarInfo objects in the pVarInfo array
+
+    @param[out]
+        results
+            pointer to an array of n result codes, or NULL.  Existing
+            variables have a result of EOK
+
+    @param[in,out]
+        pExisting
+            pointer to a count which is incremented for each variable
+            which already exists as defined
+
+    @param[in,out]
+        pChanged
+            pointer to a count which is incremented for each variable
+            which already exists with a different type or string length
+
+    @param[in,out]
+        pUpdated
+            pointer to a count which is incremented for each variable
+            which already exists and whose flags were updated
+
+    @retval EOK - every variable exists or was created
+    @retval EINVAL - invalid arguments
+    @retval other - the error code of the last variable which failed
+
+==============================================================================*/
+int varrecon_CreateBatch( VARSERVER_HANDLE hVarServer,
+                          VarCreateOptions *options,
+                          VarInfo *pVarInfo,
+                          size_t n,
+                          int *results,
+                          size_t *pExisting,
+                          size_t *pChanged,
+                          size_t *pUpdated )
+{
+    int result = EINVAL;
+    VAR_HANDLE hVar;
+    bool updated;
+    size_t i;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pVarInfo != NULL ) &&
+         ( pExisting != NULL ) &&
+         ( pChanged != NULL ) &&
+         ( pUpdated != NULL ) )
+    {
+        result = EOK;
+
+        for ( i = 0 ; i < n ; i++ )
+        {
+            hVar = VAR_FindByName( hVarServer, pVarInfo[i].name );
+            if ( hVar != VAR_INVALID )
+            {
+                rc = EOK;
+
+                if ( varrecon_fnChanged( hVarServer, hVar, &pVarInfo[i] ) )
+                {
+                    /* the variable cannot be redefined */
+                    varlog_Printf( options,
+                                   "Definition changed: %s\n",
+                                   pVarInfo[i].name );
+                    ( *pChanged )++;
+                }
+                else
+                {
+                    rc = varrecon_fnUpdateFlags( hVarServer,
+                                                 hVar,
+                                                 &pVarInfo[i],
+                                                 &updated );
+                    if ( rc != EOK )
+                    {
+                        varlog_Printf( options,
+                                       "Unable to update flags: %s\n",
+                                       pVarInfo[i].name );
+                    }
+                    else if ( updated == true )
+                    {
+                        if ( options->verbose )
+                        {
+                            varlog_Printf( options,
+                                           "VARCREATE: Flags updated: %s\n",
+                                           pVarInfo[i].name );
+                        }
+
+                        ( *pUpdated )++;
+                    }
+                    else
+                    {
+                        ( *pExisting )++;
+                    }
+                }
+
+                if ( ( options->verbose ) &&
+                     ( ( pVarInfo[i].tagspec[0] != '\0' ) ||
+                       ( pVarInfo[i].permissions.nreads > 0 ) ||
+                       ( pVarInfo[i].permissions.nwrites > 0 ) ) )
+                {
+                    varlog_Printf( options,
+                                   "VARCREATE: Tags and permissions not "
+                                   "compared: %s\n",
+                                   pVarInfo[i].name );
+                }
+
+                pVarInfo[i].hVar = hVar;
+            }
+            else
+            {
+                rc = VARCREATE_CreateBatch( hVarServer,
+                                            &pVarInfo[i],
+                                            1,
+                                            NULL );
+            }
+
+            if ( results != NULL )
+            {
+                results[i] = rc;
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varrecon_CreateAliasBatch                                                 */
+/*!
+    Create the aliases of a batch which do not exist yet
+
+    The varrecon_CreateAliasBatch function looks up each alias of the
+    batch by name.  An existing alias is counted and left unchanged, and
+    the other aliases are created with VARCREATE_CreateAliasBatch.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create aliases for
+
+    @param[in]
+        pAliases
+            pointer to an array of n aliases
+
+    @param[in]
+        n
+            number of aliases in the pAliases array
+
+    @param[out]
+        results
+            pointer to an array of n result codes, or NULL.  Existing
+            aliases have a result of EOK
+
+    @param[in,out]
+        pExisting
+            pointer to a count which is incremented for each alias
+            which already exists
+
+    @retval EOK - every alias exists or was created
+    @retval EINVAL - invalid arguments
+    @retval other - the error code of the last alias which failed
+
+==============================================================================*/
+int varrecon_CreateAliasBatch( VARSERVER_HANDLE hVarServer,
+                               VarCreateAlias *pAliases,
+                               size_t n,
+                               int *results,
+                               size_t *pExisting )
+{
+    int result = EINVAL;
+    size_t i;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pAliases != NULL ) &&
+         ( pExisting != NULL ) )
+    {
+        result = EOK;
+
+        for ( i = 0 ; i < n ; i++ )
+        {
+            if ( VAR_FindByName( hVarServer,
+                                 pAliases[i].name ) != VAR_INVALID )
+            {
+                /* leave the existing alias as it is */
+                ( *pExisting )++;
+                rc = EOK;
+            }
+            else
+            {
+                rc = VARCREATE_CreateAliasBatch( hVarServer,
+                                                 &pAliases[i],
+                                                 1,
+                                                 NULL );
+            }
+
+            if ( results != NULL )
+            {
+                results[i] = rc;
+            }
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varrecon_fnChanged                                                        */
+/*!
+    Compare an existing variable with its definition in the config
+
+    The varrecon_fnChanged function reads back the type of the existing
+    variable, and the length of a string, and compares them with the
+    definition.  The flags are compared by varrecon_fnUpdateFlags.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server
+
+    @param[in]
+        hVar
+            handle of the existing variable
+
+    @param[in]
+        pVarInfo
+            pointer to the definition of the variable in the config
+
+    @retval true - the existing variable differs from its definition
+    @retval false - the existing variable matches as far as can be told
+
+==============================================================================*/
+static bool varrecon_fnChanged( VARSERVER_HANDLE hVarServer,
+                                VAR_HANDLE hVar,
+                                const VarInfo *pVarInfo )
+{
+    bool result = false;
+    VarType type;
+    size_t len;
+
+    if ( VAR_GetType( hVarServer, hVar, &type ) == EOK )
+    {
+        if ( type != pVarInfo->var.type )
+        {
+            result = true;
+        }
+        else if ( ( type == VARTYPE_STR ) &&
+                  ( VAR_GetLength( hVarServer, hVar, &len ) == EOK ) &&
+                  ( len != pVarInfo->var.len ) )
+        {
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varrecon_fnUpdateFlags                                                    */
+/*!
+    Bring the flags of an existing variable up to date with the config
+
+    The varrecon_fnUpdateFlags function reads back the flags of the
+    existing variable, sets the flags which the config adds, and clears
+    the flags which the config no longer has.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server
+
+    @param[in]
+        hVar
+            handle of the existing variable
+
+    @param[in]
+        pVarInfo
+            pointer to the definition of the variable in the config
+
+    @param[out]
+        pUpdated
+            set to true if the flags of the variable were changed
+
+    @retval EOK - the flags of the variable match the config
+    @retval other - the flags could not be read or changed
+
+==============================================================================*/
+static int varrecon_fnUpdateFlags( VARSERVER_HANDLE hVarServer,
+                                   VAR_HANDLE hVar,
+                                   const VarInfo *pVarInfo,
+                                   bool *pUpdated )
+{
+    int result;
+    uint32_t flags;
+    uint32_t set;
+    uint32_t clear;
+
+    *pUpdated = false;
+
+    result = VAR_GetFlags( hVarServer, hVar, &flags );
+    if ( result == EOK )
+    {
+        set = pVarInfo->flags & ~flags;
+        clear = flags & ~pVarInfo->flags;
+
+        if ( set != 0 )
+        {
+            result = VAR_SetFlags( hVarServer, hVar, set );
+            *pUpdated = true;
+        }
+
+        if ( ( result == EOK ) &&
+             ( clear != 0 ) )
+        {
+            result = VAR_ClearFlags( hVarServer, hVar, clear );
+            *pUpdated = true;
+        }
+    }
+
+    return result;
+}
+
+/*! @}
+ * end of libvarcreate group */
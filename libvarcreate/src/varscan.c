@@ -0,0 +1,443 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+/*============================================================================*/
+/*!
+@file varscan.c
+
+    Variable Creation structural scanner
+
+    The structural scanner classifies the characters of a varcreate JSON
+    document a block at a time, producing a bit mask of the characters
+    which can end a run of string contents and a bit mask of the
+    characters which can change the document structure.  The
+    incremental scanner uses the masks to step from one significant
+    character to the next, so the runs of string contents, numbers and
+    whitespace between them are skipped, or captured, in one step
+    instead of one character at a time.
+
+    When the library is built with VARCREATE_SIMD, each block is
+    classified 16 or 32 characters at a time using SSE2 or AVX2 on x86
+    and NEON on ARM.  The widest implementation supported by the CPU is
+    selected at run time.  Without a vector implementation, the
+    incremental scanner processes one character at a time, since
+    classifying the characters with a table costs more than it saves.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "varscan.h"
+
+#if defined( VARCREATE_SIMD ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#include <immintrin.h>
+#define VARSCAN_X86
+#elif defined( VARCREATE_SIMD ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#define VARSCAN_NEON
+#endif
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! characters which end a run, indexed by the mask */
+static const bool varscan_table[2][256] =
+{
+    [VARSCAN_STRING] =
+    {
+        ['"'] = true, ['\\'] = true
+    },
+
+    [VARSCAN_STRUCTURE] =
+    {
+        ['"'] = true, ['\\'] = true,
+        ['{'] = true, ['}'] = true,
+        ['['] = true, [']'] = true,
+        [':'] = true, [','] = true
+    }
+};
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+#if defined( VARSCAN_X86 )
+static void varscan_fnSSE2( const char *data, uint64_t masks[2] );
+
+static void varscan_fnAVX2( const char *data, uint64_t masks[2] );
+#endif
+
+#if defined( VARSCAN_NEON )
+static uint64_t varscan_fnNEONMask( const uint8x16_t m[4] );
+
+static void varscan_fnNEON( const char *data, uint64_t masks[2] );
+#endif
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varscan_Select                                                            */
+/*!
+    Select the structural scanner for this CPU
+
+    The varscan_Select function returns the widest implementation of
+    the structural scanner which was built into the library and is
+    supported by the CPU.
+
+    @retval pointer to the scanner function
+    @retval NULL - there is no vector implementation for this CPU
+
+==============================================================================*/
+VarScanFn varscan_Select( void )
+{
+    VarScanFn fn = NULL;
+
+#if defined( VARSCAN_X86 )
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        fn = varscan_fnAVX2;
+    }
+    else if ( __builtin_cpu_supports( "sse2" ) )
+    {
+        fn = varscan_fnSSE2;
+    }
+#elif defined( VARSCAN_NEON )
+    /* Advanced SIMD is mandatory on AArch64 */
+    fn = varscan_fnNEON;
+#endif
+
+    return fn;
+}
+
+/*============================================================================*/
+/*  varscan_Name                                                              */
+/*!
+    Get the name of a structural scanner
+
+    @param[in]
+        fn
+            scanner function returned by varscan_Select, or NULL
+
+    @retval name of the instruction set used by the scanner
+
+==============================================================================*/
+const char *varscan_Name( VarScanFn fn )
+{
+    const char *name = "scalar";
+
+#if defined( VARSCAN_X86 )
+    if ( fn == varscan_fnAVX2 )
+    {
+        name = "avx2";
+    }
+    else if ( fn == varscan_fnSSE2 )
+    {
+        name = "sse2";
+    }
+#elif defined( VARSCAN_NEON )
+    if ( fn == varscan_fnNEON )
+    {
+        name = "neon";
+    }
+#else
+    (void)fn;
+#endif
+
+    return name;
+}
+
+/*============================================================================*/
+/*  varscan_Tail                                                              */
+/*!
+    Classify a partial block one character at a time
+
+    The varscan_Tail function classifies the first len characters of
+    a block which is shorter than VARSCAN_BLOCK_SIZE.  The bits for
+    the missing characters are set in both masks, so that every run
+    ends at the end of the data.
+
+    @param[in]
+        data
+            pointer to the characters to classify
+
+    @param[in]
+        len
+            number of characters to classify, at most VARSCAN_BLOCK_SIZE
+
+    @param[out]
+        masks
+            the VARSCAN_STRING and VARSCAN_STRUCTURE masks of the block
+
+==============================================================================*/
+void varscan_Tail( const char *data, size_t len, uint64_t masks[2] )
+{
+    uint64_t fill = 0;
+    uint64_t bit;
+    size_t i;
+    unsigned char c;
+
+    if ( len < VARSCAN_BLOCK_SIZE )
+    {
+        fill = ~(uint64_t)0 << len;
+    }
+
+    masks[VARSCAN_STRING] = fill;
+    masks[VARSCAN_STRUCTURE] = fill;
+
+    for ( i = 0 ; ( i < len ) && ( i < VARSCAN_BLOCK_SIZE ) ; i++ )
+    {
+        c = (unsigned char)data[i];
+        bit = (uint64_t)1 << i;
+
+        if ( varscan_table[VARSCAN_STRING][c] == true )
+        {
+            masks[VARSCAN_STRING] |= bit;
+        }
+
+        if ( varscan_table[VARSCAN_STRUCTURE][c] == true )
+        {
+            masks[VARSCAN_STRUCTURE] |= bit;
+        }
+    }
+}
+
+#if defined( VARSCAN_X86 )
+
+/*============================================================================*/
+/*  varscan_fnSSE2                                                            */
+/*!
+    Classify a block 16 characters at a time
+
+    The varscan_fnSSE2 function compares each 16 character piece of
+    the block against every character of the sets, and gathers the
+    results into the masks.  The brackets and braces are matched with
+    a single comparison each by folding '[' onto '{' and ']' onto '}'.
+
+    @param[in]
+        data
+            pointer to the VARSCAN_BLOCK_SIZE characters to classify
+
+    @param[out]
+        masks
+            the VARSCAN_STRING and VARSCAN_STRUCTURE masks of the block
+
+==============================================================================*/
+__attribute__(( target( "sse2" ) ))
+static void varscan_fnSSE2( const char *data, uint64_t masks[2] )
+{
+    const __m128i quote = _mm_set1_epi8( '"' );
+    const __m128i escape = _mm_set1_epi8( '\\' );
+    const __m128i fold = _mm_set1_epi8( 0x20 );
+    const __m128i open = _mm_set1_epi8( '{' );
+    const __m128i close = _mm_set1_epi8( '}' );
+    const __m128i colon = _mm_set1_epi8( ':' );
+    const __m128i comma = _mm_set1_epi8( ',' );
+    uint64_t string = 0;
+    uint64_t structure = 0;
+    __m128i v;
+    __m128i f;
+    __m128i s;
+    __m128i t;
+    size_t i;
+
+    for ( i = 0 ; i < VARSCAN_BLOCK_SIZE ; i += 16 )
+    {
+        v = _mm_loadu_si128( (const __m128i *)&data[i] );
+        f = _mm_or_si128( v, fold );
+        s = _mm_or_si128( _mm_cmpeq_epi8( v, quote ),
+                          _mm_cmpeq_epi8( v, escape ) );
+        t = _mm_or_si128( _mm_cmpeq_epi8( f, open ),
+                          _mm_cmpeq_epi8( f, close ) );
+        t = _mm_or_si128( t, _mm_cmpeq_epi8( v, colon ) );
+        t = _mm_or_si128( t, _mm_cmpeq_epi8( v, comma ) );
+        t = _mm_or_si128( t, s );
+
+        string |= (uint64_t)(uint16_t)_mm_movemask_epi8( s ) << i;
+        structure |= (uint64_t)(uint16_t)_mm_movemask_epi8( t ) << i;
+    }
+
+    masks[VARSCAN_STRING] = string;
+    masks[VARSCAN_STRUCTURE] = structure;
+}
+
+/*============================================================================*/
+/*  varscan_fnAVX2                                                            */
+/*!
+    Classify a block 32 characters at a time
+
+    The varscan_fnAVX2 function is the 32 character equivalent of
+    varscan_fnSSE2.  It is compiled for AVX2 regardless of the build
+    flags, and is only selected when the CPU supports AVX2.
+
+    @param[in]
+        data
+            pointer to the VARSCAN_BLOCK_SIZE characters to classify
+
+    @param[out]
+        masks
+            the VARSCAN_STRING and VARSCAN_STRUCTURE masks of the block
+
+==============================================================================*/
+__attribute__(( target( "avx2" ) ))
+static void varscan_fnAVX2( const char *data, uint64_t masks[2] )
+{
+    const __m256i quote = _mm256_set1_epi8( '"' );
+    const __m256i escape = _mm256_set1_epi8( '\\' );
+    const __m256i fold = _mm256_set1_epi8( 0x20 );
+    const __m256i open = _mm256_set1_epi8( '{' );
+    const __m256i close = _mm256_set1_epi8( '}' );
+    const __m256i colon = _mm256_set1_epi8( ':' );
+    const __m256i comma = _mm256_set1_epi8( ',' );
+    uint64_t string = 0;
+    uint64_t structure = 0;
+    __m256i v;
+    __m256i f;
+    __m256i s;
+    __m256i t;
+    size_t i;
+
+    for ( i = 0 ; i < VARSCAN_BLOCK_SIZE ; i += 32 )
+    {
+        v = _mm256_loadu_si256( (const __m256i *)&data[i] );
+        f = _mm256_or_si256( v, fold );
+        s = _mm256_or_si256( _mm256_cmpeq_epi8( v, quote ),
+                             _mm256_cmpeq_epi8( v, escape ) );
+        t = _mm256_or_si256( _mm256_cmpeq_epi8( f, open ),
+                             _mm256_cmpeq_epi8( f, close ) );
+        t = _mm256_or_si256( t, _mm256_cmpeq_epi8( v, colon ) );
+        t = _mm256_or_si256( t, _mm256_cmpeq_epi8( v, comma ) );
+        t = _mm256_or_si256( t, s );
+
+        string |= (uint64_t)(uint32_t)_mm256_movemask_epi8( s ) << i;
+        structure |= (uint64_t)(uint32_t)_mm256_movemask_epi8( t ) << i;
+    }
+
+    masks[VARSCAN_STRING] = string;
+    masks[VARSCAN_STRUCTURE] = structure;
+}
+
+#endif
+
+#if defined( VARSCAN_NEON )
+
+/*============================================================================*/
+/*  varscan_fnNEONMask                                                        */
+/*!
+    Gather the results of four NEON comparisons into a bit mask
+
+    NEON has no byte mask instruction, so each comparison result is
+    reduced to one bit per character by weighting the characters of
+    each group of eight and adding the weights pairwise.
+
+    @param[in]
+        m
+            the results of the comparisons of the characters 0-15,
+            16-31, 32-47 and 48-63 of the block
+
+    @retval mask with bit n set if character n matched
+
+==============================================================================*/
+static uint64_t varscan_fnNEONMask( const uint8x16_t m[4] )
+{
+    static const uint8_t weights[16] =
+    {
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80,
+        0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+    };
+    const uint8x16_t w = vld1q_u8( weights );
+    uint8x16_t sum0;
+    uint8x16_t sum1;
+
+    sum0 = vpaddq_u8( vandq_u8( m[0], w ), vandq_u8( m[1], w ) );
+    sum1 = vpaddq_u8( vandq_u8( m[2], w ), vandq_u8( m[3], w ) );
+    sum0 = vpaddq_u8( sum0, sum1 );
+    sum0 = vpaddq_u8( sum0, sum0 );
+
+    return vgetq_lane_u64( vreinterpretq_u64_u8( sum0 ), 0 );
+}
+
+/*============================================================================*/
+/*  varscan_fnNEON                                                            */
+/*!
+    Classify a block 16 characters at a time
+
+    The varscan_fnNEON function is the NEON equivalent of
+    varscan_fnSSE2.
+
+    @param[in]
+        data
+            pointer to the VARSCAN_BLOCK_SIZE characters to classify
+
+    @param[out]
+        masks
+            the VARSCAN_STRING and VARSCAN_STRUCTURE masks of the block
+
+==============================================================================*/
+static void varscan_fnNEON( const char *data, uint64_t masks[2] )
+{
+    const uint8x16_t quote = vdupq_n_u8( '"' );
+    const uint8x16_t escape = vdupq_n_u8( '\\' );
+    const uint8x16_t fold = vdupq_n_u8( 0x20 );
+    const uint8x16_t open = vdupq_n_u8( '{' );
+    const uint8x16_t close = vdupq_n_u8( '}' );
+    const uint8x16_t colon = vdupq_n_u8( ':' );
+    const uint8x16_t comma = vdupq_n_u8( ',' );
+    uint8x16_t s[4];
+    uint8x16_t t[4];
+    uint8x16_t v;
+    uint8x16_t f;
+    size_t i;
+
+    for ( i = 0 ; i < 4 ; i++ )
+    {
+        v = vld1q_u8( (const uint8_t *)&data[i * 16] );
+        f = vorrq_u8( v, fold );
+        s[i] = vorrq_u8( vceqq_u8( v, quote ), vceqq_u8( v, escape ) );
+        t[i] = vorrq_u8( vceqq_u8( f, open ), vceqq_u8( f, close ) );
+        t[i] = vorrq_u8( t[i], vceqq_u8( v, colon ) );
+        t[i] = vorrq_u8( t[i], vceqq_u8( v, comma ) );
+        t[i] = vorrq_u8( t[i], s[i] );
+    }
+
+    masks[VARSCAN_STRING] = varscan_fnNEONMask( s );
+    masks[VARSCAN_STRUCTURE] = varscan_fnNEONMask( t );
+}
+
+#endif
+
+/*! @}
+ * end of libvarcreate group */
@@ -0,0 +1,71 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARSCAN_H
+#define VARSCAN_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! number of characters classified by each call to the scanner */
+#define VARSCAN_BLOCK_SIZE              ( 64 )
+
+/*! index of the mask of the characters which end a run of string
+    contents: the closing quote and the escape character */
+#define VARSCAN_STRING                  ( 0 )
+
+/*! index of the mask of the characters which end a run of insignificant
+    content outside a string: quotes, escapes, brackets, braces, colons
+    and commas */
+#define VARSCAN_STRUCTURE               ( 1 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! function which classifies a block of VARSCAN_BLOCK_SIZE characters
+    using vector instructions.
+    Bit n of each mask is set if character n of the block belongs to the
+    character set selected by the index of the mask */
+typedef void (*VarScanFn)( const char *data, uint64_t masks[2] );
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+VarScanFn varscan_Select( void );
+
+const char *varscan_Name( VarScanFn fn );
+
+void varscan_Tail( const char *data, size_t len, uint64_t masks[2] );
+
+#endif
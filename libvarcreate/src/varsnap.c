@@ -0,0 +1,2003 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varsnap.c
+
+    Variable Creation from compiled snapshots
+
+    A snapshot is a binary image of the fully resolved variable
+    definitions from a varcreate JSON file.  The types, flags,
+    permissions and initial values have already been parsed, so
+    creating the variables from a snapshot only requires the file to be
+    mapped into memory and each record to be copied into a VarInfo
+    object and submitted to the variable server.
+
+    A snapshot is specific to the byte order and the variable server
+    limits of the machine which compiled it.
+
+    The same records are used to create a set of config files for many
+    instances.  The files are compiled into a snapshot in memory once,
+    and the snapshot is created for each instance in turn.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varload.h"
+#include "varsnap.h"
+#include "varlog.h"
+#include "varindex.h"
+#include "varprobe.h"
+#include "varrecon.h"
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int varsnap_fnString( VarSnapWriter *pWriter,
+                             const char *str,
+                             uint32_t *pOffset );
+
+static uint32_t *varsnap_fnFind( VarSnapWriter *pWriter, const char *str );
+
+static int varsnap_fnGrowHash( VarSnapWriter *pWriter );
+
+static int varsnap_fnWrite( VarSnapWriter *pWriter, char *filename );
+
+static int varsnap_fnWriteData( int fd, const void *data, size_t len );
+
+static int varsnap_fnWriteTable( const char *image,
+                                 size_t len,
+                                 const char *filename,
+                                 const char *source,
+                                 const char *symbol );
+
+static bool varsnap_fnIsSymbol( const char *symbol );
+
+static char *varsnap_fnImage( VarSnapWriter *pWriter );
+
+static void varsnap_fnFree( VarSnapWriter *pWriter );
+
+static int varsnap_fnCheck( const char *data, size_t len );
+
+static int varsnap_fnCreate( VARSERVER_HANDLE hVarServer,
+                             const char *snapshot,
+                             const char *data,
+                             VarCreateOptions *options,
+                             VarCreateStats *pStats );
+
+static int varsnap_fnInstances( VARSERVER_HANDLE hVarServer,
+                                const char *name,
+                                const char *data,
+                                VarCreateOptions *options,
+                                VarCreateStats *pStats );
+
+static uint64_t varsnap_fnClock( VarCreateOptions *options );
+
+static void varsnap_fnReady( VarCreateOptions *options );
+
+static int varsnap_fnBuildVarInfo( const VarSnapRecord *pRecord,
+                                   const char *strings,
+                                   VarCreateOptions *options,
+                                   VarInfo *pVarInfo );
+
+static int varsnap_fnCopy( char *dst, size_t size, const char *src );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  VARCREATE_CompileSnapshot                                                 */
+/*!
+    Compile a varcreate JSON config file into a snapshot
+
+    The VARCREATE_CompileSnapshot function parses the JSON config file
+    exactly as VARCREATE_CreateFromFile does, including the prefix and
+    flags options, but writes the resolved variable definitions and
+    their aliases to a snapshot file instead of creating them.
+    No variable server connection is required.  The snapshot is not
+    written if any variable definition in the file is invalid.
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @param[in]
+        snapshot
+            name of the snapshot file to write
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - the snapshot was written
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval EIO - the snapshot could not be written
+    @retval other - the JSON config file could not be processed
+
+==============================================================================*/
+int VARCREATE_CompileSnapshot( char *filename,
+                               char *snapshot,
+                               VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarSnapWriter writer;
+    VarLoad load;
+
+    if ( ( filename != NULL ) &&
+         ( snapshot != NULL ) )
+    {
+        memset( &writer, 0, sizeof( VarSnapWriter ) );
+
+        /* start the string table with the empty string */
+        result = varsnap_fnString( &writer, "", NULL );
+        if ( result == EOK )
+        {
+            result = varcreate_fnLoadBegin( &load, NULL, options );
+        }
+
+        if ( result == EOK )
+        {
+            load.pSnapshot = &writer;
+            result = varcreate_fnLoadFile( &load, filename );
+            varcreate_fnLoadEnd( &load );
+        }
+
+        if ( result == EOK )
+        {
+            result = varsnap_fnWrite( &writer, snapshot );
+            if ( result != EOK )
+            {
+                varlog_Printf( options,
+                               "Unable to write snapshot: %s\n",
+                               snapshot );
+                varlog_Flush();
+            }
+        }
+
+        varsnap_fnFree( &writer );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_CreateFromSnapshot                                              */
+/*!
+    Create variables from a compiled snapshot
+
+    The VARCREATE_CreateFromSnapshot function maps a snapshot created by
+    VARCREATE_CompileSnapshot into memory and creates the variables it
+    describes, followed by their aliases.  The instanceID, prefix and
+    flags options are applied to each variable as it is created.  A
+    snapshot does not record which variables are critical, so a priority
+    load creates every variable before the ready function is called.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        snapshot
+            name of the snapshot file
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOENT - unable to open the file
+    @retval ENOTSUP - cannot map this file type
+    @retval EBADMSG - the file is not a valid snapshot
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+int VARCREATE_CreateFromSnapshot( VARSERVER_HANDLE hVarServer,
+                                  char *snapshot,
+                                  VarCreateOptions *options )
+{
+    int result = EINVAL;
+    struct stat st;
+    VarCreateStats stats;
+    uint64_t start;
+    void *p;
+    size_t len;
+    int fd;
+
+    VARPROBE_BEGIN( load, snapshot, 0 );
+
+    if ( ( hVarServer != NULL ) &&
+         ( snapshot != NULL ) &&
+         ( options != NULL ) )
+    {
+        memset( &stats, 0, sizeof( VarCreateStats ) );
+        start = varsnap_fnClock( options );
+
+        fd = open( snapshot, O_RDONLY );
+        if ( fd != -1 )
+        {
+            if ( ( fstat( fd, &st ) == 0 ) &&
+                 ( S_ISREG( st.st_mode ) ) )
+            {
+                len = st.st_size;
+                if ( len >= sizeof( VarSnapHeader ) )
+                {
+                    p = mmap( NULL, len, PROT_READ, MAP_PRIVATE, fd, 0 );
+                    if ( p != MAP_FAILED )
+                    {
+                        result = varsnap_fnCheck( (const char *)p, len );
+
+                        stats.readTime = varsnap_fnClock( options ) - start;
+                        stats.bytes = len;
+
+                        if ( result == EOK )
+                        {
+                            result = varsnap_fnInstances( hVarServer,
+                                                          snapshot,
+                                                          (const char *)p,
+                                                          options,
+                                                          &stats );
+                        }
+                        else
+                        {
+                            varlog_Printf( options,
+                                           "Invalid snapshot: %s\n",
+                                           snapshot );
+                            varlog_Report( options,
+                                           snapshot,
+                                           0,
+                                           NULL,
+                                           NULL,
+                                           result );
+                        }
+
+                        munmap( p, len );
+                    }
+                    else
+                    {
+                        result = ENOMEM;
+                    }
+                }
+                else
+                {
+                    result = EBADMSG;
+                }
+            }
+            else
+            {
+                /* invalid file type */
+                result = ENOTSUP;
+            }
+
+            close( fd );
+        }
+        else
+        {
+            /* file cannot be opened for reading */
+            result = ENOENT;
+        }
+
+        varlog_Flush();
+        varsnap_fnReady( options );
+
+        if ( options->stats != NULL )
+        {
+            stats.files = 1;
+            stats.totalTime = varsnap_fnClock( options ) - start;
+            varcreate_fnAddStats( options, &stats );
+
+            if ( options->fileStats != NULL )
+            {
+                options->fileStats( snapshot, &stats );
+            }
+        }
+    }
+
+    VARPROBE_END( load, snapshot, result );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_CompileTable                                                    */
+/*!
+    Compile a varcreate JSON config file into a C source file
+
+    The VARCREATE_CompileTable function compiles the JSON config file
+    into a snapshot as VARCREATE_CompileSnapshot does, and writes the
+    snapshot to a C source file as a constant VarCreateTable object with
+    the specified name.  The program which the source file is built into
+    creates the variables with VARCREATE_CreateFromTable, without reading
+    or parsing any config files.  The source file is not written if any
+    variable definition in the file is invalid.
+
+    @param[in]
+        filename
+            name of the variable creation JSON config file
+
+    @param[in]
+        source
+            name of the C source file to write
+
+    @param[in]
+        symbol
+            name of the VarCreateTable object, which must be a valid C
+            identifier
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - the source file was written
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval EIO - the source file could not be written
+    @retval other - the JSON config file could not be processed
+
+==============================================================================*/
+int VARCREATE_CompileTable( char *filename,
+                            char *source,
+                            const char *symbol,
+                            VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarSnapWriter writer;
+    VarLoad load;
+    char *image;
+    size_t len;
+
+    if ( ( filename != NULL ) &&
+         ( source != NULL ) &&
+         ( varsnap_fnIsSymbol( symbol ) == true ) )
+    {
+        memset( &writer, 0, sizeof( VarSnapWriter ) );
+
+        /* start the string table with the empty string */
+        result = varsnap_fnString( &writer, "", NULL );
+        if ( result == EOK )
+        {
+            result = varcreate_fnLoadBegin( &load, NULL, options );
+        }
+
+        if ( result == EOK )
+        {
+            load.pSnapshot = &writer;
+            result = varcreate_fnLoadFile( &load, filename );
+            varcreate_fnLoadEnd( &load );
+        }
+
+        if ( result == EOK )
+        {
+            len = sizeof( VarSnapHeader ) +
+                  writer.count * sizeof( VarSnapRecord ) +
+                  writer.naliases * sizeof( VarSnapAlias ) +
+                  writer.strlen;
+
+            image = varsnap_fnImage( &writer );
+            if ( image != NULL )
+            {
+                result = varsnap_fnWriteTable( image,
+                                               len,
+                                               filename,
+                                               source,
+                                               symbol );
+                free( image );
+
+                if ( result != EOK )
+                {
+                    varlog_Printf( options,
+                                   "Unable to write variable table: %s\n",
+                                   source );
+                    varlog_Flush();
+                }
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        varsnap_fnFree( &writer );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  VARCREATE_CreateFromTable                                                 */
+/*!
+    Create variables from a table compiled into the program
+
+    The VARCREATE_CreateFromTable function creates the variables and
+    aliases of a table written by VARCREATE_CompileTable, exactly as
+    VARCREATE_CreateFromSnapshot creates them from a snapshot file.
+    The table is read in place, so no file is read, no JSON is parsed
+    and no attribute strings are converted.  The instanceID, instances,
+    prefix and flags options are applied to each variable as it is
+    created.  As with a snapshot, a priority load creates every variable
+    before the ready function is called.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        pTable
+            pointer to the table
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval EBADMSG - the table is not valid for this library
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+int VARCREATE_CreateFromTable( VARSERVER_HANDLE hVarServer,
+                               const VarCreateTable *pTable,
+                               VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarCreateStats stats;
+    uint64_t start;
+
+    VARPROBE_BEGIN( load, NULL, 0 );
+
+    if ( ( hVarServer != NULL ) &&
+         ( pTable != NULL ) &&
+         ( pTable->image != NULL ) &&
+         ( ( (uintptr_t)pTable->image % sizeof( uint64_t ) ) == 0 ) &&
+         ( options != NULL ) )
+    {
+        memset( &stats, 0, sizeof( VarCreateStats ) );
+        start = varsnap_fnClock( options );
+
+        result = ( pTable->len >= sizeof( VarSnapHeader ) )
+                 ? varsnap_fnCheck( (const char *)pTable->image, pTable->len )
+                 : EBADMSG;
+
+        stats.bytes = pTable->len;
+
+        if ( result == EOK )
+        {
+            result = varsnap_fnInstances( hVarServer,
+                                          NULL,
+                                          (const char *)pTable->image,
+                                          options,
+                                          &stats );
+        }
+        else
+        {
+            varlog_Printf( options, "Invalid variable table\n" );
+            varlog_Report( options, NULL, 0, NULL, NULL, result );
+        }
+
+        varlog_Flush();
+        varsnap_fnReady( options );
+
+        if ( options->stats != NULL )
+        {
+            stats.files = 1;
+            stats.totalTime = varsnap_fnClock( options ) - start;
+            varcreate_fnAddStats( options, &stats );
+
+            if ( options->fileStats != NULL )
+            {
+                options->fileStats( NULL, &stats );
+            }
+        }
+    }
+
+    VARPROBE_END( load, NULL, result );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_CreateInstances                                                   */
+/*!
+    Create the variables of config files for each of a set of instances
+
+    The varsnap_CreateInstances function parses the config files once
+    into a snapshot held in memory, without the prefix and flags
+    options, and then creates the variables and aliases of the snapshot
+    for each instance identifier in the instances array of the options,
+    applying the prefix and flags options as each variable is created.
+    The variables of each instance are submitted in batches.
+
+    The definitions which cannot be resolved are reported once.  The
+    cache, pipeline and deferAliases options do not apply.  A priority
+    load creates every variable before the ready function is called.
+    Failures are reported against the index of the resolved variable
+    rather than of its definition.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        pList
+            pointer to the list of config files to load
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval EOK - variable creation was successful
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+int varsnap_CreateInstances( VARSERVER_HANDLE hVarServer,
+                             VarCreateFileList *pList,
+                             VarCreateOptions *options )
+{
+    int result = EINVAL;
+    VarCreateOptions opts;
+    VarCreateStats stats;
+    VarSnapWriter writer;
+    VarLoad load;
+    const char *name;
+    char *image;
+    uint64_t start;
+    size_t i;
+    int rc;
+
+    if ( ( hVarServer != NULL ) &&
+         ( pList != NULL ) &&
+         ( options != NULL ) &&
+         ( options->instances != NULL ) )
+    {
+        memset( &stats, 0, sizeof( VarCreateStats ) );
+        memset( &writer, 0, sizeof( VarSnapWriter ) );
+        start = varsnap_fnClock( options );
+
+        /* resolve the definitions once, leaving the options which are
+           applied to each instance for varsnap_fnBuildVarInfo */
+        opts = *options;
+        opts.prefix = NULL;
+        opts.flags = 0;
+        opts.verbose = false;
+        opts.pipeline = false;
+        opts.deferAliases = false;
+        opts.priority = false;
+        opts.preflight = false;
+        opts.cache = NULL;
+        opts.index = NULL;
+        opts.stats = ( options->stats != NULL ) ? &stats : NULL;
+        opts.fileStats = NULL;
+
+        name = ( pList->count == 1 ) ? pList->files[0] : NULL;
+
+        /* start the string table with the empty string */
+        result = varsnap_fnString( &writer, "", NULL );
+        if ( result == EOK )
+        {
+            result = varcreate_fnLoadBegin( &load, NULL, &opts );
+        }
+
+        if ( result == EOK )
+        {
+            load.pSnapshot = &writer;
+            for ( i = 0 ; i < pList->count ; i++ )
+            {
+                rc = varcreate_fnLoadFile( &load, pList->files[i] );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+            }
+
+            varcreate_fnLoadEnd( &load );
+
+            /* only the variables of the instances count as created */
+            stats.created = 0;
+            stats.createTime = 0;
+
+            image = varsnap_fnImage( &writer );
+            if ( image != NULL )
+            {
+                rc = varsnap_fnInstances( hVarServer,
+                                          name,
+                                          image,
+                                          options,
+                                          &stats );
+                if ( rc != EOK )
+                {
+                    result = rc;
+                }
+
+                free( image );
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        varsnap_fnFree( &writer );
+        varlog_Flush();
+        varsnap_fnReady( options );
+
+        if ( options->stats != NULL )
+        {
+            stats.files = pList->count;
+            stats.totalTime = varsnap_fnClock( options ) - start;
+            varcreate_fnAddStats( options, &stats );
+
+            /* the statistics are only for a file on its own */
+            if ( ( options->fileStats != NULL ) &&
+                 ( name != NULL ) )
+            {
+                options->fileStats( name, &stats );
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_Add                                                               */
+/*!
+    Add a variable definition to a snapshot
+
+    The varsnap_Add function appends a record for the fully populated
+    VarInfo object to the snapshot.  On success the hVar member of the
+    VarInfo object is set to a handle which identifies the record, so
+    the variable's aliases can be attached to it with varsnap_AddAlias.
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @param[in,out]
+        pVarInfo
+            pointer to the VarInfo object describing the variable
+
+    @retval EOK - the record was added
+    @retval EINVAL - invalid arguments
+    @retval ENOTSUP - the variable cannot be stored in a snapshot
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varsnap_Add( VarSnapWriter *pWriter, VarInfo *pVarInfo )
+{
+    int result = EINVAL;
+    VarSnapRecord *pRecord;
+    VarSnapRecord *p;
+    size_t size;
+    size_t n;
+
+    if ( ( pWriter != NULL ) &&
+         ( pVarInfo != NULL ) )
+    {
+        result = EOK;
+
+        if ( ( pVarInfo->var.type == VARTYPE_BLOB ) &&
+             ( pVarInfo->var.val.blob != NULL ) )
+        {
+            /* blob initial values cannot be stored */
+            result = ENOTSUP;
+        }
+        else if ( pWriter->count == pWriter->size )
+        {
+            size = ( pWriter->size == 0 ) ? 64 : pWriter->size * 2;
+            p = realloc( pWriter->records, size * sizeof( VarSnapRecord ) );
+            if ( p != NULL )
+            {
+                pWriter->records = p;
+                pWriter->size = size;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if ( result == EOK )
+        {
+            pRecord = &pWriter->records[pWriter->count];
+            memset( pRecord, 0, sizeof( VarSnapRecord ) );
+
+            pRecord->guid = pVarInfo->guid;
+            pRecord->flags = pVarInfo->flags;
+            pRecord->type = pVarInfo->var.type;
+            pRecord->len = pVarInfo->var.len;
+            pRecord->value = VARSNAP_NONE;
+
+            if ( pVarInfo->var.type == VARTYPE_STR )
+            {
+                if ( pVarInfo->var.val.str != NULL )
+                {
+                    result = varsnap_fnString( pWriter,
+                                               pVarInfo->var.val.str,
+                                               &pRecord->value );
+                }
+            }
+            else if ( pVarInfo->var.type != VARTYPE_BLOB )
+            {
+                memcpy( &pRecord->data,
+                        &pVarInfo->var.val,
+                        sizeof( pRecord->data ) );
+            }
+
+            n = pVarInfo->permissions.nreads;
+            pRecord->nreads = ( n < VARSERVER_MAX_UIDS ) ? n
+                                                         : VARSERVER_MAX_UIDS;
+            for ( n = 0 ; n < pRecord->nreads ; n++ )
+            {
+                pRecord->read[n] = pVarInfo->permissions.read[n];
+            }
+
+            n = pVarInfo->permissions.nwrites;
+            pRecord->nwrites = ( n < VARSERVER_MAX_UIDS ) ? n
+                                                          : VARSERVER_MAX_UIDS;
+            for ( n = 0 ; n < pRecord->nwrites ; n++ )
+            {
+                pRecord->write[n] = pVarInfo->permissions.write[n];
+            }
+
+            if ( result == EOK )
+            {
+                result = varsnap_fnString( pWriter,
+                                           pVarInfo->name,
+                                           &pRecord->name );
+            }
+
+            if ( result == EOK )
+            {
+                result = varsnap_fnString( pWriter,
+                                           pVarInfo->formatspec,
+                                           &pRecord->formatspec );
+            }
+
+            if ( result == EOK )
+            {
+                result = varsnap_fnString( pWriter,
+                                           pVarInfo->tagspec,
+                                           &pRecord->tagspec );
+            }
+
+            if ( result == EOK )
+            {
+                pWriter->count++;
+                pVarInfo->hVar = (VAR_HANDLE)pWriter->count;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_AddAlias                                                          */
+/*!
+    Add an alias to a snapshot
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @param[in]
+        hVar
+            handle of the record to be aliased, as assigned by varsnap_Add
+
+    @param[in]
+        name
+            name of the alias
+
+    @retval EOK - the alias was added
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+int varsnap_AddAlias( VarSnapWriter *pWriter,
+                      VAR_HANDLE hVar,
+                      const char *name )
+{
+    int result = EINVAL;
+    VarSnapAlias *p;
+    size_t size;
+
+    if ( ( pWriter != NULL ) &&
+         ( hVar != VAR_INVALID ) &&
+         ( (size_t)hVar <= pWriter->count ) &&
+         ( name != NULL ) )
+    {
+        result = EOK;
+
+        if ( pWriter->naliases == pWriter->aliasSize )
+        {
+            size = ( pWriter->aliasSize == 0 ) ? 64 : pWriter->aliasSize * 2;
+            p = realloc( pWriter->aliases, size * sizeof( VarSnapAlias ) );
+            if ( p != NULL )
+            {
+                pWriter->aliases = p;
+                pWriter->aliasSize = size;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if ( result == EOK )
+        {
+            p = &pWriter->aliases[pWriter->naliases];
+            p->record = (uint32_t)hVar - 1;
+            result = varsnap_fnString( pWriter, name, &p->name );
+            if ( result == EOK )
+            {
+                pWriter->naliases++;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnString                                                          */
+/*!
+    Add a string to the snapshot string table
+
+    Each distinct string is stored once, so repeated tag and format
+    specifiers share a single copy.  The first string added is stored
+    at offset 0.
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @param[in]
+        str
+            pointer to the NUL terminated string to add
+
+    @param[out]
+        pOffset
+            pointer to a location to store the offset of the string.
+            May be NULL.
+
+    @retval EOK - the string was added
+    @retval E2BIG - the string table is full
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varsnap_fnString( VarSnapWriter *pWriter,
+                             const char *str,
+                             uint32_t *pOffset )
+{
+    int result = EOK;
+    uint32_t *slot = NULL;
+    size_t len;
+    size_t size;
+    char *p;
+
+    if ( pWriter->nstrings * 2 >= pWriter->hashSize )
+    {
+        result = varsnap_fnGrowHash( pWriter );
+    }
+
+    if ( result == EOK )
+    {
+        slot = varsnap_fnFind( pWriter, str );
+    }
+
+    if ( ( slot != NULL ) && ( *slot != 0 ) )
+    {
+        /* share the existing copy */
+        if ( pOffset != NULL )
+        {
+            *pOffset = *slot - 1;
+        }
+    }
+    else if ( slot != NULL )
+    {
+        len = strlen( str ) + 1;
+        if ( pWriter->strlen + len >= VARSNAP_NONE )
+        {
+            result = E2BIG;
+        }
+        else if ( pWriter->strlen + len > pWriter->strsize )
+        {
+            size = ( pWriter->strsize == 0 ) ? 4096 : pWriter->strsize;
+            while ( size < pWriter->strlen + len )
+            {
+                size *= 2;
+            }
+
+            p = realloc( pWriter->strings, size );
+            if ( p != NULL )
+            {
+                pWriter->strings = p;
+                pWriter->strsize = size;
+            }
+            else
+            {
+                result = ENOMEM;
+            }
+        }
+
+        if ( result == EOK )
+        {
+            memcpy( &pWriter->strings[pWriter->strlen], str, len );
+            if ( pOffset != NULL )
+            {
+                *pOffset = (uint32_t)pWriter->strlen;
+            }
+
+            *slot = (uint32_t)pWriter->strlen + 1;
+            pWriter->nstrings++;
+            pWriter->strlen += len;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnFind                                                            */
+/*!
+    Find the hash table slot for a string
+
+    The varsnap_fnFind function hashes the string with FNV-1a and
+    probes the hash table linearly until it finds the slot holding
+    the string, or the empty slot where it should be stored.
+    The hash table must have at least one empty slot.
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @param[in]
+        str
+            pointer to the NUL terminated string to find
+
+    @retval pointer to the slot for the string
+
+==============================================================================*/
+static uint32_t *varsnap_fnFind( VarSnapWriter *pWriter, const char *str )
+{
+    uint32_t h = 2166136261u;
+    const unsigned char *p = (const unsigned char *)str;
+    size_t mask = pWriter->hashSize - 1;
+    size_t i;
+
+    while ( *p != '\0' )
+    {
+        h = ( h ^ *p++ ) * 16777619u;
+    }
+
+    i = h & mask;
+    while ( ( pWriter->hash[i] != 0 ) &&
+            ( strcmp( &pWriter->strings[pWriter->hash[i] - 1], str ) != 0 ) )
+    {
+        i = ( i + 1 ) & mask;
+    }
+
+    return &pWriter->hash[i];
+}
+
+/*============================================================================*/
+/*  varsnap_fnGrowHash                                                        */
+/*!
+    Double the size of the string hash table
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @retval EOK - the hash table was resized
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int varsnap_fnGrowHash( VarSnapWriter *pWriter )
+{
+    int result = ENOMEM;
+    uint32_t *old = pWriter->hash;
+    size_t oldSize = pWriter->hashSize;
+    size_t size;
+    size_t i;
+
+    size = ( oldSize == 0 ) ? 256 : oldSize * 2;
+    pWriter->hash = calloc( size, sizeof( uint32_t ) );
+    if ( pWriter->hash != NULL )
+    {
+        pWriter->hashSize = size;
+
+        /* re-insert the existing strings */
+        for ( i = 0 ; i < oldSize ; i++ )
+        {
+            if ( old[i] != 0 )
+            {
+                *varsnap_fnFind( pWriter,
+                                 &pWriter->strings[old[i] - 1] ) = old[i];
+            }
+        }
+
+        free( old );
+        result = EOK;
+    }
+    else
+    {
+        pWriter->hash = old;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnWrite                                                           */
+/*!
+    Write a snapshot file
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @param[in]
+        filename
+            name of the snapshot file to write
+
+    @retval EOK - the snapshot was written
+    @retval EIO - the snapshot could not be written
+
+==============================================================================*/
+static int varsnap_fnWrite( VarSnapWriter *pWriter, char *filename )
+{
+    int result = EIO;
+    VarSnapHeader header;
+    int fd;
+
+    memset( &header, 0, sizeof( VarSnapHeader ) );
+    memcpy( header.magic, VARSNAP_MAGIC, sizeof( header.magic ) );
+    header.version = VARSNAP_VERSION;
+    header.recordSize = sizeof( VarSnapRecord );
+    header.count = pWriter->count;
+    header.naliases = pWriter->naliases;
+    header.strsize = pWriter->strlen;
+
+    fd = open( filename, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if ( fd != -1 )
+    {
+        result = varsnap_fnWriteData( fd, &header, sizeof header );
+        if ( result == EOK )
+        {
+            result = varsnap_fnWriteData( fd,
+                                          pWriter->records,
+                                          pWriter->count *
+                                            sizeof( VarSnapRecord ) );
+        }
+
+        if ( result == EOK )
+        {
+            result = varsnap_fnWriteData( fd,
+                                          pWriter->aliases,
+                                          pWriter->naliases *
+                                            sizeof( VarSnapAlias ) );
+        }
+
+        if ( result == EOK )
+        {
+            result = varsnap_fnWriteData( fd,
+                                          pWriter->strings,
+                                          pWriter->strlen );
+        }
+
+        if ( close( fd ) != 0 )
+        {
+            result = EIO;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnWriteData                                                       */
+/*!
+    Write a block of data to a file
+
+    @param[in]
+        fd
+            file descriptor to write to
+
+    @param[in]
+        data
+            pointer to the data to write
+
+    @param[in]
+        len
+            number of bytes to write
+
+    @retval EOK - the data was written
+    @retval EIO - the data could not be written
+
+==============================================================================*/
+static int varsnap_fnWriteData( int fd, const void *data, size_t len )
+{
+    int result = EOK;
+    const char *p = (const char *)data;
+    ssize_t n;
+
+    while ( ( result == EOK ) && ( len > 0 ) )
+    {
+        n = write( fd, p, len );
+        if ( n > 0 )
+        {
+            p += n;
+            len -= n;
+        }
+        else if ( ( n == -1 ) && ( errno == EINTR ) )
+        {
+            continue;
+        }
+        else
+        {
+            result = EIO;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnWriteTable                                                      */
+/*!
+    Write a snapshot image to a C source file
+
+    The image is written as an array of 64 bit words, so it has the
+    alignment the records require, followed by the VarCreateTable
+    object which refers to it.  The words are written in the byte order
+    of this machine, so the table is only valid for a program built for
+    a machine with the same byte order and variable server limits.
+
+    @param[in]
+        image
+            pointer to the snapshot image
+
+    @param[in]
+        len
+            size of the snapshot image in bytes
+
+    @param[in]
+        filename
+            name of the JSON config file the image was compiled from
+
+    @param[in]
+        source
+            name of the C source file to write
+
+    @param[in]
+        symbol
+            name of the VarCreateTable object
+
+    @retval EOK - the source file was written
+    @retval EIO - the source file could not be written
+
+==============================================================================*/
+static int varsnap_fnWriteTable( const char *image,
+                                 size_t len,
+                                 const char *filename,
+                                 const char *source,
+                                 const char *symbol )
+{
+    int result = EIO;
+    uint64_t word;
+    size_t words;
+    size_t n;
+    size_t i;
+    FILE *fp;
+
+    fp = fopen( source, "w" );
+    if ( fp != NULL )
+    {
+        fprintf( fp,
+                 "/* generated by varcreate from %s.  Do not edit */\n\n"
+                 "#include <stdint.h>\n"
+                 "#include <varcreate/libvarcreate.h>\n\n"
+                 "static const uint64_t %s_image[] =\n{",
+                 filename,
+                 symbol );
+
+        words = ( len + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+        for ( i = 0 ; i < words ; i++ )
+        {
+            /* the final word is padded with zeros */
+            word = 0;
+            n = len - ( i * sizeof( uint64_t ) );
+            memcpy( &word,
+                    &image[i * sizeof( uint64_t )],
+                    ( n < sizeof( uint64_t ) ) ? n : sizeof( uint64_t ) );
+
+            fprintf( fp,
+                     "%s0x%016" PRIx64 "%s",
+                     ( ( i % 4 ) == 0 ) ? "\n    " : " ",
+                     word,
+                     ( i + 1 < words ) ? "," : "" );
+        }
+
+        fprintf( fp,
+                 "\n};\n\n"
+                 "const VarCreateTable %s =\n"
+                 "{\n"
+                 "    %s_image,\n"
+                 "    %zu\n"
+                 "};\n",
+                 symbol,
+                 symbol,
+                 len );
+
+        result = ( ferror( fp ) == 0 ) ? EOK : EIO;
+
+        if ( fclose( fp ) != 0 )
+        {
+            result = EIO;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnIsSymbol                                                        */
+/*!
+    Determine whether a string is a valid C identifier
+
+    @param[in]
+        symbol
+            NUL terminated string to check
+
+    @retval true - the string is a valid C identifier
+    @retval false - the string is NULL or not a valid C identifier
+
+==============================================================================*/
+static bool varsnap_fnIsSymbol( const char *symbol )
+{
+    bool result = false;
+    size_t i;
+
+    if ( ( symbol != NULL ) &&
+         ( ( isalpha( (unsigned char)symbol[0] ) ) ||
+           ( symbol[0] == '_' ) ) )
+    {
+        result = true;
+
+        for ( i = 1 ; symbol[i] != '\0' ; i++ )
+        {
+            if ( ( !isalnum( (unsigned char)symbol[i] ) ) &&
+                 ( symbol[i] != '_' ) )
+            {
+                result = false;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnImage                                                           */
+/*!
+    Lay out a snapshot in memory
+
+    The varsnap_fnImage function copies the header, records, aliases and
+    string table of a snapshot writer into a single buffer laid out
+    exactly as varsnap_fnWrite stores them in a snapshot file.
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+    @retval pointer to the snapshot image, which the caller frees
+    @retval NULL if the memory could not be allocated
+
+==============================================================================*/
+static char *varsnap_fnImage( VarSnapWriter *pWriter )
+{
+    VarSnapHeader *pHeader;
+    char *image;
+    char *p;
+    size_t len;
+
+    len = sizeof( VarSnapHeader ) +
+          pWriter->count * sizeof( VarSnapRecord ) +
+          pWriter->naliases * sizeof( VarSnapAlias ) +
+          pWriter->strlen;
+
+    image = malloc( len );
+    if ( image != NULL )
+    {
+        pHeader = (VarSnapHeader *)image;
+        memset( pHeader, 0, sizeof( VarSnapHeader ) );
+        memcpy( pHeader->magic, VARSNAP_MAGIC, sizeof( pHeader->magic ) );
+        pHeader->version = VARSNAP_VERSION;
+        pHeader->recordSize = sizeof( VarSnapRecord );
+        pHeader->count = pWriter->count;
+        pHeader->naliases = pWriter->naliases;
+        pHeader->strsize = pWriter->strlen;
+
+        p = image + sizeof( VarSnapHeader );
+        if ( pWriter->count > 0 )
+        {
+            memcpy( p,
+                    pWriter->records,
+                    pWriter->count * sizeof( VarSnapRecord ) );
+            p += pWriter->count * sizeof( VarSnapRecord );
+        }
+
+        if ( pWriter->naliases > 0 )
+        {
+            memcpy( p,
+                    pWriter->aliases,
+                    pWriter->naliases * sizeof( VarSnapAlias ) );
+            p += pWriter->naliases * sizeof( VarSnapAlias );
+        }
+
+        memcpy( p, pWriter->strings, pWriter->strlen );
+    }
+
+    return image;
+}
+
+/*============================================================================*/
+/*  varsnap_fnFree                                                            */
+/*!
+    Release the storage used by a snapshot writer
+
+    @param[in]
+        pWriter
+            pointer to the snapshot writer
+
+==============================================================================*/
+static void varsnap_fnFree( VarSnapWriter *pWriter )
+{
+    free( pWriter->records );
+    free( pWriter->aliases );
+    free( pWriter->strings );
+    free( pWriter->hash );
+    memset( pWriter, 0, sizeof( VarSnapWriter ) );
+}
+
+/*============================================================================*/
+/*  varsnap_fnCheck                                                           */
+/*!
+    Validate a snapshot image
+
+    The varsnap_fnCheck function checks the snapshot header against
+    the size of the image, and checks that every string table offset
+    lies within the string table, so the records can be used without
+    further bounds checks.
+
+    @param[in]
+        data
+            pointer to the snapshot image
+
+    @param[in]
+        len
+            size of the snapshot image
+
+    @retval EOK - the snapshot is valid
+    @retval EBADMSG - the snapshot is not valid
+
+==============================================================================*/
+static int varsnap_fnCheck( const char *data, size_t len )
+{
+    int result = EBADMSG;
+    const VarSnapHeader *pHeader = (const VarSnapHeader *)data;
+    const VarSnapRecord *pRecords;
+    const VarSnapAlias *pAliases;
+    const VarSnapRecord *r;
+    uint64_t expected;
+    uint32_t strsize;
+    size_t i;
+
+    expected = (uint64_t)sizeof( VarSnapHeader ) +
+               (uint64_t)pHeader->count * sizeof( VarSnapRecord ) +
+               (uint64_t)pHeader->naliases * sizeof( VarSnapAlias ) +
+               pHeader->strsize;
+
+    if ( ( memcmp( pHeader->magic,
+                   VARSNAP_MAGIC,
+                   sizeof( pHeader->magic ) ) == 0 ) &&
+         ( pHeader->version == VARSNAP_VERSION ) &&
+         ( pHeader->recordSize == sizeof( VarSnapRecord ) ) &&
+         ( expected == len ) &&
+         ( pHeader->strsize > 0 ) &&
+         ( data[len - 1] == '\0' ) )
+    {
+        result = EOK;
+
+        pRecords = (const VarSnapRecord *)( data + sizeof( VarSnapHeader ) );
+        pAliases = (const VarSnapAlias *)( &pRecords[pHeader->count] );
+        strsize = pHeader->strsize;
+
+        for ( i = 0 ; ( result == EOK ) && ( i < pHeader->count ) ; i++ )
+        {
+            r = &pRecords[i];
+            if ( ( r->name >= strsize ) ||
+                 ( r->formatspec >= strsize ) ||
+                 ( r->tagspec >= strsize ) ||
+                 ( ( r->value != VARSNAP_NONE ) &&
+                   ( r->value >= strsize ) ) ||
+                 ( r->nreads > VARSERVER_MAX_UIDS ) ||
+                 ( r->nwrites > VARSERVER_MAX_UIDS ) )
+            {
+                result = EBADMSG;
+            }
+        }
+
+        for ( i = 0 ; ( result == EOK ) && ( i < pHeader->naliases ) ; i++ )
+        {
+            if ( ( pAliases[i].record >= pHeader->count ) ||
+                 ( pAliases[i].name >= strsize ) )
+            {
+                result = EBADMSG;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnCreate                                                          */
+/*!
+    Create the variables described by a validated snapshot image
+
+    The varsnap_fnCreate function submits the variable records to the
+    variable server in batches, then creates the aliases of each
+    variable which was created successfully.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        snapshot
+            name of the snapshot file, which failures are reported against
+
+    @param[in]
+        data
+            pointer to the validated snapshot image
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @param[in,out]
+        pStats
+            pointer to the statistics of the snapshot load
+
+    @retval EOK - variable creation was successful
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+static int varsnap_fnCreate( VARSERVER_HANDLE hVarServer,
+                             const char *snapshot,
+                             const char *data,
+                             VarCreateOptions *options,
+                             VarCreateStats *pStats )
+{
+    int result = ENOMEM;
+    const VarSnapHeader *pHeader = (const VarSnapHeader *)data;
+    const VarSnapRecord *pRecords;
+    const VarSnapAlias *pAliases;
+    const char *strings;
+    VarInfo *info;
+    int *results;
+    VAR_HANDLE *handles;
+    VarCreateAlias alias;
+    size_t *index;
+    size_t existing;
+    size_t changed;
+    size_t updated;
+    size_t batchSize;
+    size_t base;
+    size_t n;
+    size_t i;
+    uint64_t start;
+    int rc;
+
+    pRecords = (const VarSnapRecord *)( data + sizeof( VarSnapHeader ) );
+    pAliases = (const VarSnapAlias *)( &pRecords[pHeader->count] );
+    strings = (const char *)( &pAliases[pHeader->naliases] );
+
+    batchSize = ( options->batchSize > 1 ) ? options->batchSize
+                                           : VARCREATE_DEFAULT_BATCH_SIZE;
+
+    info = calloc( batchSize, sizeof( VarInfo ) );
+    results = calloc( batchSize, sizeof( int ) );
+    index = calloc( batchSize, sizeof( size_t ) );
+    handles = calloc( pHeader->count + 1, sizeof( VAR_HANDLE ) );
+
+    if ( ( info != NULL ) &&
+         ( results != NULL ) &&
+         ( index != NULL ) &&
+         ( handles != NULL ) )
+    {
+        result = EOK;
+
+        base = 0;
+        while ( base < pHeader->count )
+        {
+            /* gather the next batch of records */
+            start = varsnap_fnClock( options );
+            n = 0;
+            while ( ( n < batchSize ) && ( base < pHeader->count ) )
+            {
+                rc = varsnap_fnBuildVarInfo( &pRecords[base],
+                                             strings,
+                                             options,
+                                             &info[n] );
+                if ( rc == EOK )
+                {
+                    index[n++] = base;
+                }
+                else
+                {
+                    varlog_Printf( options,
+                                   "Failed to create variable: %s\n",
+                                   &strings[pRecords[base].name] );
+                    varlog_Report( options,
+                                   snapshot,
+                                   base,
+                                   &strings[pRecords[base].name],
+                                   NULL,
+                                   rc );
+                    pStats->failed++;
+                    result = rc;
+                }
+
+                base++;
+            }
+
+            pStats->handlerTime += varsnap_fnClock( options ) - start;
+
+            start = varsnap_fnClock( options );
+            existing = 0;
+            changed = 0;
+            updated = 0;
+            if ( options->reconcile == true )
+            {
+                /* only create the variables which do not exist yet */
+                rc = varrecon_CreateBatch( hVarServer,
+                                           options,
+                                           info,
+                                           n,
+                                           results,
+                                           &existing,
+                                           &changed,
+                                           &updated );
+            }
+            else
+            {
+                rc = VARCREATE_CreateBatch( hVarServer, info, n, results );
+            }
+            pStats->createTime += varsnap_fnClock( options ) - start;
+
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+
+            for ( i = 0 ; i < n ; i++ )
+            {
+                if ( ( results[i] == EOK ) &&
+                     ( info[i].hVar != VAR_INVALID ) )
+                {
+                    handles[index[i]] = info[i].hVar;
+                    pStats->created++;
+                    varindex_Add( options->index, info[i].name, info[i].hVar );
+                }
+                else
+                {
+                    varlog_Printf( options,
+                                   "Failed to create variable: %s\n",
+                                   info[i].name );
+                    varlog_Report( options,
+                                   snapshot,
+                                   index[i],
+                                   info[i].name,
+                                   NULL,
+                                   ( results[i] != EOK ) ? results[i]
+                                                         : ENOENT );
+                    pStats->failed++;
+                }
+            }
+
+            /* the existing variables were not created */
+            pStats->created -= existing + changed + updated;
+            pStats->existing += existing;
+            pStats->changed += changed;
+            pStats->updated += updated;
+        }
+
+        /* create the aliases now that every variable exists */
+        start = varsnap_fnClock( options );
+        for ( i = 0 ; i < pHeader->naliases ; i++ )
+        {
+            if ( handles[pAliases[i].record] != VAR_INVALID )
+            {
+                VARPROBE_BEGIN( alias,
+                                &strings[pAliases[i].name],
+                                handles[pAliases[i].record] );
+
+                existing = 0;
+                if ( options->reconcile == true )
+                {
+                    alias.hVar = handles[pAliases[i].record];
+                    alias.name = (char *)&strings[pAliases[i].name];
+                    rc = varrecon_CreateAliasBatch( hVarServer,
+                                                    &alias,
+                                                    1,
+                                                    NULL,
+                                                    &existing );
+                }
+                else
+                {
+                    rc = VAR_Alias( hVarServer,
+                                    handles[pAliases[i].record],
+                                    (char *)&strings[pAliases[i].name],
+                                    NULL );
+                }
+
+                VARPROBE_END( alias, &strings[pAliases[i].name], rc );
+
+                if ( rc == EOK )
+                {
+                    /* an existing alias is left as it is */
+                    pStats->aliased += ( existing == 0 ) ? 1 : 0;
+                    pStats->existing += existing;
+                    varindex_Add( options->index,
+                                  &strings[pAliases[i].name],
+                                  handles[pAliases[i].record] );
+                }
+                else
+                {
+                    varlog_Printf( options,
+                                   "Failed to create alias: %s\n",
+                                   &strings[pAliases[i].name] );
+                    varlog_Report( options,
+                                   snapshot,
+                                   pAliases[i].record,
+                                   &strings[pAliases[i].name],
+                                   "alias",
+                                   rc );
+                    result = rc;
+                }
+            }
+        }
+
+        pStats->aliasTime += varsnap_fnClock( options ) - start;
+    }
+
+    free( info );
+    free( results );
+    free( index );
+    free( handles );
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnInstances                                                       */
+/*!
+    Create the variables of a validated snapshot image for each instance
+
+    The varsnap_fnInstances function creates the variables once with
+    the instanceID of the options, or once for each identifier in the
+    instances array of the options if it has one.
+
+    @param[in]
+        hVarServer
+            handle to the Variable Server to create variables for
+
+    @param[in]
+        name
+            name of the file which failures are reported against, or NULL
+
+    @param[in]
+        data
+            pointer to the validated snapshot image
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @param[in,out]
+        pStats
+            pointer to the statistics of the load
+
+    @retval EOK - variable creation was successful
+    @retval ENOMEM - memory allocation problem
+    @retval other - one or more variables could not be created
+
+==============================================================================*/
+static int varsnap_fnInstances( VARSERVER_HANDLE hVarServer,
+                                const char *name,
+                                const char *data,
+                                VarCreateOptions *options,
+                                VarCreateStats *pStats )
+{
+    int result = EOK;
+    VarCreateOptions opts;
+    size_t i;
+    int rc;
+
+    if ( options->instances == NULL )
+    {
+        result = varsnap_fnCreate( hVarServer, name, data, options, pStats );
+    }
+    else
+    {
+        opts = *options;
+        for ( i = 0 ; i < options->instanceCount ; i++ )
+        {
+            opts.instanceID = options->instances[i];
+            rc = varsnap_fnCreate( hVarServer, name, data, &opts, pStats );
+            if ( rc != EOK )
+            {
+                result = rc;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnClock                                                           */
+/*!
+    Read the monotonic clock if statistics are being gathered
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @retval the monotonic clock time in nanoseconds
+    @retval 0 if the options have no statistics
+
+==============================================================================*/
+static uint64_t varsnap_fnClock( VarCreateOptions *options )
+{
+    return ( options->stats != NULL ) ? varcreate_fnNow() : 0;
+}
+
+/*============================================================================*/
+/*  varsnap_fnReady                                                           */
+/*!
+    Call the ready function of a priority load
+
+    The resolved variables of a snapshot do not record their priority,
+    so the ready function is called once every variable of the load has
+    been created, whether or not they all could be.  Nothing is done if
+    the priority option is not set.
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+==============================================================================*/
+static void varsnap_fnReady( VarCreateOptions *options )
+{
+    if ( ( options->priority == true ) &&
+         ( options->ready != NULL ) )
+    {
+        options->ready( options->readyArg );
+    }
+}
+
+/*============================================================================*/
+/*  varsnap_fnBuildVarInfo                                                    */
+/*!
+    Build a VarInfo object from a snapshot record
+
+    The varsnap_fnBuildVarInfo function copies the variable record into
+    the VarInfo object and applies the variable creation options.
+    String initial values refer directly to the snapshot image.
+
+    @param[in]
+        pRecord
+            pointer to the validated snapshot record
+
+    @param[in]
+        strings
+            pointer to the snapshot string table
+
+    @param[in]
+        options
+            pointer to the options used to modify the variable creation
+            behavior.
+
+    @param[out]
+        pVarInfo
+            pointer to the VarInfo object to populate
+
+    @retval EOK - the VarInfo object was populated
+    @retval E2BIG - a string is too long for the VarInfo object
+
+==============================================================================*/
+static int varsnap_fnBuildVarInfo( const VarSnapRecord *pRecord,
+                                   const char *strings,
+                                   VarCreateOptions *options,
+                                   VarInfo *pVarInfo )
+{
+    int result;
+    char buf[MAX_NAME_LEN+1];
+    size_t i;
+
+    memset( pVarInfo, 0, sizeof( VarInfo ) );
+
+    pVarInfo->guid = pRecord->guid;
+    pVarInfo->flags = pRecord->flags | options->flags;
+    pVarInfo->instanceID = options->instanceID;
+    pVarInfo->var.type = (VarType)pRecord->type;
+    pVarInfo->var.len = pRecord->len;
+
+    if ( pVarInfo->var.type == VARTYPE_STR )
+    {
+        if ( pRecord->value != VARSNAP_NONE )
+        {
+            pVarInfo->var.val.str = (char *)&strings[pRecord->value];
+        }
+    }
+    else if ( pVarInfo->var.type != VARTYPE_BLOB )
+    {
+        memcpy( &pVarInfo->var.val,
+                &pRecord->data,
+                sizeof( pRecord->data ) );
+    }
+
+    pVarInfo->permissions.nreads = pRecord->nreads;
+    for ( i = 0 ; i < pRecord->nreads ; i++ )
+    {
+        pVarInfo->permissions.read[i] = pRecord->read[i];
+    }
+
+    pVarInfo->permissions.nwrites = pRecord->nwrites;
+    for ( i = 0 ; i < pRecord->nwrites ; i++ )
+    {
+        pVarInfo->permissions.write[i] = pRecord->write[i];
+    }
+
+    result = varsnap_fnCopy( pVarInfo->name,
+                             sizeof( pVarInfo->name ),
+                             &strings[pRecord->name] );
+    if ( result == EOK )
+    {
+        result = varsnap_fnCopy( pVarInfo->formatspec,
+                                 sizeof( pVarInfo->formatspec ),
+                                 &strings[pRecord->formatspec] );
+    }
+
+    if ( result == EOK )
+    {
+        result = varsnap_fnCopy( pVarInfo->tagspec,
+                                 sizeof( pVarInfo->tagspec ),
+                                 &strings[pRecord->tagspec] );
+    }
+
+    if ( ( result == EOK ) &&
+         ( options->prefix != NULL ) )
+    {
+        /* prepend the variable name with the variable prefix */
+        snprintf( buf,
+                  MAX_NAME_LEN+1,
+                  "%s%s",
+                  options->prefix,
+                  pVarInfo->name );
+        strcpy( pVarInfo->name, buf );
+    }
+
+    if ( ( result == EOK ) &&
+         ( options->verbose ) )
+    {
+        varlog_Printf( options,
+                       "VARCREATE: Creating variable: %s\n",
+                       pVarInfo->name );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varsnap_fnCopy                                                            */
+/*!
+    Copy a string from the snapshot string table
+
+    @param[out]
+        dst
+            pointer to the destination buffer
+
+    @param[in]
+        size
+            size of the destination buffer
+
+    @param[in]
+        src
+            pointer to the NUL terminated source string
+
+    @retval EOK - the string was copied
+    @retval E2BIG - the string is too long for the destination
+
+==============================================================================*/
+static int varsnap_fnCopy( char *dst, size_t size, const char *src )
+{
+    int result = E2BIG;
+    size_t len;
+
+    len = strlen( src );
+    if ( len < size )
+    {
+        memcpy( dst, src, len + 1 );
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*! @}
+ * end of libvarcreate group */
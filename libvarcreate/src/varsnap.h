@@ -0,0 +1,193 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARSNAP_H
+#define VARSNAP_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! identifies a varcreate snapshot file */
+#define VARSNAP_MAGIC                   "VCB1"
+
+/*! version of the snapshot layout */
+#define VARSNAP_VERSION                 ( 1 )
+
+/*! string table offset used when a string is not present */
+#define VARSNAP_NONE                    ( 0xFFFFFFFFu )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! The VarSnapHeader object is at the start of every snapshot file.
+    It is followed by the variable records, then the alias records, then
+    the string table.  All values are stored in the byte order of the
+    machine which compiled the snapshot */
+typedef struct _VarSnapHeader
+{
+    /*! identifies the file as a snapshot */
+    char magic[4];
+
+    /*! version of the snapshot layout */
+    uint32_t version;
+
+    /*! size of each variable record in bytes */
+    uint32_t recordSize;
+
+    /*! number of variable records */
+    uint32_t count;
+
+    /*! number of alias records */
+    uint32_t naliases;
+
+    /*! size of the string table in bytes */
+    uint32_t strsize;
+
+} VarSnapHeader;
+
+/*! The VarSnapRecord object holds a fully resolved variable definition.
+    Strings are stored as offsets into the string table */
+typedef struct _VarSnapRecord
+{
+    /*! variable GUID */
+    uint32_t guid;
+
+    /*! variable flags */
+    uint32_t flags;
+
+    /*! variable type */
+    uint32_t type;
+
+    /*! variable length, including the NUL terminator for strings */
+    uint32_t len;
+
+    /*! offset of the variable name */
+    uint32_t name;
+
+    /*! offset of the format specifier */
+    uint32_t formatspec;
+
+    /*! offset of the tag specifier */
+    uint32_t tagspec;
+
+    /*! offset of the initial value of a string variable, or VARSNAP_NONE */
+    uint32_t value;
+
+    /*! initial value of a numeric variable */
+    uint64_t data;
+
+    /*! number of read permission group identifiers */
+    uint32_t nreads;
+
+    /*! number of write permission group identifiers */
+    uint32_t nwrites;
+
+    /*! read permission group identifiers */
+    uint32_t read[VARSERVER_MAX_UIDS];
+
+    /*! write permission group identifiers */
+    uint32_t write[VARSERVER_MAX_UIDS];
+
+} VarSnapRecord;
+
+/*! The VarSnapAlias object associates an alias with a variable record */
+typedef struct _VarSnapAlias
+{
+    /*! index of the variable record to be aliased */
+    uint32_t record;
+
+    /*! offset of the alias name */
+    uint32_t name;
+
+} VarSnapAlias;
+
+/*! The VarSnapWriter object gathers variable definitions so they can
+    be written to a snapshot file */
+typedef struct _VarSnapWriter
+{
+    /*! array of variable records */
+    VarSnapRecord *records;
+
+    /*! number of variable records */
+    size_t count;
+
+    /*! number of variable records which can be held before growing */
+    size_t size;
+
+    /*! array of alias records */
+    VarSnapAlias *aliases;
+
+    /*! number of alias records */
+    size_t naliases;
+
+    /*! number of alias records which can be held before growing */
+    size_t aliasSize;
+
+    /*! string table */
+    char *strings;
+
+    /*! number of bytes used in the string table */
+    size_t strlen;
+
+    /*! size of the string table buffer */
+    size_t strsize;
+
+    /*! open addressing hash table of string table offsets plus one,
+        used to store each distinct string once.  Zero is an empty slot */
+    uint32_t *hash;
+
+    /*! number of slots in the hash table, always a power of two */
+    size_t hashSize;
+
+    /*! number of strings in the hash table */
+    size_t nstrings;
+
+} VarSnapWriter;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+int varsnap_Add( VarSnapWriter *pWriter, VarInfo *pVarInfo );
+
+int varsnap_AddAlias( VarSnapWriter *pWriter,
+                      VAR_HANDLE hVar,
+                      const char *name );
+
+int varsnap_CreateInstances( VARSERVER_HANDLE hVarServer,
+                             VarCreateFileList *pList,
+                             VarCreateOptions *options );
+
+#endif
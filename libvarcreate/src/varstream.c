@@ -0,0 +1,797 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varstream.c
+
+    Incremental varcreate JSON scanner
+
+    The varstream scanner extracts the elements of the "vars" array
+    from a varcreate JSON document which is supplied in arbitrarily
+    sized pieces.  Each element is handed to a callback as soon as it
+    is complete, so variable creation can begin before the whole
+    document has been read, and the memory required is bounded by the
+    size of the largest single variable definition rather than by the
+    size of the document.
+
+    A "defaults" object in the root of the document is extracted the
+    same way, provided that it precedes the "vars" array.
+
+    The scanner only tracks the document structure.  Each element is
+    validated when it is parsed by the callback.  Runs of characters
+    which cannot change the structure, such as the contents of strings
+    and the members of objects outside the "vars" array, are located
+    using the masks built by the structural scanner for each block of
+    the document, and are skipped or captured in one step.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <varcreate/libvarcreate.h>
+#include "varstream.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! initial size of the element capture buffer */
+#define VARSTREAM_INITIAL_BUFFER_SIZE       ( 1024 )
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static void varstream_fnBlock( VarStream *pStream,
+                               const char *data,
+                               size_t len,
+                               const uint64_t masks[2] );
+
+static size_t varstream_fnSkip( VarStream *pStream,
+                                const uint64_t masks[2],
+                                size_t pos,
+                                size_t len );
+
+static void varstream_fnProcessChar( VarStream *pStream, const char *p );
+
+static void varstream_fnValue( VarStream *pStream, const char *p );
+
+static void varstream_fnAppend( VarStream *pStream,
+                                const char *data,
+                                size_t len );
+
+static void varstream_fnEmit( VarStream *pStream, const char *end );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varstream_Init                                                            */
+/*!
+    Initialize an incremental varcreate JSON scanner
+
+    The varstream_Init function prepares a VarStream object to scan
+    a new varcreate JSON document.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object to initialize
+
+    @param[in]
+        fn
+            callback to invoke with each element of the "vars" array
+
+    @param[in]
+        defaultsFn
+            callback to invoke with the root "defaults" object, or NULL
+            to skip the "defaults" object
+
+    @param[in]
+        arg
+            opaque argument to pass to the callback
+
+    @retval EOK - the scanner was initialized
+    @retval EINVAL - invalid arguments
+
+==============================================================================*/
+int varstream_Init( VarStream *pStream,
+                    VarStreamFn fn,
+                    VarStreamFn defaultsFn,
+                    void *arg )
+{
+    int result = EINVAL;
+
+    if ( ( pStream != NULL ) &&
+         ( fn != NULL ) )
+    {
+        memset( pStream, 0, sizeof( VarStream ) );
+        pStream->fn = fn;
+        pStream->defaultsFn = defaultsFn;
+        pStream->arg = arg;
+        pStream->scan = varscan_Select();
+        pStream->result = EOK;
+
+        result = EOK;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varstream_Feed                                                            */
+/*!
+    Feed the next piece of a varcreate JSON document to the scanner
+
+    The varstream_Feed function scans the supplied data and invokes
+    the element callback for each element of the "vars" array which
+    is completed by this data.  An element may span any number of
+    calls to varstream_Feed.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        data
+            pointer to the next piece of the document
+
+    @param[in]
+        len
+            number of bytes of data to scan
+
+    @retval EOK - the data was scanned and all callbacks succeeded
+    @retval EINVAL - invalid arguments
+    @retval other - the scan or one of the element callbacks failed
+
+==============================================================================*/
+int varstream_Feed( VarStream *pStream, const char *data, size_t len )
+{
+    int result = EINVAL;
+    uint64_t masks[2];
+    size_t block;
+    size_t i = 0;
+
+    if ( ( pStream != NULL ) &&
+         ( data != NULL ) )
+    {
+        if ( pStream->capturing == true )
+        {
+            /* continue the element started by an earlier piece */
+            pStream->pending = data;
+        }
+
+        if ( pStream->scan == NULL )
+        {
+            /* no vector scanner, process each character in turn */
+            for ( i = 0 ; i < len ; i++ )
+            {
+                varstream_fnProcessChar( pStream, &data[i] );
+            }
+        }
+        else
+        {
+            while ( i < len )
+            {
+                block = len - i;
+                if ( block >= VARSCAN_BLOCK_SIZE )
+                {
+                    block = VARSCAN_BLOCK_SIZE;
+                    pStream->scan( &data[i], masks );
+                }
+                else
+                {
+                    varscan_Tail( &data[i], block, masks );
+                }
+
+                varstream_fnBlock( pStream, &data[i], block, masks );
+                i += block;
+            }
+        }
+
+        if ( pStream->capturing == true )
+        {
+            /* keep the part of the element in this piece */
+            varstream_fnAppend( pStream,
+                                pStream->pending,
+                                (size_t)( &data[len] - pStream->pending ) );
+        }
+
+        pStream->pending = NULL;
+
+        result = pStream->result;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varstream_Finish                                                          */
+/*!
+    Complete the scan of a varcreate JSON document
+
+    The varstream_Finish function checks that the document which was
+    fed to the scanner was complete.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @retval EOK - the document was scanned and all callbacks succeeded
+    @retval EBADMSG - the document was truncated or malformed
+    @retval EINVAL - the document does not contain a "vars" array
+    @retval other - one of the element callbacks failed
+
+==============================================================================*/
+int varstream_Finish( VarStream *pStream )
+{
+    int result = EINVAL;
+
+    if ( pStream != NULL )
+    {
+        if ( ( pStream->depth != 0 ) ||
+             ( pStream->inString == true ) ||
+             ( pStream->rootIsObject == false ) )
+        {
+            /* the document is incomplete */
+            pStream->result = EBADMSG;
+        }
+        else if ( ( pStream->varsFound == false ) &&
+                  ( pStream->result == EOK ) )
+        {
+            /* there were no variables to create */
+            pStream->result = EINVAL;
+        }
+
+        result = pStream->result;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varstream_Free                                                            */
+/*!
+    Release the resources used by a varcreate JSON scanner
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+==============================================================================*/
+void varstream_Free( VarStream *pStream )
+{
+    if ( pStream != NULL )
+    {
+        free( pStream->buf );
+        pStream->buf = NULL;
+        pStream->size = 0;
+        pStream->len = 0;
+    }
+}
+
+/*============================================================================*/
+/*  varstream_fnBlock                                                         */
+/*!
+    Process a block of the varcreate JSON document
+
+    The varstream_fnBlock function steps through a block classified by
+    the structural scanner, processing the significant characters one
+    at a time and skipping the runs between them.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        data
+            pointer to the block
+
+    @param[in]
+        len
+            number of characters in the block, at most VARSCAN_BLOCK_SIZE
+
+    @param[in]
+        masks
+            the masks of the block built by the structural scanner
+
+==============================================================================*/
+static void varstream_fnBlock( VarStream *pStream,
+                               const char *data,
+                               size_t len,
+                               const uint64_t masks[2] )
+{
+    size_t i = 0;
+    size_t n;
+
+    while ( i < len )
+    {
+        n = varstream_fnSkip( pStream, masks, i, len );
+        if ( n == 0 )
+        {
+            varstream_fnProcessChar( pStream, &data[i] );
+            n = 1;
+        }
+
+        i += n;
+    }
+}
+
+/*============================================================================*/
+/*  varstream_fnSkip                                                          */
+/*!
+    Skip a run of characters which cannot change the scanner state
+
+    The varstream_fnSkip function uses the masks of the block to find
+    the run of characters at the current position which the scanner
+    would only capture or ignore: the contents of a string other than
+    a root key, and, outside strings, everything but the structural
+    characters while an element is being captured or while the scanner
+    is below the root object and outside the "vars" array.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        masks
+            the masks of the block built by the structural scanner
+
+    @param[in]
+        pos
+            the current position in the block
+
+    @param[in]
+        len
+            number of characters in the block
+
+    @retval number of characters skipped, which may be 0
+
+==============================================================================*/
+static size_t varstream_fnSkip( VarStream *pStream,
+                                const uint64_t masks[2],
+                                size_t pos,
+                                size_t len )
+{
+    uint64_t mask = 0;
+    size_t n = 0;
+    int set = -1;
+
+    if ( pStream->rootClosed == true )
+    {
+        /* ignore anything after the root object, as cJSON_Parse does */
+        n = len - pos;
+    }
+    else if ( pStream->inString == true )
+    {
+        if ( ( pStream->escape == false ) &&
+             ( pStream->inKey == false ) )
+        {
+            set = VARSCAN_STRING;
+        }
+    }
+    else if ( ( pStream->capturing == true ) ||
+              ( ( pStream->depth > 1 ) &&
+                ( pStream->depth != pStream->varsDepth ) ) )
+    {
+        set = VARSCAN_STRUCTURE;
+    }
+
+    if ( set != -1 )
+    {
+        mask = masks[set] >> pos;
+        n = ( mask == 0 ) ? len - pos : (size_t)__builtin_ctzll( mask );
+    }
+
+    return n;
+}
+
+/*============================================================================*/
+/*  varstream_fnProcessChar                                                   */
+/*!
+    Process a single character of the varcreate JSON document
+
+    The varstream_fnProcessChar function advances the scanner state
+    by one character.  The characters of an element of the "vars"
+    array are captured from the piece of the document being scanned
+    when the element ends, or when the piece ends.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        p
+            pointer to the character to process
+
+==============================================================================*/
+static void varstream_fnProcessChar( VarStream *pStream, const char *p )
+{
+    char c = *p;
+
+    if ( pStream->rootClosed == true )
+    {
+        /* ignore anything after the root object, as cJSON_Parse does */
+        return;
+    }
+
+    if ( pStream->inString == true )
+    {
+        if ( pStream->escape == true )
+        {
+            pStream->escape = false;
+        }
+        else if ( c == '\\' )
+        {
+            pStream->escape = true;
+
+            /* escaped keys are never "vars" */
+            pStream->keylen = sizeof( pStream->key ) + 1;
+        }
+        else if ( c == '"' )
+        {
+            pStream->inString = false;
+            pStream->inKey = false;
+        }
+        else if ( pStream->inKey == true )
+        {
+            if ( pStream->keylen < sizeof( pStream->key ) )
+            {
+                pStream->key[pStream->keylen] = c;
+            }
+
+            pStream->keylen++;
+        }
+
+        return;
+    }
+
+    switch( c )
+    {
+        case ' ':
+        case '\t':
+        case '\r':
+        case '\n':
+            break;
+
+        case '"':
+            pStream->inString = true;
+            if ( ( pStream->depth == 1 ) &&
+                 ( pStream->rootIsObject == true ) &&
+                 ( pStream->expectKey == true ) )
+            {
+                pStream->inKey = true;
+                pStream->keylen = 0;
+            }
+            else
+            {
+                varstream_fnValue( pStream, p );
+            }
+            break;
+
+        case '{':
+        case '[':
+            varstream_fnValue( pStream, p );
+            pStream->depth++;
+            if ( ( pStream->depth == 1 ) && ( c == '{' ) )
+            {
+                pStream->rootIsObject = true;
+                pStream->expectKey = true;
+            }
+            break;
+
+        case '}':
+        case ']':
+            if ( ( pStream->capturing == true ) &&
+                 ( pStream->container == false ) &&
+                 ( pStream->depth == pStream->varsDepth ) )
+            {
+                /* a scalar element is terminated by the end of the array */
+                varstream_fnEmit( pStream, p );
+            }
+
+            pStream->depth--;
+
+            if ( ( pStream->capturing == true ) &&
+                 ( pStream->depth == pStream->varsDepth ) )
+            {
+                /* the element is complete */
+                varstream_fnEmit( pStream, p + 1 );
+            }
+            else if ( ( pStream->capturing == true ) &&
+                      ( pStream->defaults == true ) &&
+                      ( pStream->depth == 1 ) )
+            {
+                /* the "defaults" object is complete */
+                varstream_fnEmit( pStream, p + 1 );
+            }
+
+            if ( pStream->depth < pStream->varsDepth )
+            {
+                /* the end of the "vars" array */
+                pStream->varsDepth = 0;
+            }
+
+            if ( pStream->depth <= 0 )
+            {
+                if ( pStream->depth < 0 )
+                {
+                    pStream->result = EBADMSG;
+                    pStream->depth = 0;
+                }
+
+                pStream->rootClosed = true;
+            }
+            break;
+
+        case ':':
+            if ( pStream->depth == 1 )
+            {
+                pStream->expectKey = false;
+                pStream->varsPending = ( pStream->varsFound == false ) &&
+                                       ( pStream->keylen == 4 ) &&
+                                       ( memcmp( pStream->key,
+                                                 "vars",
+                                                 4 ) == 0 );
+                pStream->defaultsPending = ( pStream->varsFound == false ) &&
+                                           ( pStream->defaultsFn != NULL ) &&
+                                           ( pStream->keylen == 8 ) &&
+                                           ( memcmp( pStream->key,
+                                                     "defaults",
+                                                     8 ) == 0 );
+            }
+            break;
+
+        case ',':
+            if ( pStream->depth == 1 )
+            {
+                pStream->expectKey = pStream->rootIsObject;
+            }
+
+            if ( ( pStream->capturing == true ) &&
+                 ( pStream->container == false ) &&
+                 ( pStream->depth == pStream->varsDepth ) )
+            {
+                /* a scalar element is terminated by the separator */
+                varstream_fnEmit( pStream, p );
+            }
+            break;
+
+        default:
+            varstream_fnValue( pStream, p );
+            break;
+    }
+}
+
+/*============================================================================*/
+/*  varstream_fnValue                                                         */
+/*!
+    Handle a character which may start a JSON value
+
+    The varstream_fnValue function locates the value of the "vars"
+    key in the root object, and starts capturing each element of
+    the "vars" array.  It also starts capturing the value of the
+    "defaults" key in the root object.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        p
+            pointer to the character which may start a value
+
+==============================================================================*/
+static void varstream_fnValue( VarStream *pStream, const char *p )
+{
+    char c = *p;
+
+    if ( ( pStream->depth == 1 ) &&
+         ( pStream->varsPending == true ) )
+    {
+        pStream->varsPending = false;
+
+        if ( c == '[' )
+        {
+            /* the elements of the "vars" array are one level deeper */
+            pStream->varsDepth = 2;
+            pStream->varsFound = true;
+        }
+    }
+    else if ( ( pStream->depth == 1 ) &&
+              ( pStream->defaultsPending == true ) )
+    {
+        pStream->defaultsPending = false;
+
+        if ( c == '{' )
+        {
+            /* capture the whole "defaults" object */
+            pStream->capturing = true;
+            pStream->container = true;
+            pStream->defaults = true;
+            pStream->overflow = false;
+            pStream->len = 0;
+            pStream->pending = p;
+        }
+    }
+    else if ( ( pStream->varsDepth > 0 ) &&
+              ( pStream->depth == pStream->varsDepth ) &&
+              ( pStream->capturing == false ) )
+    {
+        /* start capturing a new element */
+        pStream->capturing = true;
+        pStream->container = ( c == '{' ) || ( c == '[' );
+        pStream->overflow = false;
+        pStream->len = 0;
+        pStream->pending = p;
+    }
+}
+
+/*============================================================================*/
+/*  varstream_fnAppend                                                        */
+/*!
+    Append characters to the element being captured
+
+    The varstream_fnAppend function grows the capture buffer as
+    required, up to VARSTREAM_MAX_ELEMENT_SIZE.  Larger elements
+    are discarded and reported when they are complete.
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        data
+            pointer to the characters to append
+
+    @param[in]
+        len
+            number of characters to append
+
+==============================================================================*/
+static void varstream_fnAppend( VarStream *pStream,
+                                const char *data,
+                                size_t len )
+{
+    size_t size;
+    char *p;
+
+    if ( pStream->overflow == true )
+    {
+        return;
+    }
+
+    /* leave room for the NUL terminator */
+    if ( pStream->len + len >= pStream->size )
+    {
+        size = ( pStream->size == 0 ) ? VARSTREAM_INITIAL_BUFFER_SIZE
+                                      : pStream->size * 2;
+        while ( pStream->len + len >= size )
+        {
+            size *= 2;
+        }
+
+        if ( size > VARSTREAM_MAX_ELEMENT_SIZE )
+        {
+            size = VARSTREAM_MAX_ELEMENT_SIZE;
+        }
+
+        if ( pStream->len + len >= size )
+        {
+            /* the element is too large */
+            pStream->overflow = true;
+            return;
+        }
+
+        p = realloc( pStream->buf, size );
+        if ( p == NULL )
+        {
+            pStream->result = ENOMEM;
+            pStream->overflow = true;
+            return;
+        }
+
+        pStream->buf = p;
+        pStream->size = size;
+    }
+
+    memcpy( &pStream->buf[pStream->len], data, len );
+    pStream->len += len;
+}
+
+/*============================================================================*/
+/*  varstream_fnEmit                                                          */
+/*!
+    Pass a completed element to the element callback
+
+    @param[in]
+        pStream
+            pointer to the VarStream object
+
+    @param[in]
+        end
+            pointer to the character after the last character of the
+            element in the piece of the document being scanned
+
+==============================================================================*/
+static void varstream_fnEmit( VarStream *pStream, const char *end )
+{
+    const char *text;
+    int rc;
+
+    varstream_fnAppend( pStream,
+                        pStream->pending,
+                        (size_t)( end - pStream->pending ) );
+
+    if ( ( pStream->overflow == false ) ||
+         ( pStream->result != ENOMEM ) )
+    {
+        /* an element which is too large is passed as NULL, so the
+           callback can report it */
+        text = NULL;
+        if ( pStream->overflow == false )
+        {
+            pStream->buf[pStream->len] = 0;
+            text = pStream->buf;
+        }
+
+        if ( pStream->defaults == true )
+        {
+            rc = pStream->defaultsFn( pStream->arg, text, pStream->len );
+        }
+        else
+        {
+            rc = pStream->fn( pStream->arg, text, pStream->len );
+        }
+
+        if ( rc != EOK )
+        {
+            pStream->result = rc;
+        }
+    }
+
+    pStream->capturing = false;
+    pStream->container = false;
+    pStream->defaults = false;
+    pStream->overflow = false;
+    pStream->pending = NULL;
+    pStream->len = 0;
+}
+
+/*! @}
+ * end of libvarcreate group */
@@ -0,0 +1,167 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARSTREAM_H
+#define VARSTREAM_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "varscan.h"
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! specifies the maximum size of a single variable definition
+    which can be extracted from a stream */
+#define VARSTREAM_MAX_ELEMENT_SIZE          ( 64 * 1024 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! callback invoked with the JSON text of each element extracted from
+    the stream.  The text is NUL terminated and is only valid for the
+    duration of the callback.  The text of an element which exceeds
+    VARSTREAM_MAX_ELEMENT_SIZE is NULL, and the callback returns the
+    error to record for it */
+typedef int (*VarStreamFn)( void *arg, const char *element, size_t len );
+
+/*! The VarStream object tracks the state of an incremental scan of a
+    varcreate JSON document.  The document is fed to the scanner in
+    arbitrarily sized pieces, and each element of the top level "vars"
+    array is passed to the callback as soon as it is complete, so only
+    one variable definition is held in memory at a time.  A top level
+    "defaults" object which precedes the "vars" array is passed to a
+    second callback in the same way */
+typedef struct _VarStream
+{
+    /*! callback to invoke for each element */
+    VarStreamFn fn;
+
+    /*! callback to invoke with the "defaults" object, or NULL to
+        skip it */
+    VarStreamFn defaultsFn;
+
+    /*! argument to pass to the callback */
+    void *arg;
+
+    /*! vector structural scanner used to skip the characters which
+        cannot change the state of the scan, or NULL to process each
+        character in turn */
+    VarScanFn scan;
+
+    /*! current container nesting depth */
+    int depth;
+
+    /*! depth of the elements of the "vars" array, or 0 if the scanner
+        is not inside the "vars" array */
+    int varsDepth;
+
+    /*! the root of the document is an object */
+    bool rootIsObject;
+
+    /*! the root of the document has been closed */
+    bool rootClosed;
+
+    /*! the "vars" array has been found */
+    bool varsFound;
+
+    /*! the last key seen in the root object was "vars" and its value
+        has not been seen yet */
+    bool varsPending;
+
+    /*! the last key seen in the root object was "defaults" and its
+        value has not been seen yet */
+    bool defaultsPending;
+
+    /*! the next string in the root object is a key */
+    bool expectKey;
+
+    /*! the current string is a key in the root object */
+    bool inKey;
+
+    /*! the scanner is inside a string */
+    bool inString;
+
+    /*! the previous character was an escape character */
+    bool escape;
+
+    /*! the current key in the root object */
+    char key[8];
+
+    /*! length of the current key, which may exceed sizeof(key) */
+    size_t keylen;
+
+    /*! an element is being captured */
+    bool capturing;
+
+    /*! the element being captured is an object or array */
+    bool container;
+
+    /*! the element being captured is the "defaults" object */
+    bool defaults;
+
+    /*! the element being captured is too large */
+    bool overflow;
+
+    /*! start of the characters of the element being captured which
+        are in the piece of the document being scanned and have not
+        been copied to the capture buffer yet */
+    const char *pending;
+
+    /*! buffer holding the element being captured */
+    char *buf;
+
+    /*! number of bytes in the capture buffer */
+    size_t len;
+
+    /*! size of the capture buffer */
+    size_t size;
+
+    /*! aggregated result of the scan and the element callbacks */
+    int result;
+
+} VarStream;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+int varstream_Init( VarStream *pStream,
+                    VarStreamFn fn,
+                    VarStreamFn defaultsFn,
+                    void *arg );
+
+int varstream_Feed( VarStream *pStream, const char *data, size_t len );
+
+int varstream_Finish( VarStream *pStream );
+
+void varstream_Free( VarStream *pStream );
+
+#endif
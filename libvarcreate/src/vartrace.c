@@ -0,0 +1,242 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file vartrace.c
+
+    Variable Creation Chrome trace
+
+    When the library is built with VARCREATE_TRACE, every probe also
+    writes an event to the file named by the VARCREATE_TRACE_FILE
+    environment variable, in the Chrome trace event format which
+    chrome://tracing and Perfetto display as a timeline of the files,
+    variables and variable server requests of each thread.
+
+    The file is created when the outermost load begins and completed
+    when it ends, so it always holds the trace of the most recent load.
+    Probes outside of a load are not written.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include "varprobe.h"
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! name of the environment variable holding the trace file name */
+#define VARTRACE_ENV            "VARCREATE_TRACE_FILE"
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! serializes the events of the threads of the library */
+static pthread_mutex_t vartrace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*! trace file of the current load, or NULL */
+static FILE *vartrace_fp;
+
+/*! number of loads in progress */
+static size_t vartrace_depth;
+
+/*! no event has been written to the trace file yet */
+static bool vartrace_first;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static void vartrace_fnLabel( FILE *fp, const char *label );
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  vartrace_Event                                                            */
+/*!
+    Write a trace event
+
+    The vartrace_Event function writes a begin or end event for a probe
+    to the trace file.  The begin event of the outermost load creates
+    the trace file, and its end event completes it.
+
+    @param[in]
+        phase
+            'B' for the start of a step or 'E' for its end
+
+    @param[in]
+        probe
+            name of the probe
+
+    @param[in]
+        label
+            file or variable name, or NULL
+
+    @param[in]
+        arg
+            argument of the probe, which is the result of an end event
+
+==============================================================================*/
+void vartrace_Event( char phase,
+                     const char *probe,
+                     const char *label,
+                     long arg )
+{
+    struct timespec ts;
+    const char *filename;
+    bool load;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    load = ( strcmp( probe, "load" ) == 0 );
+
+    pthread_mutex_lock( &vartrace_lock );
+
+    if ( ( load == true ) &&
+         ( phase == 'B' ) &&
+         ( vartrace_depth++ == 0 ) )
+    {
+        filename = getenv( VARTRACE_ENV );
+        if ( filename != NULL )
+        {
+            vartrace_fp = fopen( filename, "w" );
+            if ( vartrace_fp != NULL )
+            {
+                fputs( "{\"traceEvents\":[\n", vartrace_fp );
+                vartrace_first = true;
+            }
+        }
+    }
+
+    if ( vartrace_fp != NULL )
+    {
+        fprintf( vartrace_fp,
+                 "%s{\"name\":\"%s\",\"cat\":\"varcreate\",\"ph\":\"%c\","
+                 "\"ts\":%.3f,\"pid\":%ld,\"tid\":%ld,\"args\":{",
+                 vartrace_first ? "" : ",\n",
+                 probe,
+                 phase,
+                 ts.tv_sec * 1e6 + ts.tv_nsec / 1e3,
+                 (long)getpid(),
+                 (long)syscall( SYS_gettid ) );
+
+        if ( phase == 'B' )
+        {
+            fputs( "\"label\":", vartrace_fp );
+            vartrace_fnLabel( vartrace_fp, label );
+            fprintf( vartrace_fp, ",\"arg\":%ld}}", arg );
+        }
+        else
+        {
+            fprintf( vartrace_fp, "\"result\":%ld}}", arg );
+        }
+
+        vartrace_first = false;
+    }
+
+    if ( ( load == true ) &&
+         ( phase == 'E' ) &&
+         ( vartrace_depth > 0 ) &&
+         ( --vartrace_depth == 0 ) &&
+         ( vartrace_fp != NULL ) )
+    {
+        fputs( "\n]}\n", vartrace_fp );
+        fclose( vartrace_fp );
+        vartrace_fp = NULL;
+    }
+
+    pthread_mutex_unlock( &vartrace_lock );
+}
+
+/*============================================================================*/
+/*  vartrace_fnLabel                                                          */
+/*!
+    Write a label as a JSON string
+
+    @param[in]
+        fp
+            trace file
+
+    @param[in]
+        label
+            NUL terminated label, or NULL to write null
+
+==============================================================================*/
+static void vartrace_fnLabel( FILE *fp, const char *label )
+{
+    const unsigned char *p = (const unsigned char *)label;
+
+    if ( p == NULL )
+    {
+        fputs( "null", fp );
+    }
+    else
+    {
+        fputc( '"', fp );
+
+        while ( *p != '\0' )
+        {
+            if ( ( *p == '"' ) || ( *p == '\\' ) )
+            {
+                fputc( '\\', fp );
+                fputc( *p, fp );
+            }
+            else if ( *p < 0x20 )
+            {
+                fprintf( fp, "\\u%04x", *p );
+            }
+            else
+            {
+                fputc( *p, fp );
+            }
+
+            p++;
+        }
+
+        fputc( '"', fp );
+    }
+}
+
+/*! @}
+ * end of libvarcreate group */
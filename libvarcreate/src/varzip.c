@@ -0,0 +1,521 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup libvarcreate
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varzip.c
+
+    Variable Creation compressed config files
+
+    Config files ending in .json.gz or .json.zst are decompressed as
+    they are read, a block at a time, and the uncompressed document is
+    passed to the incremental scanner, so only the compressed file is
+    read from storage and the whole document is never held in memory.
+
+    gzip support is built when zlib is available, and zstd support when
+    libzstd is available.  Otherwise a compressed file cannot be opened.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <varcreate/libvarcreate.h>
+#include "varzip.h"
+
+#if defined( VARCREATE_GZIP )
+#include <zlib.h>
+#endif
+
+#if defined( VARCREATE_ZSTD )
+#include <zstd.h>
+#endif
+
+/*==============================================================================
+        Private definitions
+==============================================================================*/
+
+/*! number of compressed bytes read from the file at a time */
+#define VARZIP_BLOCK_SIZE       ( 16 * 1024 )
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static bool varzip_fnHasSuffix( const char *filename, const char *suffix );
+
+static int varzip_fnFill( VarZip *pZip );
+
+#if defined( VARCREATE_GZIP )
+static ssize_t varzip_fnInflate( VarZip *pZip, char *buf, size_t len );
+#endif
+
+#if defined( VARCREATE_ZSTD )
+static ssize_t varzip_fnZstd( VarZip *pZip, char *buf, size_t len );
+#endif
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  varzip_Format                                                             */
+/*!
+    Determine the compression of a config file from its name
+
+    @param[in]
+        filename
+            name of the config file
+
+    @retval VARZIP_GZIP - the file name ends in .json.gz
+    @retval VARZIP_ZSTD - the file name ends in .json.zst
+    @retval VARZIP_NONE - the file is not compressed
+
+==============================================================================*/
+VarZipFormat varzip_Format( const char *filename )
+{
+    VarZipFormat format = VARZIP_NONE;
+
+    if ( filename != NULL )
+    {
+        if ( varzip_fnHasSuffix( filename, VARZIP_GZIP_SUFFIX ) )
+        {
+            format = VARZIP_GZIP;
+        }
+        else if ( varzip_fnHasSuffix( filename, VARZIP_ZSTD_SUFFIX ) )
+        {
+            format = VARZIP_ZSTD;
+        }
+    }
+
+    return format;
+}
+
+/*============================================================================*/
+/*  varzip_Open                                                               */
+/*!
+    Prepare to read a config file through its decompressor
+
+    @param[in]
+        pZip
+            pointer to the VarZip object to initialize
+
+    @param[in]
+        fd
+            descriptor of the config file, which remains owned by the
+            caller
+
+    @param[in]
+        format
+            compression of the config file
+
+    @retval EOK - the reader is ready
+    @retval EINVAL - invalid arguments
+    @retval ENOMEM - memory allocation problem
+    @retval ENOTSUP - the library was built without the decompressor
+
+==============================================================================*/
+int varzip_Open( VarZip *pZip, int fd, VarZipFormat format )
+{
+    int result = EINVAL;
+
+    if ( ( pZip != NULL ) &&
+         ( fd >= 0 ) )
+    {
+        memset( pZip, 0, sizeof( VarZip ) );
+        pZip->fd = fd;
+        pZip->format = format;
+        result = EOK;
+
+        if ( format != VARZIP_NONE )
+        {
+            pZip->in = malloc( VARZIP_BLOCK_SIZE );
+            result = ( pZip->in != NULL ) ? ENOTSUP : ENOMEM;
+        }
+
+#if defined( VARCREATE_GZIP )
+        if ( ( format == VARZIP_GZIP ) &&
+             ( result == ENOTSUP ) )
+        {
+            result = ENOMEM;
+            pZip->state = calloc( 1, sizeof( z_stream ) );
+            if ( pZip->state != NULL )
+            {
+                /* accept gzip and zlib headers */
+                if ( inflateInit2( (z_stream *)pZip->state,
+                                   MAX_WBITS + 32 ) == Z_OK )
+                {
+                    result = EOK;
+                }
+                else
+                {
+                    free( pZip->state );
+                    pZip->state = NULL;
+                }
+            }
+        }
+#endif
+
+#if defined( VARCREATE_ZSTD )
+        if ( ( format == VARZIP_ZSTD ) &&
+             ( result == ENOTSUP ) )
+        {
+            result = ENOMEM;
+            pZip->state = ZSTD_createDStream();
+            if ( pZip->state != NULL )
+            {
+                (void)ZSTD_initDStream( (ZSTD_DStream *)pZip->state );
+                result = EOK;
+            }
+        }
+#endif
+
+        if ( result != EOK )
+        {
+            free( pZip->in );
+            pZip->in = NULL;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  varzip_Read                                                               */
+/*!
+    Read the uncompressed content of a config file
+
+    The varzip_Read function reads up to len bytes of the uncompressed
+    document, reading and decompressing more of the file as required.
+    A file may hold several compressed frames one after the other.
+
+    @param[in]
+        pZip
+            pointer to the VarZip object
+
+    @param[in]
+        buf
+            buffer to store the uncompressed bytes in
+
+    @param[in]
+        len
+            size of the buffer
+
+    @retval number of bytes stored in the buffer
+    @retval 0 - the end of the document has been reached
+    @retval -1 - the file could not be read, or the compressed data is
+                 corrupt or truncated.  The result member holds EIO or
+                 EBADMSG
+
+==============================================================================*/
+ssize_t varzip_Read( VarZip *pZip, char *buf, size_t len )
+{
+    ssize_t n = -1;
+
+    if ( pZip->format == VARZIP_NONE )
+    {
+        do
+        {
+            n = read( pZip->fd, buf, len );
+        } while ( ( n == -1 ) && ( errno == EINTR ) );
+
+        if ( n == -1 )
+        {
+            pZip->result = EIO;
+        }
+    }
+    else
+    {
+        do
+        {
+            if ( ( pZip->pos == pZip->len ) &&
+                 ( pZip->eof == false ) &&
+                 ( varzip_fnFill( pZip ) != EOK ) )
+            {
+                n = -1;
+            }
+            else if ( pZip->pos == pZip->len )
+            {
+                /* a truncated file ends inside a frame */
+                n = ( pZip->ended == true ) ? 0 : -1;
+                pZip->result = ( n == 0 ) ? EOK : EBADMSG;
+            }
+#if defined( VARCREATE_GZIP )
+            else if ( pZip->format == VARZIP_GZIP )
+            {
+                n = varzip_fnInflate( pZip, buf, len );
+            }
+#endif
+#if defined( VARCREATE_ZSTD )
+            else if ( pZip->format == VARZIP_ZSTD )
+            {
+                n = varzip_fnZstd( pZip, buf, len );
+            }
+#endif
+            else
+            {
+                pZip->result = ENOTSUP;
+                n = -1;
+            }
+
+            /* decompressing a header produces no output */
+        } while ( ( n == 0 ) &&
+                  ( ( pZip->pos < pZip->len ) ||
+                    ( pZip->eof == false ) ) );
+    }
+
+    return n;
+}
+
+/*============================================================================*/
+/*  varzip_Close                                                              */
+/*!
+    Release the decompressor of a config file
+
+    The descriptor of the config file is not closed.
+
+    @param[in]
+        pZip
+            pointer to the VarZip object
+
+==============================================================================*/
+void varzip_Close( VarZip *pZip )
+{
+    if ( pZip != NULL )
+    {
+#if defined( VARCREATE_GZIP )
+        if ( ( pZip->format == VARZIP_GZIP ) &&
+             ( pZip->state != NULL ) )
+        {
+            (void)inflateEnd( (z_stream *)pZip->state );
+            free( pZip->state );
+        }
+#endif
+
+#if defined( VARCREATE_ZSTD )
+        if ( ( pZip->format == VARZIP_ZSTD ) &&
+             ( pZip->state != NULL ) )
+        {
+            (void)ZSTD_freeDStream( (ZSTD_DStream *)pZip->state );
+        }
+#endif
+
+        free( pZip->in );
+        pZip->in = NULL;
+        pZip->state = NULL;
+    }
+}
+
+/*============================================================================*/
+/*  varzip_fnHasSuffix                                                        */
+/*!
+    Determine whether a file name ends in a suffix
+
+    @param[in]
+        filename
+            name of the file
+
+    @param[in]
+        suffix
+            suffix to look for
+
+    @retval true - the file name ends in the suffix
+    @retval false - the file name does not end in the suffix
+
+==============================================================================*/
+static bool varzip_fnHasSuffix( const char *filename, const char *suffix )
+{
+    size_t len = strlen( filename );
+    size_t n = strlen( suffix );
+
+    return ( len > n ) &&
+           ( strcmp( &filename[len - n], suffix ) == 0 );
+}
+
+/*============================================================================*/
+/*  varzip_fnFill                                                             */
+/*!
+    Read the next block of compressed data from the file
+
+    @param[in]
+        pZip
+            pointer to the VarZip object
+
+    @retval EOK - the block was read, or the end of the file was reached
+    @retval EIO - the file could not be read
+
+==============================================================================*/
+static int varzip_fnFill( VarZip *pZip )
+{
+    int result = EOK;
+    ssize_t n;
+
+    do
+    {
+        n = read( pZip->fd, pZip->in, VARZIP_BLOCK_SIZE );
+    } while ( ( n == -1 ) && ( errno == EINTR ) );
+
+    pZip->pos = 0;
+    pZip->len = 0;
+
+    if ( n > 0 )
+    {
+        pZip->len = (size_t)n;
+        pZip->bytes += (size_t)n;
+    }
+    else if ( n == 0 )
+    {
+        pZip->eof = true;
+    }
+    else
+    {
+        result = EIO;
+        pZip->result = result;
+    }
+
+    return result;
+}
+
+#if defined( VARCREATE_GZIP )
+/*============================================================================*/
+/*  varzip_fnInflate                                                          */
+/*!
+    Decompress gzip data from the input buffer
+
+    @param[in]
+        pZip
+            pointer to the VarZip object, whose input buffer is not empty
+
+    @param[in]
+        buf
+            buffer to store the uncompressed bytes in
+
+    @param[in]
+        len
+            size of the buffer
+
+    @retval number of bytes stored in the buffer, which may be 0
+    @retval -1 - the compressed data is corrupt
+
+==============================================================================*/
+static ssize_t varzip_fnInflate( VarZip *pZip, char *buf, size_t len )
+{
+    z_stream *strm = (z_stream *)pZip->state;
+    ssize_t n = -1;
+    int rc;
+
+    if ( pZip->ended == true )
+    {
+        /* another gzip member follows the one which has ended */
+        (void)inflateReset( strm );
+        pZip->ended = false;
+    }
+
+    strm->next_in = (Bytef *)&pZip->in[pZip->pos];
+    strm->avail_in = (uInt)( pZip->len - pZip->pos );
+    strm->next_out = (Bytef *)buf;
+    strm->avail_out = (uInt)len;
+
+    rc = inflate( strm, Z_NO_FLUSH );
+
+    pZip->pos = pZip->len - strm->avail_in;
+
+    if ( ( rc == Z_OK ) ||
+         ( rc == Z_STREAM_END ) ||
+         ( rc == Z_BUF_ERROR ) )
+    {
+        pZip->ended = ( rc == Z_STREAM_END );
+        n = (ssize_t)( len - strm->avail_out );
+    }
+    else
+    {
+        pZip->result = ( rc == Z_MEM_ERROR ) ? ENOMEM : EBADMSG;
+    }
+
+    return n;
+}
+#endif
+
+#if defined( VARCREATE_ZSTD )
+/*============================================================================*/
+/*  varzip_fnZstd                                                             */
+/*!
+    Decompress zstd data from the input buffer
+
+    @param[in]
+        pZip
+            pointer to the VarZip object, whose input buffer is not empty
+
+    @param[in]
+        buf
+            buffer to store the uncompressed bytes in
+
+    @param[in]
+        len
+            size of the buffer
+
+    @retval number of bytes stored in the buffer, which may be 0
+    @retval -1 - the compressed data is corrupt
+
+==============================================================================*/
+static ssize_t varzip_fnZstd( VarZip *pZip, char *buf, size_t len )
+{
+    ZSTD_inBuffer in = { pZip->in, pZip->len, pZip->pos };
+    ZSTD_outBuffer out = { buf, len, 0 };
+    ssize_t n = -1;
+    size_t rc;
+
+    rc = ZSTD_decompressStream( (ZSTD_DStream *)pZip->state, &out, &in );
+
+    pZip->pos = in.pos;
+
+    if ( ZSTD_isError( rc ) )
+    {
+        pZip->result = EBADMSG;
+    }
+    else
+    {
+        /* a complete frame leaves nothing to flush */
+        pZip->ended = ( rc == 0 );
+        n = (ssize_t)out.pos;
+    }
+
+    return n;
+}
+#endif
+
+/*! @}
+ * end of libvarcreate group */
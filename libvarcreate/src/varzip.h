@@ -0,0 +1,113 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARZIP_H
+#define VARZIP_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! suffix of gzip compressed config files */
+#define VARZIP_GZIP_SUFFIX      ".json.gz"
+
+/*! suffix of zstd compressed config files */
+#define VARZIP_ZSTD_SUFFIX      ".json.zst"
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! compression of a config file */
+typedef enum _VarZipFormat
+{
+    /*! the file is not compressed */
+    VARZIP_NONE = 0,
+
+    /*! the file is compressed with gzip */
+    VARZIP_GZIP,
+
+    /*! the file is compressed with zstd */
+    VARZIP_ZSTD
+
+} VarZipFormat;
+
+/*! The VarZip object reads a config file through its decompressor, so
+    the uncompressed document is produced a block at a time and never
+    held in memory whole */
+typedef struct _VarZip
+{
+    /*! descriptor of the config file */
+    int fd;
+
+    /*! compression of the config file */
+    VarZipFormat format;
+
+    /*! decompressor state, or NULL if the file is not compressed */
+    void *state;
+
+    /*! buffer holding the compressed data read from the file */
+    char *in;
+
+    /*! offset of the first compressed byte not yet decompressed */
+    size_t pos;
+
+    /*! number of compressed bytes in the buffer */
+    size_t len;
+
+    /*! the end of the file has been read */
+    bool eof;
+
+    /*! the last compressed frame is complete */
+    bool ended;
+
+    /*! number of compressed bytes read from the file */
+    size_t bytes;
+
+    /*! error number describing why varzip_Read failed */
+    int result;
+
+} VarZip;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+VarZipFormat varzip_Format( const char *filename );
+
+int varzip_Open( VarZip *pZip, int fd, VarZipFormat format );
+
+ssize_t varzip_Read( VarZip *pZip, char *buf, size_t len );
+
+void varzip_Close( VarZip *pZip );
+
+#endif
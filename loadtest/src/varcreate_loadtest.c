@@ -0,0 +1,1041 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @defgroup varcreate_loadtest varcreate_loadtest
+ * @brief Load test of variable creation against a live variable server
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varcreate_loadtest.c
+
+    Variable Creation Load Test
+
+    The varcreate_loadtest utility measures variable creation end to end
+    against a running variable server.  It forks the requested number of
+    client processes, each with its own variable server connection, which
+    generate a configuration of uniquely named variables and then load it
+    at the same moment.  Each variable server request is timed, so the
+    report includes the per-variable create and alias latencies as well
+    as the overall creation rate.
+
+    Variables cannot be deleted from the variable server, so the names of
+    each run include a tag, which defaults to the process identifier of
+    the load test.
+
+    Options include:
+
+    -n : number of variables per client (default 1000)
+
+    -c : number of concurrent clients (default 1)
+
+    -m : load mode: serial, batched, pipelined or parallel (default batched)
+
+    -b : batch size of the batched and pipelined modes (default 64)
+
+    -w : number of files and worker threads of the parallel mode (default 4)
+
+    -a : number of aliases per variable (default 0)
+
+    -s : percentage of string variables (default 0)
+
+    -f : load the specified config file with a per-client name prefix
+         instead of generating a configuration
+
+    -t : tag to include in the generated names (default process id)
+
+    -C : write the results as a line of comma separated values
+
+    -H : write the header of the comma separated values and exit
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varserver_timer.h"
+
+/*==============================================================================
+        Private types
+==============================================================================*/
+
+/*! load modes of the load test */
+typedef enum _Mode
+{
+    /*! create each variable as soon as it is parsed */
+    MODE_SERIAL = 0,
+
+    /*! create the variables in batches */
+    MODE_BATCHED,
+
+    /*! create the batches on a separate thread while parsing */
+    MODE_PIPELINED,
+
+    /*! split the configuration into files loaded by worker threads */
+    MODE_PARALLEL,
+
+    /*! number of load modes */
+    MODE_COUNT
+
+} Mode;
+
+/*! state of the load test */
+typedef struct _State
+{
+    /*! number of variables per client */
+    size_t count;
+
+    /*! number of concurrent clients */
+    size_t clients;
+
+    /*! load mode */
+    Mode mode;
+
+    /*! number of files and worker threads of the parallel mode */
+    size_t workers;
+
+    /*! number of aliases per variable */
+    size_t aliases;
+
+    /*! percentage of string variables */
+    size_t strings;
+
+    /*! name of a config file to load instead of a generated one */
+    char *fixture;
+
+    /*! tag included in the generated names */
+    unsigned long tag;
+
+    /*! write the results as comma separated values */
+    bool csv;
+
+    /*! variable creation options */
+    VarCreateOptions options;
+
+} State;
+
+/*! growable text buffer */
+typedef struct _Buffer
+{
+    /*! pointer to the NUL terminated text */
+    char *data;
+
+    /*! length of the text */
+    size_t len;
+
+    /*! size of the allocated buffer */
+    size_t size;
+
+} Buffer;
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+static int ProcessOptions( int argc, char *argv[], State *pState );
+static int Run( State *pState, TimerStats *pStats, uint64_t *pWall );
+static void Client( State *pState, size_t client, int ready, int start );
+static int Prepare( State *pState,
+                    size_t client,
+                    char *dirname,
+                    char *prefix,
+                    Buffer *pBuffer );
+static int Generate( State *pState,
+                     size_t client,
+                     size_t first,
+                     size_t last,
+                     Buffer *pBuffer );
+static int Append( Buffer *pBuffer, const char *fmt, ... )
+    __attribute__ ((format (printf, 2, 3)));
+static int WriteConfig( char *filename, Buffer *pBuffer );
+static void RemoveFiles( State *pState, char *dirname );
+static void Report( State *pState, TimerStats *pStats, uint64_t wall );
+static uint64_t Now( void );
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! names of the load modes */
+static const char *modes[MODE_COUNT] =
+{
+    "serial",
+    "batched",
+    "pipelined",
+    "parallel"
+};
+
+/*==============================================================================
+        Public function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  main                                                                      */
+/*!
+    Main entry point for the load test
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @retval 0 - every variable and alias was created
+    @retval 1 - the load test failed
+
+==============================================================================*/
+int main( int argc, char **argv )
+{
+    State state;
+    TimerStats *pStats;
+    uint64_t wall = 0;
+    int rc = 1;
+    int result;
+
+    result = ProcessOptions( argc, argv, &state );
+    if ( result == EOK )
+    {
+        /* the statistics are shared by every client process */
+        pStats = mmap( NULL,
+                       sizeof( TimerStats ),
+                       PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_ANONYMOUS,
+                       -1,
+                       0 );
+        if ( pStats != MAP_FAILED )
+        {
+            memset( pStats, 0, sizeof( TimerStats ) );
+
+            result = Run( &state, pStats, &wall );
+            if ( wall > 0 )
+            {
+                Report( &state, pStats, wall );
+            }
+
+            /* the aliases of a fixture are not prefixed, so every
+               client after the first fails to create them */
+            if ( ( result == EOK ) &&
+                 ( pStats->createFailures == 0 ) &&
+                 ( ( pStats->aliasFailures == 0 ) ||
+                   ( state.fixture != NULL ) ) )
+            {
+                rc = 0;
+            }
+
+            munmap( pStats, sizeof( TimerStats ) );
+        }
+    }
+    else if ( result == EALREADY )
+    {
+        rc = 0;
+    }
+
+    return rc;
+}
+
+/*============================================================================*/
+/*  ProcessOptions                                                            */
+/*!
+    Process the command line options for the load test
+
+    @param[in]
+        argc
+            number of arguments on the command line
+            (including the command itself)
+
+    @param[in]
+        argv
+            array of pointers to the command line arguments
+
+    @param[in]
+        pState
+            pointer to the load test state structure to update
+
+    @retval EOK - the options were processed
+    @retval EINVAL - invalid arguments
+    @retval EALREADY - the header was written and there is nothing to run
+
+==============================================================================*/
+static int ProcessOptions( int argc, char *argv[], State *pState )
+{
+    int result = EOK;
+    int mode;
+    int c;
+
+    memset( pState, 0, sizeof( State ) );
+    pState->count = 1000;
+    pState->clients = 1;
+    pState->mode = MODE_BATCHED;
+    pState->workers = 4;
+    pState->options.batchSize = 64;
+    pState->tag = (unsigned long)getpid();
+
+    while( ( c = getopt( argc, argv, "n:c:m:b:w:a:s:f:t:CH" ) ) != -1 )
+    {
+        switch( c )
+        {
+            case 'n':
+                pState->count = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'c':
+                pState->clients = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'm':
+                for ( mode = 0 ; mode < MODE_COUNT ; mode++ )
+                {
+                    if ( strcmp( optarg, modes[mode] ) == 0 )
+                    {
+                        break;
+                    }
+                }
+
+                pState->mode = (Mode)mode;
+                break;
+
+            case 'b':
+                pState->options.batchSize = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'w':
+                pState->workers = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'a':
+                pState->aliases = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 's':
+                pState->strings = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'f':
+                pState->fixture = optarg;
+                break;
+
+            case 't':
+                pState->tag = strtoul( optarg, NULL, 0 );
+                break;
+
+            case 'C':
+                pState->csv = true;
+                break;
+
+            case 'H':
+                printf( "mode,clients,vars,aliases,strings,creates,"
+                        "failures,aliased,alias_failures,wall_ms,"
+                        "creates_per_sec,create_p50_us,create_p99_us,"
+                        "alias_p50_us,alias_p99_us,inflight\n" );
+                result = EALREADY;
+                break;
+
+            default:
+                result = EINVAL;
+                break;
+        }
+    }
+
+    if ( ( result == EOK ) &&
+         ( ( pState->count == 0 ) ||
+           ( pState->clients == 0 ) ||
+           ( pState->mode == MODE_COUNT ) ||
+           ( pState->workers == 0 ) ||
+           ( pState->strings > 100 ) ||
+           ( ( pState->fixture != NULL ) &&
+             ( pState->mode == MODE_PARALLEL ) ) ) )
+    {
+        fprintf( stderr, "varcreate_loadtest: invalid arguments\n" );
+        result = EINVAL;
+    }
+
+    if ( result == EOK )
+    {
+        switch( pState->mode )
+        {
+            case MODE_SERIAL:
+                pState->options.batchSize = 0;
+                break;
+
+            case MODE_PIPELINED:
+                pState->options.pipeline = true;
+                break;
+
+            case MODE_PARALLEL:
+                pState->options.workers = pState->workers;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Run                                                                       */
+/*!
+    Run the clients of the load test
+
+    Each client is forked and prepares its configuration, then reports
+    that it is ready and waits.  Once every client is ready the start
+    pipe is closed to release them together, and the wall time runs
+    until the last client has exited.
+
+    @param[in]
+        pState
+            pointer to the load test state
+
+    @param[in]
+        pStats
+            pointer to the shared statistics
+
+    @param[out]
+        pWall
+            pointer to a location to store the wall time in nanoseconds
+
+    @retval EOK - every client completed its load
+    @retval EIO - a client could not be run, or its load failed
+
+==============================================================================*/
+static int Run( State *pState, TimerStats *pStats, uint64_t *pWall )
+{
+    int result = EIO;
+    int ready[2] = { -1, -1 };
+    int start[2] = { -1, -1 };
+    size_t started = 0;
+    size_t waiting;
+    uint64_t begin;
+    pid_t pid;
+    char c;
+    int status;
+    size_t i;
+
+    if ( ( pipe( ready ) == 0 ) && ( pipe( start ) == 0 ) )
+    {
+        result = EOK;
+        TIMER_Attach( pStats );
+        fflush( stdout );
+
+        for ( i = 0 ; ( result == EOK ) && ( i < pState->clients ) ; i++ )
+        {
+            pid = fork();
+            if ( pid == 0 )
+            {
+                close( ready[0] );
+                close( start[1] );
+                Client( pState, i, ready[1], start[0] );
+            }
+            else if ( pid > 0 )
+            {
+                started++;
+            }
+            else
+            {
+                fprintf( stderr, "varcreate_loadtest: unable to fork\n" );
+                result = EIO;
+            }
+        }
+
+        close( ready[1] );
+        close( start[0] );
+
+        /* wait until every client has prepared its configuration */
+        for ( waiting = started ; waiting > 0 ; waiting-- )
+        {
+            if ( read( ready[0], &c, 1 ) != 1 )
+            {
+                result = EIO;
+                break;
+            }
+        }
+
+        begin = Now();
+        close( start[1] );
+        close( ready[0] );
+
+        while ( started > 0 )
+        {
+            if ( wait( &status ) > 0 )
+            {
+                if ( ( !WIFEXITED( status ) ) ||
+                     ( WEXITSTATUS( status ) != 0 ) )
+                {
+                    result = EIO;
+                }
+
+                started--;
+            }
+            else if ( errno != EINTR )
+            {
+                result = EIO;
+                break;
+            }
+        }
+
+        *pWall = Now() - begin;
+
+        if ( result != EOK )
+        {
+            fprintf( stderr, "varcreate_loadtest: a client failed\n" );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Client                                                                    */
+/*!
+    Run one client of the load test
+
+    The client opens its own variable server connection and prepares its
+    configuration before reporting that it is ready.  The load starts
+    when the start pipe is closed.  The client exits with 0 if the load
+    succeeded.  The variable server requests of the load are counted
+    in the shared statistics whether or not it succeeded.
+
+    @param[in]
+        pState
+            pointer to the load test state
+
+    @param[in]
+        client
+            index of the client
+
+    @param[in]
+        ready
+            file descriptor to write a byte to once the client is ready
+
+    @param[in]
+        start
+            file descriptor which reaches end of file when the load starts
+
+==============================================================================*/
+static void Client( State *pState, size_t client, int ready, int start )
+{
+    VARSERVER_HANDLE hVarServer;
+    Buffer buffer = { NULL, 0, 0 };
+    char dirname[] = "/tmp/varcreate_loadtest.XXXXXX";
+    char prefix[64];
+    char c = 0;
+    int rc = EIO;
+
+    hVarServer = VARSERVER_Open();
+    if ( hVarServer != NULL )
+    {
+        rc = Prepare( pState, client, dirname, prefix, &buffer );
+    }
+    else
+    {
+        fprintf( stderr, "varcreate_loadtest: no variable server\n" );
+    }
+
+    if ( ( write( ready, &c, 1 ) == 1 ) &&
+         ( read( start, &c, 1 ) == 0 ) &&
+         ( rc == EOK ) )
+    {
+        if ( pState->mode == MODE_PARALLEL )
+        {
+            rc = VARCREATE_CreateFromDirectory( hVarServer,
+                                                dirname,
+                                                &pState->options );
+        }
+        else if ( pState->fixture != NULL )
+        {
+            rc = VARCREATE_CreateFromFile( hVarServer,
+                                           pState->fixture,
+                                           &pState->options );
+        }
+        else
+        {
+            rc = VARCREATE_CreateFromString( hVarServer,
+                                             buffer.data,
+                                             &pState->options );
+        }
+    }
+
+    if ( pState->mode == MODE_PARALLEL )
+    {
+        RemoveFiles( pState, dirname );
+    }
+
+    if ( hVarServer != NULL )
+    {
+        VARSERVER_Close( hVarServer );
+    }
+
+    free( buffer.data );
+
+    _exit( ( rc == EOK ) ? 0 : 1 );
+}
+
+/*============================================================================*/
+/*  Prepare                                                                   */
+/*!
+    Prepare the configuration of a client
+
+    A fixture file is loaded with a prefix which makes its names unique
+    to the client.  Otherwise a configuration is generated, and for the
+    parallel mode it is split across files in a new temporary directory.
+
+    @param[in]
+        pState
+            pointer to the load test state
+
+    @param[in]
+        client
+            index of the client
+
+    @param[in,out]
+        dirname
+            template of the temporary directory of the parallel mode,
+            which is updated with the name of the directory
+
+    @param[in]
+        prefix
+            buffer of 64 bytes for the name prefix of a fixture
+
+    @param[out]
+        pBuffer
+            pointer to the buffer to store the configuration in
+
+    @retval EOK - the configuration was prepared
+    @retval ENOMEM - memory allocation problem
+    @retval EIO - the configuration files could not be written
+
+==============================================================================*/
+static int Prepare( State *pState,
+                    size_t client,
+                    char *dirname,
+                    char *prefix,
+                    Buffer *pBuffer )
+{
+    int result = EOK;
+    char filename[128];
+    size_t first;
+    size_t last;
+    size_t i;
+
+    if ( pState->fixture != NULL )
+    {
+        snprintf( prefix, 64, "/LOADTEST/%lu/C%zu", pState->tag, client );
+        pState->options.prefix = prefix;
+    }
+    else if ( pState->mode == MODE_PARALLEL )
+    {
+        if ( mkdtemp( dirname ) == NULL )
+        {
+            result = EIO;
+        }
+
+        for ( i = 0 ; ( result == EOK ) && ( i < pState->workers ) ; i++ )
+        {
+            first = ( pState->count * i ) / pState->workers;
+            last = ( pState->count * ( i + 1 ) ) / pState->workers;
+            pBuffer->len = 0;
+            snprintf( filename, sizeof filename, "%s/%zu.json", dirname, i );
+
+            result = Generate( pState, client, first, last, pBuffer );
+            if ( result == EOK )
+            {
+                result = WriteConfig( filename, pBuffer );
+            }
+        }
+    }
+    else
+    {
+        result = Generate( pState, client, 0, pState->count, pBuffer );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Generate                                                                  */
+/*!
+    Generate a varcreate JSON configuration for a client
+
+    The variables and aliases are named after the tag of the run and the
+    client, so that every name is new to the variable server.  String
+    variables have a length and an initial string value, and the
+    remaining variables cycle through the numeric types.
+
+    @param[in]
+        pState
+            pointer to the load test state
+
+    @param[in]
+        client
+            index of the client
+
+    @param[in]
+        first
+            index of the first variable to generate
+
+    @param[in]
+        last
+            index after the last variable to generate
+
+    @param[out]
+        pBuffer
+            pointer to the buffer to store the configuration in
+
+    @retval EOK - the configuration was generated
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int Generate( State *pState,
+                     size_t client,
+                     size_t first,
+                     size_t last,
+                     Buffer *pBuffer )
+{
+    static const char *types[] = { "uint16", "int32", "uint64", "float" };
+    int result;
+    size_t i;
+    size_t j;
+
+    result = Append( pBuffer,
+                     "{\n\t\"type\":\"vars\",\n\t\"version\":\"1.0\",\n"
+                     "\t\"description\":\"varcreate_loadtest\",\n"
+                     "\t\"vars\":\n\t[\n" );
+
+    for ( i = first ; ( result == EOK ) && ( i < last ) ; i++ )
+    {
+        result |= Append( pBuffer,
+                          "\t\t{\n\t\t\t\"name\":"
+                          "\"/LOADTEST/%lu/C%zu/V%zu\",\n",
+                          pState->tag,
+                          client,
+                          i );
+
+        if ( ( i % 100 ) < pState->strings )
+        {
+            result |= Append( pBuffer,
+                              "\t\t\t\"type\":\"str\",\n"
+                              "\t\t\t\"length\":\"64\",\n"
+                              "\t\t\t\"value\":\"value of variable %zu\",\n",
+                              i );
+        }
+        else
+        {
+            result |= Append( pBuffer,
+                              "\t\t\t\"type\":\"%s\",\n"
+                              "\t\t\t\"value\":\"%zu\",\n",
+                              types[i % 4],
+                              i % 1000 );
+        }
+
+        result |= Append( pBuffer, "\t\t\t\"flags\":\"volatile\"" );
+
+        if ( pState->aliases > 0 )
+        {
+            result |= Append( pBuffer, ",\n\t\t\t\"alias\":[" );
+            for ( j = 0 ; j < pState->aliases ; j++ )
+            {
+                result |= Append( pBuffer,
+                                  "%s\"lt.%lu.c%zu.v%zu.%zu\"",
+                                  j ? "," : "",
+                                  pState->tag,
+                                  client,
+                                  i,
+                                  j );
+            }
+
+            result |= Append( pBuffer, "]" );
+        }
+
+        result |= Append( pBuffer,
+                          "\n\t\t}%s\n",
+                          ( i + 1 < last ) ? "," : "" );
+    }
+
+    result |= Append( pBuffer, "\t]\n}\n" );
+
+    return ( result == EOK ) ? EOK : ENOMEM;
+}
+
+/*============================================================================*/
+/*  Append                                                                    */
+/*!
+    Append formatted text to a buffer
+
+    @param[in]
+        pBuffer
+            pointer to the buffer
+
+    @param[in]
+        fmt
+            printf style format string
+
+    @retval EOK - the text was appended
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int Append( Buffer *pBuffer, const char *fmt, ... )
+{
+    int result = EOK;
+    va_list args;
+    size_t size;
+    char *p;
+    int n;
+
+    va_start( args, fmt );
+    n = vsnprintf( NULL, 0, fmt, args );
+    va_end( args );
+
+    if ( pBuffer->len + n + 1 > pBuffer->size )
+    {
+        size = ( pBuffer->size == 0 ) ? 64 * 1024 : pBuffer->size;
+        while ( size < pBuffer->len + n + 1 )
+        {
+            size *= 2;
+        }
+
+        p = realloc( pBuffer->data, size );
+        if ( p != NULL )
+        {
+            pBuffer->data = p;
+            pBuffer->size = size;
+        }
+        else
+        {
+            result = ENOMEM;
+        }
+    }
+
+    if ( result == EOK )
+    {
+        va_start( args, fmt );
+        vsnprintf( &pBuffer->data[pBuffer->len], n + 1, fmt, args );
+        va_end( args );
+        pBuffer->len += n;
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  WriteConfig                                                               */
+/*!
+    Write a generated configuration to a file
+
+    @param[in]
+        filename
+            name of the file to write
+
+    @param[in]
+        pBuffer
+            pointer to the buffer holding the configuration
+
+    @retval EOK - the file was written
+    @retval EIO - the file could not be written
+
+==============================================================================*/
+static int WriteConfig( char *filename, Buffer *pBuffer )
+{
+    int result = EIO;
+    FILE *fp;
+
+    fp = fopen( filename, "w" );
+    if ( fp != NULL )
+    {
+        if ( fwrite( pBuffer->data, 1, pBuffer->len, fp ) == pBuffer->len )
+        {
+            result = EOK;
+        }
+
+        if ( fclose( fp ) != 0 )
+        {
+            result = EIO;
+        }
+    }
+
+    if ( result != EOK )
+    {
+        fprintf( stderr, "varcreate_loadtest: unable to write %s\n", filename );
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  RemoveFiles                                                               */
+/*!
+    Remove the temporary configuration files of the parallel mode
+
+    @param[in]
+        pState
+            pointer to the load test state
+
+    @param[in]
+        dirname
+            name of the temporary directory
+
+==============================================================================*/
+static void RemoveFiles( State *pState, char *dirname )
+{
+    char filename[128];
+    size_t i;
+
+    for ( i = 0 ; i < pState->workers ; i++ )
+    {
+        snprintf( filename, sizeof filename, "%s/%zu.json", dirname, i );
+        (void)unlink( filename );
+    }
+
+    (void)rmdir( dirname );
+}
+
+/*============================================================================*/
+/*  Report                                                                    */
+/*!
+    Write the results of the load test
+
+    The in-flight figure is the total time spent waiting for the variable
+    server divided by the wall time, which is the average number of
+    requests the server was handling or queueing at once.  It stays near
+    one when the clients are serialized by the server, and grows with
+    the number of clients when they are not.
+
+    @param[in]
+        pState
+            pointer to the load test state
+
+    @param[in]
+        pStats
+            pointer to the shared statistics
+
+    @param[in]
+        wall
+            wall time of the load in nanoseconds
+
+==============================================================================*/
+static void Report( State *pState, TimerStats *pStats, uint64_t wall )
+{
+    double seconds = ( wall > 0 ) ? wall / 1e9 : 1e-9;
+    double rate = pStats->creates / seconds;
+    double inflight = pStats->serverTime / ( seconds * 1e9 );
+    double p50 = TIMER_Percentile( pStats->createHist, 50.0 ) / 1e3;
+    double p99 = TIMER_Percentile( pStats->createHist, 99.0 ) / 1e3;
+    double a50 = TIMER_Percentile( pStats->aliasHist, 50.0 ) / 1e3;
+    double a99 = TIMER_Percentile( pStats->aliasHist, 99.0 ) / 1e3;
+    size_t count = pState->count;
+
+    if ( pState->fixture != NULL )
+    {
+        /* the size of a fixture is whatever the clients attempted */
+        count = ( pStats->creates + pStats->createFailures ) /
+                pState->clients;
+    }
+
+    if ( pState->csv == true )
+    {
+        printf( "%s,%zu,%zu,%zu,%zu,%lu,%lu,%lu,%lu,%.3f,%.0f,"
+                "%.2f,%.2f,%.2f,%.2f,%.2f\n",
+                modes[pState->mode],
+                pState->clients,
+                count,
+                pState->aliases,
+                pState->strings,
+                (unsigned long)pStats->creates,
+                (unsigned long)pStats->createFailures,
+                (unsigned long)pStats->aliases,
+                (unsigned long)pStats->aliasFailures,
+                wall / 1e6,
+                rate,
+                p50,
+                p99,
+                a50,
+                a99,
+                inflight );
+    }
+    else
+    {
+        printf( "varcreate_loadtest: %s, %zu clients, %zu vars/client, "
+                "%zu aliases/var, %zu%% strings\n",
+                modes[pState->mode],
+                pState->clients,
+                count,
+                pState->aliases,
+                pState->strings );
+        printf( "  created           : %lu (%lu failed)\n",
+                (unsigned long)pStats->creates,
+                (unsigned long)pStats->createFailures );
+        printf( "  aliased           : %lu (%lu failed)\n",
+                (unsigned long)pStats->aliases,
+                (unsigned long)pStats->aliasFailures );
+        printf( "  wall time         : %.3f ms\n", wall / 1e6 );
+        printf( "  creation rate     : %.0f vars/sec\n", rate );
+        printf( "  create latency    : p50 %.2f us, p99 %.2f us\n",
+                p50,
+                p99 );
+        printf( "  alias latency     : p50 %.2f us, p99 %.2f us\n",
+                a50,
+                a99 );
+        printf( "  server in-flight  : %.2f\n", inflight );
+    }
+}
+
+/*============================================================================*/
+/*  Now                                                                       */
+/*!
+    Get the monotonic clock time
+
+    @retval the current monotonic time in nanoseconds
+
+==============================================================================*/
+static uint64_t Now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*! @}
+ * end of varcreate_loadtest group */
@@ -0,0 +1,299 @@
+/*==============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+==============================================================================*/
+
+/*!
+ * @addtogroup varcreate_loadtest
+ * @{
+ */
+
+/*============================================================================*/
+/*!
+@file varserver_timer.c
+
+    Variable Server Timer
+
+    The load test is linked with --wrap for the variable server requests
+    which create variables and aliases, so each request is passed on to
+    the running variable server and timed here.  The latency of each
+    request is added to a histogram in a TimerStats object, which is
+    usually in memory shared by every client process of the test.
+
+*/
+/*============================================================================*/
+
+/*==============================================================================
+        Includes
+==============================================================================*/
+
+#include <stdint.h>
+#include <time.h>
+#include <varserver/varserver.h>
+#include <varcreate/libvarcreate.h>
+#include "varserver_timer.h"
+
+/*==============================================================================
+        Private function declarations
+==============================================================================*/
+
+int __real_VARSERVER_CreateVar( VARSERVER_HANDLE hVarServer,
+                                VarInfo *pVarInfo );
+int __real_VAR_Alias( VARSERVER_HANDLE hVarServer,
+                      VAR_HANDLE hVar,
+                      char *alias,
+                      VAR_HANDLE *phAlias );
+
+int __wrap_VARSERVER_CreateVar( VARSERVER_HANDLE hVarServer,
+                                VarInfo *pVarInfo );
+int __wrap_VAR_Alias( VARSERVER_HANDLE hVarServer,
+                      VAR_HANDLE hVar,
+                      char *alias,
+                      VAR_HANDLE *phAlias );
+
+static uint64_t Now( void );
+static size_t Bucket( uint64_t ns );
+static void Record( uint64_t *hist, uint64_t *count, uint64_t ns );
+
+/*==============================================================================
+        Private file scoped variables
+==============================================================================*/
+
+/*! statistics which the requests are recorded in, or NULL */
+static TimerStats *pTimerStats;
+
+/*==============================================================================
+        Function definitions
+==============================================================================*/
+
+/*============================================================================*/
+/*  TIMER_Attach                                                              */
+/*!
+    Select the statistics which the requests are recorded in
+
+    @param[in]
+        pStats
+            pointer to the statistics, or NULL to stop recording
+
+==============================================================================*/
+void TIMER_Attach( TimerStats *pStats )
+{
+    pTimerStats = pStats;
+}
+
+/*============================================================================*/
+/*  TIMER_Percentile                                                          */
+/*!
+    Estimate a percentile of a latency histogram
+
+    @param[in]
+        hist
+            pointer to a histogram of TIMER_BUCKETS buckets
+
+    @param[in]
+        percent
+            percentile to estimate, from 0 to 100
+
+    @retval the estimated latency in nanoseconds
+    @retval 0 if the histogram is empty
+
+==============================================================================*/
+uint64_t TIMER_Percentile( const uint64_t *hist, double percent )
+{
+    uint64_t result = 0;
+    uint64_t total = 0;
+    uint64_t seen = 0;
+    uint64_t rank;
+    uint64_t low;
+    size_t shift;
+    size_t m;
+    size_t i;
+
+    for ( i = 0 ; i < TIMER_BUCKETS ; i++ )
+    {
+        total += hist[i];
+    }
+
+    if ( total > 0 )
+    {
+        /* the rank of the sample at the percentile, counting from 1 */
+        rank = (uint64_t)( ( percent / 100.0 ) * total + 0.5 );
+        rank = ( rank == 0 ) ? 1 : rank;
+
+        for ( i = 0 ; ( seen < rank ) && ( i < TIMER_BUCKETS ) ; i++ )
+        {
+            seen += hist[i];
+        }
+
+        /* report the middle of the bucket holding the sample */
+        i--;
+        if ( i < TIMER_SUB_BUCKETS )
+        {
+            result = i;
+        }
+        else
+        {
+            shift = ( i / TIMER_SUB_BUCKETS ) - 1;
+            m = i % TIMER_SUB_BUCKETS;
+            low = (uint64_t)( TIMER_SUB_BUCKETS + m ) << shift;
+            result = low + ( ( (uint64_t)1 << shift ) / 2 );
+        }
+    }
+
+    return result;
+}
+
+int __wrap_VARSERVER_CreateVar( VARSERVER_HANDLE hVarServer,
+                                VarInfo *pVarInfo )
+{
+    uint64_t start;
+    int result;
+
+    start = Now();
+    result = __real_VARSERVER_CreateVar( hVarServer, pVarInfo );
+
+    if ( pTimerStats != NULL )
+    {
+        if ( result == EOK )
+        {
+            Record( pTimerStats->createHist,
+                    &pTimerStats->creates,
+                    Now() - start );
+        }
+        else
+        {
+            (void)__atomic_add_fetch( &pTimerStats->createFailures,
+                                      1,
+                                      __ATOMIC_RELAXED );
+        }
+    }
+
+    return result;
+}
+
+int __wrap_VAR_Alias( VARSERVER_HANDLE hVarServer,
+                      VAR_HANDLE hVar,
+                      char *alias,
+                      VAR_HANDLE *phAlias )
+{
+    uint64_t start;
+    int result;
+
+    start = Now();
+    result = __real_VAR_Alias( hVarServer, hVar, alias, phAlias );
+
+    if ( pTimerStats != NULL )
+    {
+        if ( result == EOK )
+        {
+            Record( pTimerStats->aliasHist,
+                    &pTimerStats->aliases,
+                    Now() - start );
+        }
+        else
+        {
+            (void)__atomic_add_fetch( &pTimerStats->aliasFailures,
+                                      1,
+                                      __ATOMIC_RELAXED );
+        }
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  Now                                                                       */
+/*!
+    Read the monotonic clock
+
+    @retval the monotonic clock time in nanoseconds
+
+==============================================================================*/
+static uint64_t Now( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*============================================================================*/
+/*  Bucket                                                                    */
+/*!
+    Find the histogram bucket of a latency
+
+    Latencies below TIMER_SUB_BUCKETS nanoseconds have a bucket each.
+    Each larger power of two is split into TIMER_SUB_BUCKETS buckets.
+
+    @param[in]
+        ns
+            latency in nanoseconds
+
+    @retval the index of the bucket
+
+==============================================================================*/
+static size_t Bucket( uint64_t ns )
+{
+    size_t result = (size_t)ns;
+    size_t shift;
+
+    if ( ns >= TIMER_SUB_BUCKETS )
+    {
+        /* the sub-bucket is given by the four bits below the top bit */
+        shift = ( 63 - __builtin_clzll( ns ) ) - 4;
+        result = ( ( shift + 1 ) * TIMER_SUB_BUCKETS ) +
+                 (size_t)( ( ns >> shift ) - TIMER_SUB_BUCKETS );
+    }
+
+    return ( result < TIMER_BUCKETS ) ? result : TIMER_BUCKETS - 1;
+}
+
+/*============================================================================*/
+/*  Record                                                                    */
+/*!
+    Record the latency of a successful request
+
+    @param[in]
+        hist
+            pointer to the histogram of the request
+
+    @param[in]
+        count
+            pointer to the count of the request
+
+    @param[in]
+        ns
+            latency of the request in nanoseconds
+
+==============================================================================*/
+static void Record( uint64_t *hist, uint64_t *count, uint64_t ns )
+{
+    (void)__atomic_add_fetch( &hist[Bucket( ns )], 1, __ATOMIC_RELAXED );
+    (void)__atomic_add_fetch( count, 1, __ATOMIC_RELAXED );
+    (void)__atomic_add_fetch( &pTimerStats->serverTime,
+                              ns,
+                              __ATOMIC_RELAXED );
+}
+
+/*! @}
+ * end of varcreate_loadtest group */
@@ -0,0 +1,84 @@
+/*============================================================================
+MIT License
+
+Copyright (c) 2023 Trevor Monk
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+============================================================================*/
+
+#ifndef VARSERVER_TIMER_H
+#define VARSERVER_TIMER_H
+
+/*============================================================================
+        Includes
+============================================================================*/
+
+#include <stdint.h>
+
+/*============================================================================
+        Defines
+============================================================================*/
+
+/*! number of sub-buckets of each power of two in a latency histogram */
+#define TIMER_SUB_BUCKETS       ( 16 )
+
+/*! number of buckets in a latency histogram, which covers every
+    64 bit nanosecond latency to within one part in TIMER_SUB_BUCKETS */
+#define TIMER_BUCKETS           ( TIMER_SUB_BUCKETS * 61 )
+
+/*============================================================================
+        Public Types
+============================================================================*/
+
+/*! latencies of the variable server requests of a load, which can be
+    shared by the processes and threads of the load */
+typedef struct _TimerStats
+{
+    /*! number of successful VARSERVER_CreateVar calls */
+    uint64_t creates;
+
+    /*! number of failed VARSERVER_CreateVar calls */
+    uint64_t createFailures;
+
+    /*! number of successful VAR_Alias calls */
+    uint64_t aliases;
+
+    /*! number of failed VAR_Alias calls */
+    uint64_t aliasFailures;
+
+    /*! total time spent waiting for the variable server in nanoseconds */
+    uint64_t serverTime;
+
+    /*! histogram of the VARSERVER_CreateVar latencies */
+    uint64_t createHist[TIMER_BUCKETS];
+
+    /*! histogram of the VAR_Alias latencies */
+    uint64_t aliasHist[TIMER_BUCKETS];
+
+} TimerStats;
+
+/*============================================================================
+        Public Function Declarations
+============================================================================*/
+
+void TIMER_Attach( TimerStats *pStats );
+
+uint64_t TIMER_Percentile( const uint64_t *hist, double percent );
+
+#endif
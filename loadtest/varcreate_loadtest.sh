@@ -0,0 +1,52 @@
+#!/bin/sh
+#
+# Scaling sweep of varcreate_loadtest against a running variable server.
+#
+# Every combination of the sizes, client counts, modes and alias and string
+# mixes below is loaded once, then the varcreate test fixtures are loaded
+# by each client count, and the results are written as comma separated
+# values to the standard output.  Each setting can be overridden from the
+# environment, for example:
+#
+#   SIZES="1000" CLIENTS="1 4" loadtest/varcreate_loadtest.sh > results.csv
+#
+# The variable server cannot delete variables, so a full sweep leaves
+# several million variables behind.  Restart the server between sweeps.
+
+LOADTEST=${LOADTEST:-build/bin/varcreate_loadtest}
+FIXTURES=${FIXTURES:-$(dirname "$0")/../varcreate/test}
+SIZES=${SIZES:-"1000 10000 100000"}
+CLIENTS=${CLIENTS:-"1 2 4 8 16"}
+MODES=${MODES:-"serial batched pipelined parallel"}
+MIXES=${MIXES:-"0:0 1:25 4:50"}
+BATCH=${BATCH:-64}
+WORKERS=${WORKERS:-4}
+
+rc=0
+tag=$$
+run=0
+
+"$LOADTEST" -H
+
+for size in $SIZES; do
+    for clients in $CLIENTS; do
+        for mode in $MODES; do
+            for mix in $MIXES; do
+                run=$((run + 1))
+                "$LOADTEST" -C -t "$tag$run" -n "$size" -c "$clients" \
+                    -m "$mode" -b "$BATCH" -w "$WORKERS" \
+                    -a "${mix%%:*}" -s "${mix##*:}" || rc=1
+            done
+        done
+    done
+done
+
+for fixture in "$FIXTURES"/*.json; do
+    [ -f "$fixture" ] || continue
+    for clients in $CLIENTS; do
+        run=$((run + 1))
+        "$LOADTEST" -C -t "$tag$run" -c "$clients" -f "$fixture" || rc=1
+    done
+done
+
+exit $rc
@@ -49,6 +49,7 @@ SOFTWARE.
 ==============================================================================*/
 
 #include <unistd.h>
+#include <getopt.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -58,7 +59,7 @@ SOFTWARE.
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
-#include <dirent.h>
+#include <signal.h>
 #include <varserver/varserver.h>
 #include <varcreate/libvarcreate.h>
 
@@ -66,6 +67,21 @@ SOFTWARE.
         Private definitions
 ==============================================================================*/
 
+/*! suffix identifying compiled snapshot files */
+#define VARCREATE_SNAPSHOT_SUFFIX   ".vcb"
+
+/*! name of the VarCreateTable object written by --embed */
+#define VARCREATE_DEFAULT_SYMBOL    "varcreate_table"
+
+/*! maximum number of instances which can be created by one run */
+#define VARCREATE_MAX_INSTANCES     ( 65536 )
+
+/*! maximum number of failures listed in the summary */
+#define VARCREATE_MAX_REPORTS       ( 10 )
+
+/*! size of each failure listed in the summary */
+#define VARCREATE_REPORT_LEN        ( 256 )
+
 /*==============================================================================
         Private types
 ==============================================================================*/
@@ -82,6 +98,15 @@ typedef struct _State
     /*! instance identifier to apply to the variables in the file */
     uint32_t instanceID;
 
+    /*! instance identifiers to create the variables for, or NULL */
+    uint32_t *instances;
+
+    /*! number of instance identifiers in the instances array */
+    size_t instanceCount;
+
+    /*! instance identifier, range or list specified with -i */
+    char *instanceSpec;
+
     /*! variable name prefix to apply to the variables in the file */
     char *prefix;
 
@@ -91,6 +116,83 @@ typedef struct _State
     /*! name represents a directory name */
     bool directory;
 
+    /*! watch the directory for new config files */
+    bool watch;
+
+    /*! include the files in the subdirectories of the directory */
+    bool recursive;
+
+    /*! number of variables to submit to the variable server per batch */
+    size_t batchSize;
+
+    /*! scan the files incrementally */
+    bool stream;
+
+    /*! map the files into memory */
+    bool mapFile;
+
+    /*! number of worker threads used to load a directory */
+    size_t workers;
+
+    /*! parse and create the variables on separate threads */
+    bool pipeline;
+
+    /*! number of parsed variables which can wait to be created */
+    size_t pipelineDepth;
+
+    /*! name of the state file used to skip unchanged files */
+    char *cache;
+
+    /*! name of the JSON file to compile into a snapshot */
+    char *compile;
+
+    /*! name of the JSON file to compile into a C source file */
+    char *embed;
+
+    /*! name of the VarCreateTable object defined by the C source file */
+    char *symbol;
+
+    /*! name of the snapshot or C source file to write */
+    char *output;
+
+    /*! print load statistics */
+    bool stats;
+
+    /*! create the aliases once all of the variables have been created */
+    bool deferAliases;
+
+    /*! create the critical variables before all of the others */
+    bool priority;
+
+    /*! name of the variable to create once the critical variables
+        exist, or NULL */
+    char *ready;
+
+    /*! handle to the variable server */
+    VARSERVER_HANDLE hVarServer;
+
+    /*! do not print the messages of the library */
+    bool quiet;
+
+    /*! name of the file to write the index of the created variable
+        handles to, or NULL */
+    char *index;
+
+    /*! only check the config files for duplicate names and GUIDs */
+    bool check;
+
+    /*! check the config files for duplicates before creating anything */
+    bool preflight;
+
+    /*! only create the variables and aliases which do not exist yet */
+    bool reconcile;
+
+    /*! number of failures reported by the library */
+    size_t failures;
+
+    /*! the first failures reported by the library */
+    char reports[VARCREATE_MAX_REPORTS][VARCREATE_REPORT_LEN];
+
 } State;
 
 /*==============================================================================
@@ -101,11 +203,17 @@ typedef struct _State
         Private function declarations
 ==============================================================================*/
 static int ProcessOptions( int argc, char *argv[], State *pState );
-static int CreateFromDirectory( State *pState,
-                                VARSERVER_HANDLE hVarServer,
-                                char *dirname,
-                                VarCreateOptions *pOptions );
-static char *CreateFullPath( char *dirname, char *filename );
+static bool IsSnapshot( char *name );
+static void PrintFileStats( const char *filename,
+                            const VarCreateStats *pStats );
+static void PrintStats( const char *label, const VarCreateStats *pStats );
+static void ReadyHandler( void *arg );
+static void ReportHandler( void *arg, const VarCreateResult *pResult );
+static void PrintFailures( const State *pState );
+static int Check( State *pState, VarCreateOptions *options );
+static int ParseInstances( const char *spec, State *pState );
+static void StopHandler( int signum );
+static void SetupStopHandler( void );
 
 /*==============================================================================
         Public function definitions
@@ -134,6 +242,7 @@ int main(int argc, char **argv)
 {
     State state;
     VarCreateOptions options = {0};
+    VarCreateStats stats = {0};
     VARSERVER_HANDLE hVarServer = NULL;
     int rc = 1;
 
@@ -141,27 +250,113 @@ int main(int argc, char **argv)
     {
         options.prefix = state.prefix;
         options.instanceID = state.instanceID;
+        options.instances = state.instances;
+        options.instanceCount = state.instanceCount;
         options.verbose = state.verbose;
+        options.batchSize = state.batchSize;
+        options.stream = state.stream;
+        options.mapFile = state.mapFile;
+        options.workers = state.workers;
+        options.pipeline = state.pipeline;
+        options.pipelineDepth = state.pipelineDepth;
+        options.recursive = state.recursive;
+        options.cache = state.cache;
+        options.deferAliases = state.deferAliases;
+        options.priority = state.priority;
+        options.preflight = state.preflight;
+        options.reconcile = state.reconcile;
+        options.quiet = state.quiet;
+        options.report = ReportHandler;
+        options.reportArg = &state;
+
+        if ( state.index != NULL )
+        {
+            options.index = VARCREATE_IndexCreate();
+        }
+
+        if ( state.ready != NULL )
+        {
+            options.ready = ReadyHandler;
+            options.readyArg = &state;
+        }
+
+        if ( state.stats == true )
+        {
+            options.stats = &stats;
+            options.fileStats = PrintFileStats;
+        }
+        else if ( state.reconcile == true )
+        {
+            /* count the changes for the reconcile summary */
+            options.stats = &stats;
+        }
 
         if ( state.flags != NULL )
         {
             (void)VARSERVER_StrToFlags( state.flags, &options.flags );
         }
 
-        if( state.name != NULL )
+        if ( state.check == true )
+        {
+            /* check the config files without the variable server */
+            rc = Check( &state, &options );
+        }
+        else if ( state.compile != NULL )
+        {
+            /* compile the JSON file into a snapshot.  The variable
+               server is not required */
+            rc = VARCREATE_CompileSnapshot( state.compile,
+                                            state.output,
+                                            &options );
+            if( rc != EOK )
+            {
+                fprintf( stderr,
+                         "varcreate: error compiling snapshot\n" );
+            }
+        }
+        else if ( state.embed != NULL )
+        {
+            /* compile the JSON file into a C table which is built into
+               a program.  The variable server is not required */
+            rc = VARCREATE_CompileTable( state.embed,
+                                         state.output,
+                                         ( state.symbol != NULL )
+                                           ? state.symbol
+                                           : VARCREATE_DEFAULT_SYMBOL,
+                                         &options );
+            if( rc != EOK )
+            {
+                fprintf( stderr,
+                         "varcreate: error compiling table\n" );
+            }
+        }
+        else if( state.name != NULL )
         {
             /* get a handle to the VAR server */
             hVarServer = VARSERVER_Open();
+            state.hVarServer = hVarServer;
             if( hVarServer != NULL )
             {
-                if ( state.directory == true )
+                if ( state.watch == true )
+                {
+                    /* create variables from the config files in the
+                       directory as they are written, until stopped */
+                    SetupStopHandler();
+                    rc = VARCREATE_WatchDirectory( hVarServer,
+                                                   state.name,
+                                                   &options );
+                    if ( rc == EINTR )
+                    {
+                        rc = EOK;
+                    }
+                }
+                else if ( state.directory == true )
                 {
                     /* create variables from all the varcreate JSON files
                        in the directory */
-                    rc = CreateFromDirectory( &state,
-                                              hVarServer,
-                                              state.name,
-                                              &options );
+                    rc = VARCREATE_CreateFromDirectory( hVarServer,
+                                                        state.name,
+                                                        &options );
                 }
                 else
                 {
@@ -170,9 +365,25 @@ int main(int argc, char **argv)
                         printf("VARCREATE: Creating vars: %s\n", state.name);
                     }
 
-                    rc = VARCREATE_CreateFromFile( hVarServer,
-                                                state.name,
-                                                &options );
+                    if ( strcmp( state.name, "-" ) == 0 )
+                    {
+                        /* read newline delimited JSON from stdin */
+                        rc = VARCREATE_CreateFromStream( hVarServer,
+                                                         STDIN_FILENO,
+                                                         &options );
+                    }
+                    else if ( IsSnapshot( state.name ) )
+                    {
+                        rc = VARCREATE_CreateFromSnapshot( hVarServer,
+                                                           state.name,
+                                                           &options );
+                    }
+                    else
+                    {
+                        rc = VARCREATE_CreateFromFile( hVarServer,
+                                                       state.name,
+                                                       &options );
+                    }
                 }
 
                 if( rc != EOK )
@@ -180,10 +391,42 @@ int main(int argc, char **argv)
                     fprintf( stderr,
                              "varcreate: error creating vars\n" );
                 }
+
+                if ( ( state.index != NULL ) &&
+                     ( VARCREATE_IndexWrite( options.index,
+                                             state.index ) != EOK ) )
+                {
+                    fprintf( stderr,
+                             "varcreate: error writing index %s\n",
+                             state.index );
+                    rc = 1;
+                }
             }
 
             VARSERVER_Close( hVarServer );
         }
+
+        if ( state.stats == true )
+        {
+            PrintStats( "total", &stats );
+        }
+        else if ( ( state.reconcile == true ) &&
+                  ( state.quiet == false ) )
+        {
+            printf( "varcreate: created=%zu aliased=%zu unchanged=%zu "
+                    "updated=%zu changed=%zu failed=%zu\n",
+                    stats.created,
+                    stats.aliased,
+                    stats.existing,
+                    stats.updated,
+                    stats.changed,
+                    stats.failed );
+        }
+
+        PrintFailures( &state );
+
+        VARCREATE_IndexDestroy( options.index );
+        free( state.instances );
     }
 
     return rc == 0 ? 0 : 1;
@@ -201,7 +444,9 @@ int main(int argc, char **argv)
 
     -v : enable verbose output
 
-    -i : apply an instance identifier to the variables
+    -i : apply an instance identifier to the variables.  A range such
+         as 0-63, or a comma separated list of identifiers and ranges,
+         creates the variables for every instance from a single parse
 
     -f : apply flags to the variables
 
@@ -209,6 +454,75 @@ int main(int argc, char **argv)
 
     -d : create from multiple files in a directory
 
+    -r : include the files in the subdirectories of the directory
+
+    -w : create from the files in a directory, then keep watching the
+         directory and create from each file as it is written, until
+         interrupted.  Subdirectories included by -r are not watched
+
+    -b : create variables in batches of the specified size
+
+    -S : scan files incrementally, creating each variable as it is read
+
+    -m : map files into memory and parse them in place
+
+    -P : create the variables on a separate thread while the input is
+         being parsed, with up to the specified number of parsed
+         variables waiting to be created ( 0 for the default )
+
+    -j : load the files in a directory using the specified number of
+         worker threads
+
+    -C : record the loaded files in the specified state file, and skip
+         files which are unchanged since they were last loaded
+
+    -a : create the aliases once all of the variables have been created,
+         instead of as soon as each variable has been created
+
+    -s : print the time spent in each phase of the load, and the number
+         of variables created, for each file and in total
+
+    -k : create the variables whose priority is critical from every file
+         before any of the other variables
+
+    -R : create the specified variable once the critical variables have
+         been created, so other processes can wait for it.  Implies -k
+
+    -q : do not print the progress and error messages of the library.
+         A summary of the failures is still printed
+
+    -x : write the names and handles of the created variables and
+         aliases to the specified index file, so clients can find them
+         with VARCREATE_IndexFind
+
+    A file name of - reads newline delimited JSON variable objects from
+    the standard input, creating each variable as soon as its line has
+    been read
+
+    --compile : compile the specified JSON file into the snapshot file
+                specified by -o, instead of creating the variables.
+                Files ending in .vcb are loaded as snapshots
+
+    --embed : compile the specified JSON file into the C source file
+              specified by -o, which defines a VarCreateTable object for
+              VARCREATE_CreateFromTable, instead of creating the variables
+
+    --symbol : name of the VarCreateTable object defined by --embed.
+               Defaults to varcreate_table
+
+    --check : report the duplicate variable names and GUIDs in the
+              file or directory instead of creating the variables.
+              The variable server is not required
+
+    --reconcile : look up each variable and alias before creating it,
+                  and leave the ones which already exist, updating
+                  their flags, so a changed config only creates what it
+                  adds
+
+    --preflight : check the file or directory for duplicate variable
+                  names and GUIDs before creating any variables, and
+                  create nothing if there are any
+
     @param[in]
         argc
             number of arguments on the command line
@@ -230,13 +544,27 @@ static int ProcessOptions( int argc, char *argv[], State *pState )
 {
     int result = EINVAL;
     int c;
+    static const struct option longopts[] =
+    {
+        { "compile", required_argument, NULL, 'c' },
+        { "embed", required_argument, NULL, 'E' },
+        { "symbol", required_argument, NULL, 'Y' },
+        { "check", no_argument, NULL, 'K' },
+        { "preflight", no_argument, NULL, 'F' },
+        { "reconcile", no_argument, NULL, 'U' },
+        { NULL, 0, NULL, 0 }
+    };
 
     /* clear the State object */
     memset( pState, 0, sizeof( State ) );
 
     if( ( argc >= 2 ) && ( pState != NULL ) )
     {
-        while( ( c = getopt( argc, argv, "vp:i:f:d") ) != -1 )
+        while( ( c = getopt_long( argc,
+                                  argv,
+                                  "vp:i:f:drwb:SmP:j:o:C:sakR:qx:",
+                                  longopts,
+                                  NULL ) ) != -1 )
         {
             switch( c )
             {
@@ -245,7 +573,7 @@ static int ProcessOptions( int argc, char *argv[], State *pState )
                     break;
 
                 case 'i':
-                    pState->instanceID = atol( optarg );
+                    pState->instanceSpec = optarg;
                     break;
 
                 case 'p':
@@ -260,6 +588,92 @@ static int ProcessOptions( int argc, char *argv[], State *pState )
                     pState->directory = true;
                     break;
 
+                case 'r':
+                    pState->recursive = true;
+                    break;
+
+                case 'w':
+                    pState->watch = true;
+                    break;
+
+                case 'b':
+                    pState->batchSize = strtoul( optarg, NULL, 0 );
+                    break;
+
+                case 'S':
+                    pState->stream = true;
+                    break;
+
+                case 'm':
+                    pState->mapFile = true;
+                    break;
+
+                case 'P':
+                    pState->pipeline = true;
+                    pState->pipelineDepth = strtoul( optarg, NULL, 0 );
+                    break;
+
+                case 'j':
+                    pState->workers = strtoul( optarg, NULL, 0 );
+                    break;
+
+                case 'C':
+                    pState->cache = optarg;
+                    break;
+
+                case 'c':
+                    pState->compile = optarg;
+                    break;
+
+                case 'E':
+                    pState->embed = optarg;
+                    break;
+
+                case 'Y':
+                    pState->symbol = optarg;
+                    break;
+
+                case 'K':
+                    pState->check = true;
+                    break;
+
+                case 'F':
+                    pState->preflight = true;
+                    break;
+
+                case 'U':
+                    pState->reconcile = true;
+                    break;
+
+                case 'o':
+                    pState->output = optarg;
+                    break;
+
+                case 's':
+                    pState->stats = true;
+                    break;
+
+                case 'a':
+                    pState->deferAliases = true;
+                    break;
+
+                case 'k':
+                    pState->priority = true;
+                    break;
+
+                case 'R':
+                    pState->priority = true;
+                    pState->ready = optarg;
+                    break;
+
+                case 'q':
+                    pState->quiet = true;
+                    break;
+
+                case 'x':
+                    pState->index = optarg;
+                    break;
+
                 default:
                     break;
             }
@@ -268,110 +682,179 @@ static int ProcessOptions( int argc, char *argv[], State *pState )
         /* get the name of the file to load */
         pState->name = argv[argc-1];
 
-        result = EOK;
+        /* a snapshot or table must be compiled to an output file */
+        result = ( ( ( pState->compile == NULL ) &&
+                     ( pState->embed == NULL ) ) ||
+                   ( pState->output != NULL ) ) ? EOK : EINVAL;
+
+        if ( ( result == EOK ) &&
+             ( pState->instanceSpec != NULL ) )
+        {
+            result = ParseInstances( pState->instanceSpec, pState );
+        }
     }
 
     return result;
 }
 
 /*============================================================================*/
-/*  CreateFromDirectory                                                       */
+/*  IsSnapshot                                                                */
 /*!
-    Create varserver variables from varcreate json files in a directory
-
-    The CreateFromDirectory function opens the specified directory and
-    iterates through all the *.json files in it and invokes
-    VARCREATE_CreateFromFile on them.
+    Determine whether a file is a compiled snapshot
 
     @param[in]
-        hVarServer
-            handle to the variable server
+        name
+            name of the file
 
-    @param[in]
-        dirname
-            name of the directory to process
+    @retval true - the file name ends in .vcb
+    @retval false - the file is a JSON config file
 
-    @param[in]
-        pOptions
-            pointer to the VarCreateOptions to apply to each variable
+==============================================================================*/
+static bool IsSnapshot( char *name )
+{
+    size_t len = strlen( name );
+    size_t n = sizeof( VARCREATE_SNAPSHOT_SUFFIX ) - 1;
 
-    @retval EOK - varcreate was successful
-    @retval EINVAL - invalid arguments
+    return ( len > n ) &&
+           ( strcmp( &name[len - n], VARCREATE_SNAPSHOT_SUFFIX ) == 0 );
+}
+
+/*============================================================================*/
+/*  ReadyHandler                                                              */
+/*!
+    Create the ready variable once the critical variables exist
+
+    The ReadyHandler function is called by the library between creating
+    the critical variables and creating the rest of the variables.  The
+    ready variable may already exist from a previous load.
+
+    @param[in]
+        arg
+            pointer to the varcreate state
 
 ==============================================================================*/
-static int CreateFromDirectory( State *pState,
-                                VARSERVER_HANDLE hVarServer,
-                                char *dirname,
-                                VarCreateOptions *pOptions )
+static void ReadyHandler( void *arg )
 {
-    int result = EINVAL;
+    State *pState = (State *)arg;
+    VarInfo info;
     int rc;
-    struct dirent *dp;
-    DIR *dfd;
-    struct stat st;
-    char *pFilename;
-    char *p;
-
-    if ( ( dirname != NULL ) &&
-         ( pOptions != NULL ) &&
-         ( pState != NULL ) )
+
+    memset( &info, 0, sizeof( VarInfo ) );
+    strncpy( info.name, pState->ready, MAX_NAME_LEN );
+    info.var.type = VARTYPE_UINT16;
+    info.var.val.ui = 1;
+
+    rc = VARSERVER_CreateVar( pState->hVarServer, &info );
+    if ( ( rc != EOK ) && ( rc != EEXIST ) )
     {
-        /* assume everything is ok until it is not */
-        result = EOK;
+        fprintf( stderr,
+                 "varcreate: error creating %s\n",
+                 pState->ready );
+    }
+    else if ( pState->verbose )
+    {
+        printf( "VARCREATE: Critical variables ready: %s\n", pState->ready );
+    }
+}
 
-        dfd = opendir(dirname);
-        if ( dfd != NULL )
+/*============================================================================*/
+/*  ParseInstances                                                            */
+/*!
+    Parse the instance identifiers specified with -i
+
+    The ParseInstances function accepts a single instance identifier,
+    which is applied as before, or a comma separated list of
+    identifiers and first-last ranges, which is expanded into the
+    instances array of the state.
+
+    @param[in]
+        spec
+            NUL terminated instance specification
+
+    @param[in,out]
+        pState
+            pointer to the varcreate state
+
+    @retval EOK - the instances were parsed
+    @retval EINVAL - the specification is invalid
+    @retval ENOMEM - memory allocation problem
+
+==============================================================================*/
+static int ParseInstances( const char *spec, State *pState )
+{
+    int result = EOK;
+    unsigned long first;
+    unsigned long last;
+    unsigned long k;
+    const char *p;
+    char *end;
+    size_t count;
+    size_t pass;
+    size_t n = 0;
+
+    if ( strpbrk( spec, ",-" ) == NULL )
+    {
+        pState->instanceID = atol( spec );
+    }
+    else
+    {
+        /* count the identifiers, then store them */
+        for ( pass = 0 ; ( result == EOK ) && ( pass < 2 ) ; pass++ )
         {
-            /* iterate through each entry in the directory */
-            while ( ( dp = readdir(dfd) ) != NULL )
+            count = 0;
+            p = spec;
+            while ( ( result == EOK ) && ( *p != '\0' ) )
             {
-                pFilename = CreateFullPath( dirname, dp->d_name );
-                if ( pFilename == NULL )
+                first = strtoul( p, &end, 0 );
+                last = first;
+                if ( ( end != p ) && ( *end == '-' ) )
                 {
-                    continue;
+                    p = end + 1;
+                    last = strtoul( p, &end, 0 );
                 }
 
-                rc = stat( pFilename, &st );
-                if ( rc == -1 )
+                if ( ( end == p ) ||
+                     ( ( *end != ',' ) && ( *end != '\0' ) ) ||
+                     ( last < first ) ||
+                     ( last > UINT32_MAX ) ||
+                     ( last - first >= VARCREATE_MAX_INSTANCES - count ) )
                 {
-                    fprintf( stderr, "Unable to stat file: %s\n", pFilename );
-                    continue;
+                    result = EINVAL;
                 }
-
-                if ( ( st.st_mode & S_IFMT ) == S_IFDIR )
+                else
                 {
-                    /* skip directories */
-                    continue;
-                }
+                    for ( k = 0 ; k <= last - first ; k++ )
+                    {
+                        if ( pState->instances != NULL )
+                        {
+                            pState->instances[count] = first + k;
+                        }
 
-                p = strstr( dp->d_name, ".json" );
-                if ( ( p == NULL ) || ( p[5] != 0 ) )
-                {
-                    continue;
-                }
+                        count++;
+                    }
 
-                if (pState->verbose )
-                {
-                    printf("VARCREATE: Creating vars: %s\n", pFilename );
+                    p = ( *end == ',' ) ? end + 1 : end;
                 }
+            }
 
-                /* create variables from file */
-                rc = VARCREATE_CreateFromFile( hVarServer,
-                                               pFilename,
-                                               pOptions );
-                if ( rc != EOK )
-                {
-                    fprintf( stderr,
-                             "Failed to create variables from %s\n",
-                             pFilename );
-                    result = rc;
-                }
+            if ( ( result == EOK ) &&
+                 ( pass == 0 ) )
+            {
+                n = count;
+                pState->instances = calloc( n, sizeof( uint32_t ) );
+                result = ( pState->instances != NULL ) ? EOK : ENOMEM;
             }
         }
+
+        if ( result == EOK )
+        {
+            pState->instanceCount = n;
+        }
         else
         {
-            /* directory not found */
-            result = ENOENT;
+            fprintf( stderr, "varcreate: invalid instances: %s\n", spec );
+            free( pState->instances );
+            pState->instances = NULL;
         }
     }
 
@@ -379,63 +862,268 @@ static int CreateFromDirectory( State *pState,
 }
 
 /*============================================================================*/
-/*  CreateFullPath                                                            */
+/*  Check                                                                     */
 /*!
-    Create a full path from directory name and file name
+    Check the config files for duplicate variable names and GUIDs
 
-    The CreateFullPath function concatenates the directory and file name
-    together with a forward slash if appropriate.
-    The full path is stored in static buffer so this function is not intended
-    to be re-entrant, and the returned pointer to the full path should not
-    be persisted.
+    The Check function checks the config file, or every config file in
+    the directory, as a single load.  The duplicates are reported to the
+    ReportHandler and listed in the summary.
 
     @param[in]
-        dirname
-            pointer to the directory name
+        pState
+            pointer to the varcreate state
 
     @param[in]
-        filename
-            pointer to the file name
+        options
+            pointer to the variable creation options
 
-    @retval pointer to the full path name
-    @retval NULL if the total path length is exceeded, or the inputs are invalid
+    @retval EOK - there are no duplicates
+    @retval EEXIST - there are duplicates
+    @retval other - the config files could not be checked
 
 ==============================================================================*/
-static char *CreateFullPath( char *dirname, char *filename )
+static int Check( State *pState, VarCreateOptions *options )
 {
-    char *fullpath = NULL;
-    static char buf[BUFSIZ];
-    size_t buflen = sizeof buf - 1;
-    size_t len;
-    int n;
-
-    buf[buflen] = 0;
+    int result = EINVAL;
+    VarCreateFileList list = {0};
 
-    if ( ( dirname != NULL ) && ( filename != NULL ) )
+    if ( pState->name != NULL )
     {
-        len = strlen( dirname );
-        if ( dirname[len-1] == '/' )
+        if ( pState->directory == true )
         {
-            n = snprintf( buf, buflen, "%s%s", dirname, filename );
+            result = VARCREATE_ScanDirectory( pState->name,
+                                              pState->recursive,
+                                              &list );
+            if ( result == EOK )
+            {
+                result = VARCREATE_CheckFiles( &list, options );
+            }
+
+            VARCREATE_FreeFileList( &list );
         }
         else
         {
-            n = snprintf( buf, buflen, "%s/%s", dirname, filename );
+            list.files = &pState->name;
+            list.count = 1;
+            list.size = 1;
+            result = VARCREATE_CheckFiles( &list, options );
         }
 
-        if ( ( n > 0 ) && ( (size_t)n <= buflen ) )
+        if ( ( result != EOK ) &&
+             ( result != EEXIST ) )
         {
-            fullpath = buf;
+            fprintf( stderr, "varcreate: error checking vars\n" );
         }
-        else
+    }
+
+    return result;
+}
+
+/*============================================================================*/
+/*  ReportHandler                                                             */
+/*!
+    Record a failure reported by the library
+
+    The ReportHandler function counts every failure, and keeps the
+    first VARCREATE_MAX_REPORTS of them for the summary.
+
+    @param[in]
+        arg
+            pointer to the varcreate state
+
+    @param[in]
+        pResult
+            pointer to the failure
+
+==============================================================================*/
+static void ReportHandler( void *arg, const VarCreateResult *pResult )
+{
+    State *pState = (State *)arg;
+
+    if ( ( pState->failures < VARCREATE_MAX_REPORTS ) &&
+         ( pResult->name == NULL ) )
+    {
+        /* the definition could not be parsed */
+        snprintf( pState->reports[pState->failures],
+                  VARCREATE_REPORT_LEN,
+                  "%s:%zu: %s%s%s",
+                  ( pResult->filename != NULL ) ? pResult->filename : "-",
+                  pResult->index,
+                  ( pResult->attribute != NULL ) ? pResult->attribute : "",
+                  ( pResult->attribute != NULL ) ? ": " : "",
+                  strerror( pResult->result ) );
+    }
+    else if ( pState->failures < VARCREATE_MAX_REPORTS )
+    {
+        snprintf( pState->reports[pState->failures],
+                  VARCREATE_REPORT_LEN,
+                  "%s:%zu: %s: %s: %s",
+                  ( pResult->filename != NULL ) ? pResult->filename : "-",
+                  pResult->index,
+                  pResult->name,
+                  ( pResult->attribute != NULL ) ? pResult->attribute
+                                                 : "create",
+                  strerror( pResult->result ) );
+    }
+
+    pState->failures++;
+}
+
+/*============================================================================*/
+/*  SetupStopHandler                                                          */
+/*!
+    Set up the handler which stops watching a directory
+
+    The SIGINT and SIGTERM signals interrupt the wait for directory
+    changes, rather than terminating the process, so the variable
+    server connection is closed and the statistics are printed.
+
+==============================================================================*/
+static void SetupStopHandler( void )
+{
+    struct sigaction sa;
+
+    memset( &sa, 0, sizeof( sa ) );
+    sa.sa_handler = StopHandler;
+
+    /* do not restart the interrupted read */
+    sa.sa_flags = 0;
+    sigemptyset( &sa.sa_mask );
+
+    sigaction( SIGINT, &sa, NULL );
+    sigaction( SIGTERM, &sa, NULL );
+}
+
+/*============================================================================*/
+/*  StopHandler                                                               */
+/*!
+    Signal handler which stops watching a directory
+
+    The handler does nothing itself.  Delivery of the signal interrupts
+    the wait for directory changes.
+
+    @param[in]
+        signum
+            the signal number
+
+==============================================================================*/
+static void StopHandler( int signum )
+{
+    (void)signum;
+}
+
+/*============================================================================*/
+/*  PrintFailures                                                             */
+/*!
+    Print a summary of the failures reported by the library
+
+    The summary is printed to the standard error in a single write.
+    Nothing is printed if there were no failures.
+
+    @param[in]
+        pState
+            pointer to the varcreate state
+
+==============================================================================*/
+static void PrintFailures( const State *pState )
+{
+    char buf[VARCREATE_MAX_REPORTS * ( VARCREATE_REPORT_LEN + 4 ) + 64];
+    size_t len;
+    size_t n;
+    size_t i;
+
+    if ( pState->failures > 0 )
+    {
+        n = ( pState->failures < VARCREATE_MAX_REPORTS )
+                ? pState->failures
+                : VARCREATE_MAX_REPORTS;
+
+        len = snprintf( buf,
+                        sizeof buf,
+                        "varcreate: %zu failures\n",
+                        pState->failures );
+
+        for ( i = 0 ; i < n ; i++ )
+        {
+            len += snprintf( &buf[len],
+                             sizeof buf - len,
+                             "  %s\n",
+                             pState->reports[i] );
+        }
+
+        if ( pState->failures > n )
         {
-            fprintf( stderr, "File name too long: %s\n", filename );
+            len += snprintf( &buf[len],
+                             sizeof buf - len,
+                             "  ... and %zu more\n",
+                             pState->failures - n );
         }
+
+        fputs( buf, stderr );
     }
+}
+
+/*============================================================================*/
+/*  PrintFileStats                                                            */
+/*!
+    Print the load statistics of a single file
+
+    @param[in]
+        filename
+            name of the file which was loaded, or NULL for a string
 
-    return fullpath;
+    @param[in]
+        pStats
+            pointer to the statistics of the file
+
+==============================================================================*/
+static void PrintFileStats( const char *filename,
+                            const VarCreateStats *pStats )
+{
+    PrintStats( ( filename != NULL ) ? filename : "<string>", pStats );
+}
+
+/*============================================================================*/
+/*  PrintStats                                                                */
+/*!
+    Print load statistics
+
+    The statistics are printed on a single line as key=value pairs
+    with the times in microseconds.
+
+    @param[in]
+        label
+            label identifying the statistics
+
+    @param[in]
+        pStats
+            pointer to the statistics to print
+
+==============================================================================*/
+static void PrintStats( const char *label, const VarCreateStats *pStats )
+{
+    printf( "VARCREATE: stats %s: files=%zu skipped=%zu created=%zu "
+            "failed=%zu aliased=%zu existing=%zu updated=%zu changed=%zu "
+            "bytes=%zu read=%.1fus parse=%.1fus handlers=%.1fus "
+            "create=%.1fus alias=%.1fus total=%.1fus\n",
+            label,
+            pStats->files,
+            pStats->skipped,
+            pStats->created,
+            pStats->failed,
+            pStats->aliased,
+            pStats->existing,
+            pStats->updated,
+            pStats->changed,
+            pStats->bytes,
+            pStats->readTime / 1000.0,
+            pStats->parseTime / 1000.0,
+            pStats->handlerTime / 1000.0,
+            pStats->createTime / 1000.0,
+            pStats->aliasTime / 1000.0,
+            pStats->totalTime / 1000.0 );
 }
 
 /*! @}
  * end of varcreate group */
-